@@ -21,9 +21,13 @@
 //
 
 #include "../Application/Application.h"
+#include "../Scene/Systems/TransformSystem.h"
 #include "../Scene/Systems/CameraSystem.h"
+#include "../Scene/Systems/BoundsSystem.h"
 #include "../IO/Path.h"
 #include "../Core/Platform.h"
+#include "../Core/JobSystem.h"
+#include <chrono>
 
 namespace Alimer
 {
@@ -37,7 +41,7 @@ namespace Alimer
         , _settings{}
         , _entities{}
         , _systems(_entities)
-        , _scene(_entities)
+        , _scene(_entities, _transforms, _spatialIndex)
     {
         PlatformConstruct();
         AddSubsystem(this);
@@ -93,6 +97,7 @@ namespace Alimer
         _gpuDevice.Reset();
         Audio::Shutdown();
         PluginManager::Shutdown();
+        JobSystem::Shutdown();
     }
 
     bool Application::InitializeBeforeRun()
@@ -127,7 +132,11 @@ namespace Alimer
         Initialize();
 
         // Setup and configure all systems.
+        _systems.Add<TransformSystem>(_transforms);
         _systems.Add<CameraSystem>();
+        _systems.Add<BoundsSystem>();
+        _systems.AddDependency<CameraSystem, TransformSystem>();
+        _systems.AddDependency<BoundsSystem, TransformSystem>();
 
         ALIMER_LOGINFO("Engine initialized with success.");
         _running = true;
@@ -164,33 +173,117 @@ namespace Alimer
         return _exitCode;
     }
 
+    static double GetClockSeconds()
+    {
+        const auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::duration<double>>(now).count();
+    }
+
     void Application::RunFrame()
     {
+        const double frameStart = GetClockSeconds();
+
+        // Memory of the oldest frame in flight is reused.
+        _frameAllocator.BeginFrame();
+
+        // Run work that other threads handed to the main thread.
+        JobSystem::GetInstance()->RunMainThreadJobs();
+
         if (!_paused)
         {
             // Tick timer.
             double frameTime = _timer.Frame();
             double deltaTime = _timer.GetElapsed();
 
-            // Update all systems.
-            _systems.Update(deltaTime);
-
             // Render single frame if window is not minimzed.
-            if (!_headless 
-                && !_mainWindow->IsMinimized())
+            const bool render = !_headless && !_mainWindow->IsMinimized();
+
+            if (_settings.pipelinedRendering)
+            {
+                // Frame N was extracted last frame, record it while frame N + 1 is simulated.
+                RenderWorld& renderWorld = _renderWorlds[_renderWorldIndex];
+                JobCounter renderCounter;
+                const bool recording = render && renderWorld.IsValid();
+                if (recording)
+                {
+                    // The main thread waits inside the simulation, it must not pick up the recording and serialize the two again.
+                    JobSystem::GetInstance()->ScheduleOnOtherThread([](void* data, uint32_t)
+                    {
+                        Application* application = static_cast<Application*>(data);
+                        application->RenderFrame(application->_renderWorlds[application->_renderWorldIndex]);
+                    }, this, &renderCounter, JobPriority::High);
+                }
+
+                const double simulationStart = GetClockSeconds();
+                _systems.Update(deltaTime);
+                _frameStatistics.simulationTime = GetClockSeconds() - simulationStart;
+
+                // Extract frame N + 1 into the other world while frame N may still be recording.
+                if (render)
+                {
+                    ExtractFrame(_renderWorlds[_renderWorldIndex ^ 1], frameTime, deltaTime, simulationStart);
+                }
+
+                // Help recording until frame N can be presented.
+                JobSystem::GetInstance()->Wait(renderCounter);
+                if (recording)
+                {
+                    PresentFrame(renderWorld);
+                }
+                else
+                {
+                    // Drop a frame extracted before the window got minimized.
+                    renderWorld.Invalidate();
+                }
+
+                if (render)
+                {
+                    _renderWorldIndex ^= 1;
+                }
+            }
+            else
             {
-                RenderFrame(frameTime, deltaTime);
+                const double simulationStart = GetClockSeconds();
+
+                // Update all systems.
+                _systems.Update(deltaTime);
+                _frameStatistics.simulationTime = GetClockSeconds() - simulationStart;
+
+                if (render)
+                {
+                    RenderWorld& renderWorld = _renderWorlds[_renderWorldIndex];
+                    ExtractFrame(renderWorld, frameTime, deltaTime, simulationStart);
+                    RenderFrame(renderWorld);
+                    PresentFrame(renderWorld);
+                }
             }
         }
 
         // Update input, even when paused.
         _input.Update();
+
+        // Deliver events queued during the frame.
+        _eventBus.Dispatch();
+
+        _frameStatistics.frameTime = GetClockSeconds() - frameStart;
     }
 
-    void Application::RenderFrame(double frameTime, double elapsedTime)
+    void Application::ExtractFrame(RenderWorld& world, double frameTime, double elapsedTime, double simulationStart)
     {
-        if (_headless)
-            return;
+        const double extractStart = GetClockSeconds();
+        world.Extract(_entities);
+        world.frameTime = frameTime;
+        world.elapsedTime = elapsedTime;
+        world.simulationStart = simulationStart;
+
+        _frameStatistics.extractTime = GetClockSeconds() - extractStart;
+        _frameStatistics.viewCount = static_cast<uint32_t>(world.GetViews().size());
+        _frameStatistics.objectCount = static_cast<uint32_t>(world.GetObjects().size());
+    }
+
+    void Application::RenderFrame(RenderWorld& world)
+    {
+        const double renderStart = GetClockSeconds();
 
         /*auto context = _graphicsDevice->GetContext();
 
@@ -200,7 +293,9 @@ namespace Alimer
         */
 
         // Call OnRenderFrame for custom rendering frame logic.
-        OnRenderFrame(frameTime, elapsedTime);
+        _renderingWorld = &world;
+        OnRenderFrame(world.frameTime, world.elapsedTime);
+        _renderingWorld = nullptr;
 
         // Render scene to default command buffer.
         /*if (_sceneRenderPipeline)
@@ -212,11 +307,19 @@ namespace Alimer
         // End swap chain render pass.
         context->EndRenderPass();*/
 
+        _frameStatistics.renderTime = GetClockSeconds() - renderStart;
+    }
+
+    void Application::PresentFrame(RenderWorld& world)
+    {
         // Present rendering frame.
         _mainWindow->SwapBuffers();
 
         // Advance to next frame.
         _gpuDevice->Frame();
+
+        _frameStatistics.latency = GetClockSeconds() - world.simulationStart;
+        world.Invalidate();
     }
 
     void Application::OnRenderFrame(double frameTime, double elapsedTime)
@@ -24,6 +24,8 @@
 
 #include "../Core/Object.h"
 #include "../Core/Timer.h"
+#include "../Core/FrameAllocator.h"
+#include "../Core/EventBus.h"
 #include "../Core/Log.h"
 #include "../Core/PluginManager.h"
 #include "../Application/Window.h"
@@ -39,6 +41,7 @@
 #include "../Scene/SceneManager.h"
 #include "../Renderer/RenderContext.h"
 #include "../Renderer/RenderPipeline.h"
+#include "../Renderer/RenderWorld.h"
 #include "../UI/Gui.h"
 #include <atomic>
 
@@ -55,6 +58,27 @@ namespace Alimer
 #endif
 
         RenderWindowDescriptor mainWindowDescriptor{};
+
+        /// Record commands for frame N on a worker while frame N + 1 is simulated, adds one frame of latency.
+        bool pipelinedRendering = false;
+    };
+
+    /// Timings of the last frame in seconds.
+    struct FrameStatistics
+    {
+        /// Time spent updating systems.
+        double simulationTime = 0.0;
+        /// Time spent copying scene state into the render world.
+        double extractTime = 0.0;
+        /// Time spent recording commands, overlaps simulation in pipelined mode.
+        double renderTime = 0.0;
+        /// Time of the whole RunFrame.
+        double frameTime = 0.0;
+        /// Time from the start of the simulation step to the present of its frame.
+        double latency = 0.0;
+        /// Number of cameras and renderables extracted.
+        uint32_t viewCount = 0;
+        uint32_t objectCount = 0;
     };
 
     /// Application for main loop and all modules and OS setup.
@@ -89,6 +113,15 @@ namespace Alimer
 
         Timer &GetFrameTimer() { return _timer; }
 
+        /// Return allocator for memory that lives until the next frames, reset at the start of RunFrame.
+        FrameAllocator& GetFrameAllocator() { return _frameAllocator; }
+
+        /// Return the deferred event queue, dispatched once per frame at the end of RunFrame.
+        EventBus& GetEventBus() { return _eventBus; }
+
+        /// Return timings of the last frame.
+        const FrameStatistics& GetFrameStatistics() const { return _frameStatistics; }
+
         inline ResourceManager& GetResources() { return _resources; }
         inline Window* GetMainWindow() const { return _mainWindow; }
         inline Input& GetInput() { return _input; }
@@ -113,12 +146,22 @@ namespace Alimer
         /// Cleanup after the main loop. 
         virtual void OnExiting() { }
 
-        /// Render after frame update.
-        void RenderFrame(double frameTime, double elapsedTime);
+        /// Copy scene state into the render world that is not being rendered.
+        void ExtractFrame(RenderWorld& world, double frameTime, double elapsedTime, double simulationStart);
+
+        /// Record commands for an extracted world, runs on a worker in pipelined mode.
+        void RenderFrame(RenderWorld& world);
+
+        /// Present the recorded frame and advance the device, always on the main thread.
+        void PresentFrame(RenderWorld& world);
 
-        /// Called during rendering single frame.
+        /// Called during rendering single frame, in pipelined mode from a worker thread.
+        /// Scene state must be read from GetRenderWorld(), simulation may be running meanwhile.
         virtual void OnRenderFrame(double frameTime, double elapsedTime);
 
+        /// Return the world being rendered, valid during OnRenderFrame.
+        const RenderWorld& GetRenderWorld() const { return *_renderingWorld; }
+
         Vector<String> _args;
         /// Application exit code.
         int _exitCode;
@@ -129,12 +172,16 @@ namespace Alimer
 
         std::shared_ptr<spdlog::logger> _logger;
         Timer _timer;
+        FrameAllocator _frameAllocator;
+        EventBus _eventBus;
         ResourceManager _resources;
         SharedPtr<GPUDevice>    _gpuDevice;
         RenderWindow*           _mainWindow = nullptr;
         Input _input;
 
         //
+        TransformHierarchy _transforms;
+        BoundingVolumeHierarchy _spatialIndex;
         EntityManager _entities;
         SystemManager _systems;
         Scene _scene;
@@ -142,6 +189,12 @@ namespace Alimer
         RenderContext _renderContext;
         SceneRenderPipeline* _sceneRenderPipeline = nullptr;
 
+        /// Double buffered render worlds, one is extracted into while the other is rendered.
+        RenderWorld _renderWorlds[2];
+        uint32_t _renderWorldIndex = 0;
+        const RenderWorld* _renderingWorld = nullptr;
+        FrameStatistics _frameStatistics;
+
         // Gui
         SharedPtr<Gui> _gui;
 
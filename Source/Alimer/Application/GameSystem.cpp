@@ -20,17 +20,239 @@
 // THE SOFTWARE.
 //
 
-#include "../Application//GameSystem.h"
+#include "../Application/GameSystem.h"
+#include "../Core/JobSystem.h"
+#include "../Core/Log.h"
+#include <algorithm>
+#include <chrono>
 
 namespace Alimer
 {
     uint32_t GameSystemIDMapping::ids;
 
+    static bool SystemsConflict(const GameSystem* first, const GameSystem* second)
+    {
+        if (first->IsExclusive() || second->IsExclusive())
+            return true;
+
+        return (first->GetWriteMask() & (second->GetReadMask() | second->GetWriteMask())).any()
+            || (second->GetWriteMask() & first->GetReadMask()).any();
+    }
+
+    void SystemManager::AddSystem(uint32_t id, const IntrusivePtr<GameSystem>& system)
+    {
+        for (SystemEntry& entry : _systems)
+        {
+            if (entry.id == id)
+            {
+                entry.system = system;
+                _scheduleDirty = true;
+                return;
+            }
+        }
+
+        _systems.push_back({ id, system, {} });
+        _scheduleDirty = true;
+    }
+
+    void SystemManager::AddDependency(uint32_t id, uint32_t dependencyId)
+    {
+        for (SystemEntry& entry : _systems)
+        {
+            if (entry.id == id)
+            {
+                entry.dependencies.push_back(dependencyId);
+                _scheduleDirty = true;
+                return;
+            }
+        }
+
+        ALIMER_LOGERROR("Cannot add dependency to a system that was not added.");
+    }
+
+    GameSystem* SystemManager::FindSystem(uint32_t id)
+    {
+        for (SystemEntry& entry : _systems)
+        {
+            if (entry.id == id)
+                return entry.system.Get();
+        }
+
+        return nullptr;
+    }
+
+    double SystemManager::GetUpdateTime(uint32_t id) const
+    {
+        for (size_t i = 0; i < _timings.size(); ++i)
+        {
+            if (_systems[_order[i]].id == id)
+                return _timings[i].time;
+        }
+
+        return 0.0;
+    }
+
+    void SystemManager::BuildSchedule()
+    {
+        const uint32_t count = static_cast<uint32_t>(_systems.size());
+
+        // Resolve explicit dependencies to registration indices.
+        std::vector<std::vector<uint32_t>> predecessors(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            for (uint32_t dependencyId : _systems[i].dependencies)
+            {
+                for (uint32_t j = 0; j < count; ++j)
+                {
+                    if (_systems[j].id == dependencyId && j != i)
+                    {
+                        predecessors[i].push_back(j);
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Topological order of explicit dependencies, ties resolved by registration order so the result is deterministic.
+        std::vector<uint32_t> order;
+        std::vector<bool> scheduled(count, false);
+        order.reserve(count);
+        while (order.size() < count)
+        {
+            uint32_t next = count;
+            for (uint32_t i = 0; i < count && next == count; ++i)
+            {
+                if (scheduled[i])
+                    continue;
+
+                bool ready = true;
+                for (uint32_t predecessor : predecessors[i])
+                {
+                    ready &= scheduled[predecessor];
+                }
+
+                if (ready)
+                    next = i;
+            }
+
+            if (next == count)
+            {
+                ALIMER_LOGERROR("Cyclic game system dependencies, falling back to registration order.");
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    if (!scheduled[i])
+                    {
+                        scheduled[i] = true;
+                        order.push_back(i);
+                    }
+                }
+                break;
+            }
+
+            scheduled[next] = true;
+            order.push_back(next);
+        }
+
+        // Systems run after every earlier system they depend on or conflict with, group them in stages.
+        std::vector<uint32_t> position(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            position[order[i]] = i;
+        }
+
+        std::vector<uint32_t> stages(count, 0);
+        uint32_t stageCount = count > 0 ? 1 : 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t current = order[i];
+            for (uint32_t j = 0; j < i; ++j)
+            {
+                const uint32_t earlier = order[j];
+                const bool dependent = std::find(predecessors[current].begin(), predecessors[current].end(), earlier) != predecessors[current].end();
+                if (dependent || SystemsConflict(_systems[earlier].system.Get(), _systems[current].system.Get()))
+                {
+                    stages[current] = std::max(stages[current], stages[earlier] + 1);
+                }
+            }
+
+            stageCount = std::max(stageCount, stages[current] + 1);
+        }
+
+        _order = order;
+        std::stable_sort(_order.begin(), _order.end(), [&](uint32_t lhs, uint32_t rhs)
+        {
+            return stages[lhs] < stages[rhs];
+        });
+
+        _stageOffsets.assign(stageCount + 1, 0);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            _stageOffsets[stages[i] + 1]++;
+        }
+        for (uint32_t stage = 0; stage < stageCount; ++stage)
+        {
+            _stageOffsets[stage + 1] += _stageOffsets[stage];
+        }
+
+        _timings.resize(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            _timings[i] = { _systems[_order[i]].system.Get(), 0.0 };
+        }
+
+        _scheduleDirty = false;
+    }
+
     void SystemManager::Update(double deltaTime)
     {
-        for (auto &pair : _systems)
+        if (_scheduleDirty)
+        {
+            BuildSchedule();
+        }
+
+        auto updateSystem = [this, deltaTime](uint32_t index)
+        {
+            GameSystem* system = _systems[_order[index]].system.Get();
+            system->_lastUpdateVersion = system->_updateVersion;
+            system->_updateVersion = _entities.GetChangeVersion();
+
+            auto start = std::chrono::steady_clock::now();
+            system->Update(_entities, deltaTime);
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            _timings[index].time = std::chrono::duration<double>(elapsed).count();
+        };
+
+        for (size_t stage = 0; stage + 1 < _stageOffsets.size(); ++stage)
+        {
+            // Changes made by earlier stages are newer than the version seen by the systems that made them.
+            _entities.IncrementChangeVersion();
+
+            const uint32_t begin = _stageOffsets[stage];
+            const uint32_t end = _stageOffsets[stage + 1];
+            if (end - begin == 1)
+            {
+                updateSystem(begin);
+                continue;
+            }
+
+            JobSystem::GetInstance()->ParallelFor(end - begin, 1, [&](uint32_t first, uint32_t last)
+            {
+                for (uint32_t i = first; i < last; ++i)
+                {
+                    updateSystem(begin + i);
+                }
+            });
+        }
+
+        // Changes made outside of systems are seen on the next update.
+        _entities.IncrementChangeVersion();
+
+        // Every system has seen removals up to its update version.
+        uint32_t trimVersion = _entities.GetChangeVersion();
+        for (const SystemEntry& entry : _systems)
         {
-            pair.second->Update(_entities, deltaTime);
+            trimVersion = std::min(trimVersion, entry.system->_updateVersion);
         }
+        _entities.TrimRemoved(trimVersion);
     }
 }
@@ -25,6 +25,7 @@
 #include  "AlimerConfig.h"
 #include  "../Scene/Entity.h"
 #include  <unordered_map>
+#include  <vector>
 
 namespace Alimer
 {
@@ -54,11 +55,70 @@ namespace Alimer
 
         /// Updates the system
         virtual void Update(EntityManager &entities, double deltaTime) = 0;
+
+        /// Get the component types read by the system.
+        const ComponentMask& GetReadMask() const { return _readMask; }
+
+        /// Get the component types written by the system.
+        const ComponentMask& GetWriteMask() const { return _writeMask; }
+
+        /// Return whether the system must not run at the same time as any other system.
+        bool IsExclusive() const { return _exclusive; }
+
+        /// Get the entity change version of the previous update, pass it as since to Changed<T> and Added<T> queries.
+        uint32_t GetLastUpdateVersion() const { return _lastUpdateVersion; }
+
+    protected:
+        /// Declare component types read by the system, allows it to run alongside other readers.
+        template <typename... Components>
+        void Reads()
+        {
+            _readMask |= MakeMask<Components...>();
+            _exclusive = false;
+        }
+
+        /// Declare component types written by the system.
+        template <typename... Components>
+        void Writes()
+        {
+            _writeMask |= MakeMask<Components...>();
+            _exclusive = false;
+        }
+
+        /// Mark the system as exclusive, required when creating or destroying entities or touching shared state.
+        void SetExclusive(bool exclusive) { _exclusive = exclusive; }
+
+    private:
+        friend class SystemManager;
+
+        template <typename... Components>
+        static ComponentMask MakeMask()
+        {
+            ComponentMask mask;
+            int dummy[] = { 0, (mask.set(ComponentIDMapping::GetId<Components>()), 0)... };
+            (void)dummy;
+            return mask;
+        }
+
+        ComponentMask _readMask;
+        ComponentMask _writeMask;
+        // Systems that do not declare their accesses are conservatively run alone.
+        bool _exclusive = true;
+        uint32_t _lastUpdateVersion = 0;
+        uint32_t _updateVersion = 0;
     };
 
+    /// Runs game systems each frame, systems whose component accesses do not conflict are updated in parallel.
     class ALIMER_API SystemManager final
     {
     public:
+        /// Update time of a system during the last frame.
+        struct Timing
+        {
+            GameSystem* system;
+            double time;
+        };
+
         SystemManager(EntityManager& entities)
             : _entities(entities)
         {
@@ -71,7 +131,7 @@ namespace Alimer
         template <typename S>
         void Add(const IntrusivePtr<S> system)
         {
-            _systems.insert(std::make_pair(GameSystemIDMapping::GetId<S>(), system));
+            AddSystem(GameSystemIDMapping::GetId<S>(), system);
         }
 
         /// Creates and add new System.
@@ -86,19 +146,58 @@ namespace Alimer
         template <typename S>
         IntrusivePtr<S> GetSystem()
         {
-            auto it = _systems.find(GameSystemIDMapping::GetId<S>());
-            assert(it != _systems.end());
-            return it == _systems.end()
-                ? IntrusivePtr<S>()
-                : IntrusivePtr<S>(std::static_pointer_cast<S>(it->second));
+            GameSystem* system = FindSystem(GameSystemIDMapping::GetId<S>());
+            ALIMER_ASSERT(system);
+            if (!system)
+                return IntrusivePtr<S>();
+
+            system->AddReference();
+            return IntrusivePtr<S>(static_cast<S*>(system));
+        }
+
+        /// Require system S to update after system Dependency.
+        template <typename S, typename Dependency>
+        void AddDependency()
+        {
+            AddDependency(GameSystemIDMapping::GetId<S>(), GameSystemIDMapping::GetId<Dependency>());
         }
 
+        /// Get the update time in seconds of system S during the last frame.
+        template <typename S>
+        double GetUpdateTime() const
+        {
+            return GetUpdateTime(GameSystemIDMapping::GetId<S>());
+        }
+
+        /// Get the update time of all systems during the last frame, in execution order.
+        const std::vector<Timing>& GetTimings() const { return _timings; }
+
         /// Update all systems.
         void Update(double deltaTime);
 
     private:
+        struct SystemEntry
+        {
+            uint32_t id;
+            IntrusivePtr<GameSystem> system;
+            // Ids of systems that must update before this one.
+            std::vector<uint32_t> dependencies;
+        };
+
+        void AddSystem(uint32_t id, const IntrusivePtr<GameSystem>& system);
+        void AddDependency(uint32_t id, uint32_t dependencyId);
+        GameSystem* FindSystem(uint32_t id);
+        double GetUpdateTime(uint32_t id) const;
+        void BuildSchedule();
+
         EntityManager& _entities;
-        std::unordered_map<uint32_t, IntrusivePtr<GameSystem>> _systems;
+        /// Systems in registration order.
+        std::vector<SystemEntry> _systems;
+        /// Execution order grouped by stage, systems within a stage do not conflict.
+        std::vector<uint32_t> _order;
+        std::vector<uint32_t> _stageOffsets;
+        std::vector<Timing> _timings;
+        bool _scheduleDirty = true;
 
         DISALLOW_COPY_MOVE_AND_ASSIGN(SystemManager);
     };
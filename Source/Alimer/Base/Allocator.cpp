@@ -0,0 +1,222 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Base/Allocator.h"
+#include "../Debug/Debug.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace Alimer
+{
+    constexpr size_t Allocator::DefaultAlignment;
+
+    void* Allocator::Reallocate(void* ptr, size_t oldSize, size_t newSize, size_t alignment)
+    {
+        void* newPtr = newSize ? Allocate(newSize, alignment) : nullptr;
+        if (ptr)
+        {
+            if (newPtr)
+            {
+                memcpy(newPtr, ptr, std::min(oldSize, newSize));
+            }
+
+            Free(ptr, oldSize);
+        }
+
+        return newPtr;
+    }
+
+    /// Header at the start of each block.
+    struct ArenaAllocator::Block
+    {
+        Block* previous;
+        size_t size;
+    };
+
+    ArenaAllocator::ArenaAllocator(size_t blockSize)
+        : _blockSize(blockSize)
+    {
+    }
+
+    ArenaAllocator::~ArenaAllocator()
+    {
+        while (_block)
+        {
+            Block* previous = _block->previous;
+            free(_block);
+            _block = previous;
+        }
+    }
+
+    void* ArenaAllocator::Allocate(size_t size, size_t alignment)
+    {
+        ALIMER_ASSERT((alignment & (alignment - 1)) == 0);
+
+        uint8_t* result = reinterpret_cast<uint8_t*>((reinterpret_cast<uintptr_t>(_top) + alignment - 1) & ~(alignment - 1));
+        if (_top == nullptr || result + size > _end)
+        {
+            AddBlock(size, alignment);
+            result = reinterpret_cast<uint8_t*>((reinterpret_cast<uintptr_t>(_top) + alignment - 1) & ~(alignment - 1));
+        }
+
+        _last = result;
+        _top = result + size;
+        return result;
+    }
+
+    void* ArenaAllocator::Reallocate(void* ptr, size_t oldSize, size_t newSize, size_t alignment)
+    {
+        if (ptr != nullptr && ptr == _last && _last + newSize <= _end)
+        {
+            _top = _last + newSize;
+            return ptr;
+        }
+
+        // Old allocation stays in the arena until reset.
+        void* newPtr = newSize ? Allocate(newSize, alignment) : nullptr;
+        if (ptr && newPtr)
+        {
+            memcpy(newPtr, ptr, std::min(oldSize, newSize));
+        }
+
+        return newPtr;
+    }
+
+    void ArenaAllocator::Free(void* ptr, size_t size)
+    {
+        ALIMER_UNUSED(size);
+        if (ptr != nullptr && ptr == _last)
+        {
+            _top = _last;
+            _last = nullptr;
+        }
+    }
+
+    void ArenaAllocator::Reset()
+    {
+        if (_block == nullptr)
+        {
+            return;
+        }
+
+        while (_block->previous)
+        {
+            Block* previous = _block->previous;
+            _block->previous = previous->previous;
+            _capacity -= previous->size;
+            free(previous);
+        }
+
+        _top = _begin;
+        _last = nullptr;
+        _usedSize = 0;
+    }
+
+    void ArenaAllocator::Rewind(const Marker& marker)
+    {
+        while (_block != marker.block && _block->previous != nullptr)
+        {
+            Block* previous = _block->previous;
+            _capacity -= _block->size;
+            free(_block);
+            _block = previous;
+        }
+
+        if (_block == nullptr)
+        {
+            return;
+        }
+
+        _begin = reinterpret_cast<uint8_t*>(_block + 1);
+        _end = reinterpret_cast<uint8_t*>(_block) + _block->size;
+        _top = _block == marker.block ? marker.top : _begin;
+        _last = nullptr;
+        _usedSize = _block == marker.block ? marker.usedSize : 0;
+    }
+
+    void ArenaAllocator::AddBlock(size_t size, size_t alignment)
+    {
+        const size_t blockSize = std::max(_blockSize, sizeof(Block) + size + alignment);
+        Block* block = static_cast<Block*>(malloc(blockSize));
+        ALIMER_ASSERT_MSG(block != nullptr, "Arena out of memory, %u bytes requested", static_cast<uint32_t>(blockSize));
+        block->previous = _block;
+        block->size = blockSize;
+
+        if (_block)
+        {
+            _usedSize += static_cast<size_t>(_top - _begin);
+        }
+
+        _block = block;
+        _begin = reinterpret_cast<uint8_t*>(block + 1);
+        _top = _begin;
+        _end = reinterpret_cast<uint8_t*>(block) + blockSize;
+        _capacity += blockSize;
+    }
+
+    void* AllocateMemory(Allocator* allocator, size_t size, size_t alignment)
+    {
+        if (allocator)
+        {
+            return allocator->Allocate(size, alignment);
+        }
+
+        // The heap only guarantees the default alignment.
+        ALIMER_ASSERT(alignment <= Allocator::DefaultAlignment);
+        return malloc(size);
+    }
+
+    void* ReallocateMemory(Allocator* allocator, void* ptr, size_t oldSize, size_t newSize, size_t alignment)
+    {
+        if (allocator)
+        {
+            return allocator->Reallocate(ptr, oldSize, newSize, alignment);
+        }
+
+        ALIMER_ASSERT(alignment <= Allocator::DefaultAlignment);
+        if (newSize == 0)
+        {
+            free(ptr);
+            return nullptr;
+        }
+
+        return realloc(ptr, newSize);
+    }
+
+    void FreeMemory(Allocator* allocator, void* ptr, size_t size)
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+
+        if (allocator)
+        {
+            allocator->Free(ptr, size);
+        }
+        else
+        {
+            free(ptr);
+        }
+    }
+}
@@ -0,0 +1,132 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "AlimerConfig.h"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace Alimer
+{
+    /// Memory allocator interface for containers. Containers with a null allocator use the heap directly.
+    class ALIMER_API Allocator
+    {
+    public:
+        /// Alignment of heap allocations, enough for SIMD types.
+        static constexpr size_t DefaultAlignment = 16;
+
+        /// Destruct.
+        virtual ~Allocator() = default;
+
+        /// Allocate size bytes aligned to alignment, which is a power of two.
+        virtual void* Allocate(size_t size, size_t alignment) = 0;
+        /// Resize an allocation, in place if possible. Contents up to the smaller size are kept.
+        virtual void* Reallocate(void* ptr, size_t oldSize, size_t newSize, size_t alignment);
+        /// Free an allocation of size bytes.
+        virtual void Free(void* ptr, size_t size) = 0;
+
+        /// Allocate uninitialized storage for count values of type T.
+        template <typename T>
+        T* AllocateArray(size_t count)
+        {
+            return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+        }
+    };
+
+    /// Allocator handing out memory from large blocks. Free only releases the latest allocation, Reset releases everything at once.
+    /// Not thread safe.
+    class ALIMER_API ArenaAllocator final : public Allocator
+    {
+        struct Block;
+
+    public:
+        /// Allocation position to rewind to.
+        struct Marker
+        {
+            Block* block;
+            uint8_t* top;
+            size_t usedSize;
+        };
+
+        /// Construct with the size of the blocks, larger allocations get their own block.
+        explicit ArenaAllocator(size_t blockSize = 64 * 1024);
+
+        /// Destruct, releasing all blocks.
+        ~ArenaAllocator() override;
+
+        void* Allocate(size_t size, size_t alignment) override;
+        /// Grows or shrinks the latest allocation in place when it fits in the current block.
+        void* Reallocate(void* ptr, size_t oldSize, size_t newSize, size_t alignment) override;
+        void Free(void* ptr, size_t size) override;
+
+        /// Release all allocations. The newest block is kept for reuse.
+        void Reset();
+
+        /// Return the current position.
+        Marker GetMarker() const { return { _block, _top, _usedSize }; }
+
+        /// Release allocations made after the marker was taken. Blocks added since then are freed, except the oldest one.
+        void Rewind(const Marker& marker);
+
+        /// Return bytes allocated since the last reset, including alignment padding.
+        size_t GetUsedSize() const { return _usedSize + static_cast<size_t>(_top - _begin); }
+
+        /// Return bytes held in blocks.
+        size_t GetCapacity() const { return _capacity; }
+
+    private:
+        void AddBlock(size_t size, size_t alignment);
+
+        /// Size of new blocks.
+        size_t _blockSize;
+        /// Newest block, older ones are linked from it.
+        Block* _block = nullptr;
+        /// Free range of the newest block.
+        uint8_t* _begin = nullptr;
+        uint8_t* _top = nullptr;
+        uint8_t* _end = nullptr;
+        /// Start of the latest allocation, it can be resized or freed in place.
+        uint8_t* _last = nullptr;
+        /// Bytes used in older blocks.
+        size_t _usedSize = 0;
+        size_t _capacity = 0;
+
+    private:
+        DISALLOW_COPY_MOVE_AND_ASSIGN(ArenaAllocator);
+    };
+
+    /// Allocate from allocator, or from the heap if null.
+    ALIMER_API void* AllocateMemory(Allocator* allocator, size_t size, size_t alignment = Allocator::DefaultAlignment);
+    /// Resize an allocation made with AllocateMemory. The heap uses realloc, which often grows in place.
+    ALIMER_API void* ReallocateMemory(Allocator* allocator, void* ptr, size_t oldSize, size_t newSize, size_t alignment = Allocator::DefaultAlignment);
+    /// Free an allocation made with AllocateMemory. Null is ignored.
+    ALIMER_API void FreeMemory(Allocator* allocator, void* ptr, size_t size);
+
+    /// Whether a value can be moved to another address with memcpy, leaving the source to be forgotten without destruction.
+    /// True for trivially copyable types, specialize for types that do not point into themselves, such as containers and smart pointers.
+    template <typename T>
+    struct IsRelocatable : std::integral_constant<bool, std::is_trivially_copyable<T>::value>
+    {
+    };
+}
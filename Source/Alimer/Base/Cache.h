@@ -24,48 +24,309 @@
 
 #include "../Base/HashMap.h"
 #include "../Base/Ptr.h"
+#include <condition_variable>
+#include <mutex>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace Alimer
 {
-    template <typename T>
+    /// Cache usage counters.
+    struct CacheStatistics
+    {
+        /// Lookups that found a ready entry.
+        uint64_t hits = 0;
+        /// Lookups that found nothing, GetOrCreate calls the factory for these.
+        uint64_t misses = 0;
+        /// Entries evicted to stay within the budget.
+        uint64_t evictions = 0;
+        /// Number of cached entries.
+        uint64_t count = 0;
+        /// Summed cost of cached entries.
+        uint64_t cost = 0;
+    };
+
+    /// Thread safe cache of objects by hash, split into shards with their own lock and second chance (CLOCK) eviction.
+    /// Evicted objects are kept alive until ReleaseEvicted, so pointers returned earlier stay valid until then.
+    template <typename T, uint32_t ShardCount = 16>
     class Cache
     {
+        static_assert(ShardCount > 0 && (ShardCount & (ShardCount - 1)) == 0, "Shard count must be a power of two");
+
     public:
+        Cache() = default;
+
+        ~Cache()
+        {
+            for (Shard& shard : _shards)
+            {
+                ALIMER_ASSERT_MSG(shard.pending == 0, "Cache destroyed while %u entries are being created", shard.pending);
+            }
+        }
+
+        /// Set the maximum summed cost of cached entries, spread evenly over the shards. Default is unlimited.
+        void SetBudget(uint64_t budget)
+        {
+            const uint64_t shardBudget = budget / ShardCount + (budget % ShardCount != 0 ? 1 : 0);
+            for (Shard& shard : _shards)
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                shard.budget = shardBudget;
+                Evict(shard, nullptr);
+            }
+        }
+
+        /// Destroy all ready entries, including evicted ones. Entries being created by GetOrCreate are kept.
         void Clear()
         {
-            _hashMap.clear();
+            for (Shard& shard : _shards)
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                for (auto it = shard.entries.begin(); it != shard.entries.end();)
+                {
+                    if (it->second->pending)
+                    {
+                        ++it;
+                        continue;
+                    }
+
+                    Unlink(shard, it->second.Get());
+                    it = shard.entries.erase(it);
+                }
+
+                shard.retired.clear();
+            }
         }
 
-        T* Find(uint64_t hash) const
+        /// Destroy objects evicted since the last call. Call when no thread can still use pointers returned before eviction, such as at frame begin.
+        void ReleaseEvicted()
         {
-            auto itr = _hashMap.find(hash);
-            auto *ret = itr != end(_hashMap) ? itr->second.Get() : nullptr;
-            return ret;
+            for (Shard& shard : _shards)
+            {
+                std::vector<UniquePtr<T>> retired;
+                {
+                    std::lock_guard<std::mutex> lock(shard.mutex);
+                    retired.swap(shard.retired);
+                }
+            }
         }
 
-        T* Insert(uint64_t hash, UniquePtr<T> value)
+        /// Return the cached object or null. Does not wait for an object being created on another thread.
+        T* Find(uint64_t hash)
         {
-            auto &cache = _hashMap[hash];
-            if (!cache)
-                cache = std::move(value);
+            Shard& shard = GetShard(hash);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.entries.find(hash);
+            if (it == shard.entries.end() || it->second->pending)
+            {
+                shard.misses++;
+                return nullptr;
+            }
 
-            auto *ret = cache.Get();
-            return ret;
+            shard.hits++;
+            Touch(it->second.Get());
+            return it->second->value.Get();
         }
 
-        HashMap<UniquePtr<T>>& GetMap()
+        /// Insert object unless one exists already, then the new one is destroyed. Return the cached object.
+        T* Insert(uint64_t hash, UniquePtr<T> value, uint64_t cost = 1)
         {
-            return _hashMap;
+            return GetOrCreate(hash, [&value]() { return std::move(value); }, cost);
         }
 
-        const HashMap<UniquePtr<T>> &GetMap() const
+        /// Return the cached object or create it with the factory, which returns UniquePtr<T>.
+        /// When several threads race on the same hash the factory runs once and the others wait for its result.
+        /// The factory is called without holding a lock and a null result is not cached.
+        template <typename Factory>
+        T* GetOrCreate(uint64_t hash, Factory&& factory, uint64_t cost = 1)
         {
-            return _hashMap;
+            Shard& shard = GetShard(hash);
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            for (;;)
+            {
+                auto it = shard.entries.find(hash);
+                if (it == shard.entries.end())
+                {
+                    break;
+                }
+
+                Entry* entry = it->second.Get();
+                if (!entry->pending)
+                {
+                    shard.hits++;
+                    Touch(entry);
+                    return entry->value.Get();
+                }
+
+                shard.ready.wait(lock);
+            }
+
+            shard.misses++;
+            shard.pending++;
+            Entry* entry = new Entry();
+            entry->hash = hash;
+            entry->pending = true;
+            shard.entries.try_emplace(hash, entry);
+            lock.unlock();
+
+            UniquePtr<T> value = factory();
+
+            lock.lock();
+            shard.pending--;
+            T* result = value.Get();
+            if (result == nullptr)
+            {
+                shard.entries.erase(hash);
+            }
+            else
+            {
+                entry->value = std::move(value);
+                entry->cost = cost;
+                entry->pending = false;
+                Link(shard, entry);
+                Evict(shard, entry);
+            }
+
+            lock.unlock();
+            shard.ready.notify_all();
+            return result;
         }
 
+        /// Return counters summed over all shards.
+        CacheStatistics GetStatistics() const
+        {
+            CacheStatistics result;
+            for (const Shard& shard : _shards)
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                result.hits += shard.hits;
+                result.misses += shard.misses;
+                result.evictions += shard.evictions;
+                result.count += shard.entries.size() - shard.pending;
+                result.cost += shard.cost;
+            }
+
+            return result;
+        }
+
+    private:
+        /// Cached object, ready entries are linked most recently inserted or spared first.
+        struct Entry
+        {
+            UniquePtr<T> value;
+            uint64_t hash = 0;
+            uint64_t cost = 0;
+            Entry* previous = nullptr;
+            Entry* next = nullptr;
+            /// Used since it was linked at the head.
+            bool referenced = false;
+            /// Being created by GetOrCreate, not linked and never evicted.
+            bool pending = false;
+        };
+
+        struct Shard
+        {
+            mutable std::mutex mutex;
+            std::condition_variable ready;
+            HashMap<UniquePtr<Entry>> entries;
+            /// Newest and oldest ready entries.
+            Entry* head = nullptr;
+            Entry* tail = nullptr;
+            /// Evicted objects waiting for ReleaseEvicted.
+            std::vector<UniquePtr<T>> retired;
+            uint64_t budget = ~0ull;
+            uint64_t cost = 0;
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t evictions = 0;
+            uint32_t pending = 0;
+        };
+
+        Shard& GetShard(uint64_t hash)
+        {
+            // The top bits, HashMap probes with the low bits of the same mix.
+            return _shards[(HashMapHasher::Mix(hash) >> 32) & (ShardCount - 1)];
+        }
+
+        static void Link(Shard& shard, Entry* entry)
+        {
+            entry->previous = nullptr;
+            entry->next = shard.head;
+            if (shard.head)
+            {
+                shard.head->previous = entry;
+            }
+            else
+            {
+                shard.tail = entry;
+            }
+
+            shard.head = entry;
+            shard.cost += entry->cost;
+        }
+
+        static void Unlink(Shard& shard, Entry* entry)
+        {
+            if (entry->previous)
+            {
+                entry->previous->next = entry->next;
+            }
+            else
+            {
+                shard.head = entry->next;
+            }
+
+            if (entry->next)
+            {
+                entry->next->previous = entry->previous;
+            }
+            else
+            {
+                shard.tail = entry->previous;
+            }
+
+            shard.cost -= entry->cost;
+        }
+
+        static void Touch(Entry* entry)
+        {
+            // Skip the store when already set, hits then leave the entry cache line clean.
+            if (!entry->referenced)
+            {
+                entry->referenced = true;
+            }
+        }
+
+        /// Evict from the tail until the shard fits its budget, keep the entry just added.
+        /// Entries used since they were linked get a second chance at the head, which approximates LRU without relinking on every hit.
+        static void Evict(Shard& shard, Entry* keep)
+        {
+            while (shard.cost > shard.budget && shard.tail != nullptr)
+            {
+                Entry* entry = shard.tail;
+                if (entry == keep && entry == shard.head)
+                {
+                    break;
+                }
+
+                Unlink(shard, entry);
+                if (entry == keep || entry->referenced)
+                {
+                    entry->referenced = false;
+                    Link(shard, entry);
+                    continue;
+                }
+
+                shard.retired.push_back(std::move(entry->value));
+                shard.evictions++;
+                shard.entries.erase(entry->hash);
+            }
+        }
+
+        Shard _shards[ShardCount];
+
     private:
-        HashMap<UniquePtr<T>> _hashMap;
+        DISALLOW_COPY_MOVE_AND_ASSIGN(Cache);
     };
 }
@@ -96,13 +96,13 @@ namespace Alimer
 
         ValueType& operator[](IndexType index)
         {
-            ALIMER_ASSERT_MSG(index >= 0 && index < size(), "Index out of bounds. (%u, size %u)", index, size());
+            ALIMER_ASSERT_MSG(index < size(), "Index out of bounds. (%u, size %u)", index, size());
             return _begin[index];
         }
 
         const ValueType& operator[](IndexType index) const
         {
-            ALIMER_ASSERT_MSG(index >= 0 && index < size(), "Index out of bounds. (%u, size %u)", index, size());
+            ALIMER_ASSERT_MSG(index < size(), "Index out of bounds. (%u, size %u)", index, size());
             return _begin[index];
         }
 
@@ -131,7 +131,7 @@ namespace Alimer
             }
         }
 
-        inline constexpr T const& operator[](size_t i) const
+        inline constexpr T const& operator[](size_t index) const
         {
             ALIMER_ASSERT_MSG(index >= 0 && index < N, "Index out of bounds. (%u, size %u)", index, N);
             return _data[index];
@@ -143,7 +143,7 @@ namespace Alimer
             return _data[index];
         }
 
-        inline constexpr T const& at(size_t i) const
+        inline constexpr T const& at(size_t index) const
         {
             ALIMER_ASSERT_MSG(index >= 0 && index < N, "Index out of bounds. (%u, size %u)", index, N);
             return _data[index];
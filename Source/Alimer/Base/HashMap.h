@@ -23,8 +23,17 @@
 #pragma once
 
 #include "../Base/String.h"
+#include "../Math/MathUtil.h"
+#include <initializer_list>
+#include <iterator>
 #include <memory>
-#include <unordered_map>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#if ALIMER_SSE2
+#   include <emmintrin.h>
+#endif
 
 namespace Alimer
 {
@@ -34,30 +43,681 @@ namespace Alimer
         {
             return hash;
         }
+
+        /// Return key of integer and enum types.
+        template <typename K, typename std::enable_if<std::is_integral<K>::value || std::is_enum<K>::value, int>::type = 0>
+        static uint64_t GetKey(K key)
+        {
+            return static_cast<uint64_t>(key);
+        }
+
+        /// Return key of types providing ToHash, such as StringHash.
+        template <typename K, typename std::enable_if<!std::is_integral<K>::value && !std::is_enum<K>::value, int>::type = 0>
+        static uint64_t GetKey(const K& key)
+        {
+            return static_cast<uint64_t>(key.ToHash());
+        }
+
+        /// Spread key bits, pre-hashed keys such as type ids or pointers often differ only in a few bits.
+        static uint64_t Mix(uint64_t key)
+        {
+            const uint64_t product = key * 0x9e3779b97f4a7c15ull;
+            return product ^ (product >> 32);
+        }
     };
 
+    namespace Internal
+    {
+        /// Control byte of a slot, full slots store the low 7 bits of the mixed key.
+        enum HashMapControl : int8_t
+        {
+            HashMapEmpty = -128,
+            HashMapDeleted = -2,
+            HashMapSentinel = -1
+        };
+
+        static const uint32_t HashMapGroupWidth = 16;
+
+        /// Control bytes of an empty map, iteration stops at the sentinel.
+        inline const int8_t* GetHashMapEmptyGroup()
+        {
+            alignas(16) static const int8_t group[HashMapGroupWidth] = {
+                HashMapSentinel, HashMapEmpty, HashMapEmpty, HashMapEmpty, HashMapEmpty, HashMapEmpty, HashMapEmpty, HashMapEmpty,
+                HashMapEmpty, HashMapEmpty, HashMapEmpty, HashMapEmpty, HashMapEmpty, HashMapEmpty, HashMapEmpty, HashMapEmpty
+            };
+            return group;
+        }
+
+        /// Group of control bytes matched at once, each result bit is one slot.
+        class HashMapGroup
+        {
+        public:
+            explicit HashMapGroup(const int8_t* control)
+            {
+#if ALIMER_SSE2
+                _control = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+#else
+                memcpy(_control, control, HashMapGroupWidth);
+#endif
+            }
+
+            uint32_t Match(int8_t value) const
+            {
+#if ALIMER_SSE2
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(value), _control)));
+#else
+                uint32_t bits = 0;
+                for (uint32_t i = 0; i < HashMapGroupWidth; ++i)
+                {
+                    bits |= static_cast<uint32_t>(_control[i] == value) << i;
+                }
+                return bits;
+#endif
+            }
+
+            uint32_t MatchEmpty() const
+            {
+                return Match(HashMapEmpty);
+            }
+
+            uint32_t MatchEmptyOrDeleted() const
+            {
+#if ALIMER_SSE2
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(HashMapSentinel), _control)));
+#else
+                uint32_t bits = 0;
+                for (uint32_t i = 0; i < HashMapGroupWidth; ++i)
+                {
+                    bits |= static_cast<uint32_t>(_control[i] < HashMapSentinel) << i;
+                }
+                return bits;
+#endif
+            }
+
+        private:
+#if ALIMER_SSE2
+            __m128i _control;
+#else
+            int8_t _control[HashMapGroupWidth];
+#endif
+        };
+    }
+
+    /// Open addressing hash map for pre-hashed 64-bit keys. Slots live in one flat array next to a control byte per
+    /// slot, lookups compare 16 control bytes at a time and inserts only allocate when the map grows.
+    /// Follows the std::unordered_map interface, but growing invalidates iterators, pointers and references.
     template <typename T>
-    using HashMap = std::unordered_map<uint64_t, T, HashMapHasher>;
+    class HashMap
+    {
+    public:
+        using key_type = uint64_t;
+        using mapped_type = T;
+        using value_type = std::pair<const uint64_t, T>;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using hasher = HashMapHasher;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+        template <bool Const>
+        class IteratorBase
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename HashMap::value_type;
+            using difference_type = ptrdiff_t;
+            using reference = typename std::conditional<Const, const value_type&, value_type&>::type;
+            using pointer = typename std::conditional<Const, const value_type*, value_type*>::type;
+
+            IteratorBase() = default;
+
+            /// Construct const iterator from mutable one.
+            template <bool OtherConst, typename std::enable_if<Const && !OtherConst, int>::type = 0>
+            IteratorBase(const IteratorBase<OtherConst>& other)
+                : _control(other._control)
+                , _slot(other._slot)
+            {
+            }
+
+            reference operator *() const { return *_slot; }
+            pointer operator ->() const { return _slot; }
+
+            IteratorBase& operator ++()
+            {
+                ++_control;
+                ++_slot;
+                SkipEmpty();
+                return *this;
+            }
+
+            IteratorBase operator ++(int)
+            {
+                IteratorBase it = *this;
+                ++*this;
+                return it;
+            }
+
+            bool operator ==(const IteratorBase& rhs) const { return _control == rhs._control; }
+            bool operator !=(const IteratorBase& rhs) const { return _control != rhs._control; }
+
+        private:
+            friend class HashMap;
+            template <bool> friend class IteratorBase;
+
+            IteratorBase(const int8_t* control, value_type* slot)
+                : _control(control)
+                , _slot(slot)
+            {
+            }
+
+            void SkipEmpty()
+            {
+                while (*_control < Internal::HashMapSentinel)
+                {
+                    // Skip the run of empty or deleted slots in the group, the sentinel ends it.
+                    const uint32_t skip = trailing_zeroes(~Internal::HashMapGroup(_control).MatchEmptyOrDeleted());
+                    _control += skip;
+                    _slot += skip;
+                }
+            }
+
+            const int8_t* _control = nullptr;
+            value_type* _slot = nullptr;
+        };
+
+        using iterator = IteratorBase<false>;
+        using const_iterator = IteratorBase<true>;
+
+        /// Construct empty, does not allocate.
+        HashMap() = default;
+
+        /// Construct with room for count elements.
+        explicit HashMap(size_type count)
+        {
+            reserve(count);
+        }
+
+        /// Construct from an initializer list.
+        HashMap(std::initializer_list<value_type> list)
+        {
+            insert(list);
+        }
+
+        /// Copy-construct.
+        HashMap(const HashMap& other)
+        {
+            reserve(other.size());
+            for (const value_type& value : other)
+            {
+                try_emplace(value.first, value.second);
+            }
+        }
+
+        /// Move-construct.
+        HashMap(HashMap&& other) noexcept
+        {
+            swap(other);
+        }
+
+        /// Destruct.
+        ~HashMap()
+        {
+            DestroySlots();
+            Deallocate();
+        }
+
+        /// Copy-assign.
+        HashMap& operator =(const HashMap& rhs)
+        {
+            if (this != &rhs)
+            {
+                HashMap copy(rhs);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        /// Move-assign.
+        HashMap& operator =(HashMap&& rhs) noexcept
+        {
+            HashMap moved(std::move(rhs));
+            swap(moved);
+            return *this;
+        }
+
+        iterator begin()
+        {
+            iterator it(_control, _slots);
+            it.SkipEmpty();
+            return it;
+        }
+
+        const_iterator begin() const { return const_cast<HashMap*>(this)->begin(); }
+        const_iterator cbegin() const { return begin(); }
+        iterator end() { return iterator(_control + _capacity, nullptr); }
+        const_iterator end() const { return const_cast<HashMap*>(this)->end(); }
+        const_iterator cend() const { return end(); }
+
+        bool empty() const { return _size == 0; }
+        size_type size() const { return _size; }
+        /// Return number of slots.
+        size_type capacity() const { return _capacity; }
+
+        /// Remove all elements, keeps the allocation.
+        void clear()
+        {
+            DestroySlots();
+            _size = 0;
+            if (_capacity > 0)
+            {
+                ResetControl();
+            }
+        }
+
+        /// Make room for count elements without growing.
+        void reserve(size_type count)
+        {
+            if (count > GetGrowth(_capacity))
+            {
+                Resize(GetCapacityFor(count));
+            }
+        }
+
+        /// Rebuild with room for at least count elements, drops deleted slots.
+        void rehash(size_type count)
+        {
+            const size_type capacity = GetCapacityFor(std::max(count, _size));
+            if (capacity != _capacity || _size + _growthLeft < GetGrowth(_capacity))
+            {
+                Resize(capacity);
+            }
+        }
+
+        template <typename K>
+        iterator find(const K& key)
+        {
+            const uint64_t hash = HashMapHasher::GetKey(key);
+            const size_type index = Find(hash, HashMapHasher::Mix(hash));
+            return index == _capacity ? end() : iterator(_control + index, _slots + index);
+        }
+
+        template <typename K>
+        const_iterator find(const K& key) const
+        {
+            return const_cast<HashMap*>(this)->find(key);
+        }
+
+        template <typename K>
+        size_type count(const K& key) const
+        {
+            return find(key) != end() ? 1 : 0;
+        }
+
+        template <typename K>
+        bool contains(const K& key) const
+        {
+            return find(key) != end();
+        }
+
+        template <typename K>
+        T& at(const K& key)
+        {
+            iterator it = find(key);
+            ALIMER_ASSERT_MSG(it != end(), "Key not found (%llu)", static_cast<unsigned long long>(HashMapHasher::GetKey(key)));
+            return it->second;
+        }
 
+        template <typename K>
+        const T& at(const K& key) const
+        {
+            return const_cast<HashMap*>(this)->at(key);
+        }
+
+        /// Return value of key, default constructed when missing.
+        template <typename K>
+        T& operator [](const K& key)
+        {
+            return try_emplace(HashMapHasher::GetKey(key)).first->second;
+        }
+
+        /// Insert value constructed from args if key is missing.
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(uint64_t key, Args&&... args)
+        {
+            const uint64_t mixed = HashMapHasher::Mix(key);
+            const size_type index = Find(key, mixed);
+            if (index != _capacity)
+            {
+                return std::make_pair(iterator(_control + index, _slots + index), false);
+            }
+
+            const size_type slot = PrepareInsert(mixed);
+            new (_slots + slot) value_type(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+            return std::make_pair(iterator(_control + slot, _slots + slot), true);
+        }
+
+        /// Insert value constructed from args if key is missing, same as try_emplace.
+        template <typename... Args>
+        std::pair<iterator, bool> emplace(uint64_t key, Args&&... args)
+        {
+            return try_emplace(key, std::forward<Args>(args)...);
+        }
+
+        std::pair<iterator, bool> insert(const value_type& value)
+        {
+            return try_emplace(value.first, value.second);
+        }
+
+        /// Insert key and value pair such as std::make_pair(hash, value).
+        template <typename P, typename std::enable_if<std::is_constructible<value_type, P&&>::value, int>::type = 0>
+        std::pair<iterator, bool> insert(P&& value)
+        {
+            return try_emplace(value.first, std::forward<P>(value).second);
+        }
+
+        template <typename InputIterator>
+        void insert(InputIterator first, InputIterator last)
+        {
+            for (; first != last; ++first)
+            {
+                insert(*first);
+            }
+        }
+
+        void insert(std::initializer_list<value_type> list)
+        {
+            reserve(_size + list.size());
+            insert(list.begin(), list.end());
+        }
+
+        /// Insert or replace value of key.
+        template <typename V>
+        std::pair<iterator, bool> insert_or_assign(uint64_t key, V&& value)
+        {
+            std::pair<iterator, bool> result = try_emplace(key, std::forward<V>(value));
+            if (!result.second)
+            {
+                result.first->second = std::forward<V>(value);
+            }
+            return result;
+        }
+
+        /// Erase element, return iterator to the next one.
+        iterator erase(const_iterator position)
+        {
+            const size_type index = static_cast<size_type>(position._control - _control);
+            EraseAt(index);
+            iterator it(_control + index, _slots + index);
+            ++it;
+            return it;
+        }
+
+        iterator erase(iterator position)
+        {
+            return erase(const_iterator(position));
+        }
+
+        template <typename K>
+        size_type erase(const K& key)
+        {
+            const uint64_t hash = HashMapHasher::GetKey(key);
+            const size_type index = Find(hash, HashMapHasher::Mix(hash));
+            if (index == _capacity)
+                return 0;
+
+            EraseAt(index);
+            return 1;
+        }
+
+        void swap(HashMap& other) noexcept
+        {
+            std::swap(_control, other._control);
+            std::swap(_slots, other._slots);
+            std::swap(_capacity, other._capacity);
+            std::swap(_size, other._size);
+            std::swap(_growthLeft, other._growthLeft);
+        }
+
+    private:
+        static_assert(alignof(value_type) <= alignof(std::max_align_t), "Over-aligned values are not supported");
+
+        /// Slots that can be filled before growing, keeps at least one empty slot per probe sequence.
+        static size_type GetGrowth(size_type capacity) { return capacity - capacity / 8; }
+
+        /// Smallest 2^n - 1 capacity holding count elements.
+        static size_type GetCapacityFor(size_type count)
+        {
+            size_type capacity = Internal::HashMapGroupWidth - 1;
+            while (GetGrowth(capacity) < count)
+            {
+                capacity = capacity * 2 + 1;
+            }
+            return capacity;
+        }
+
+        static size_type GetSlotOffset(size_type capacity)
+        {
+            const size_type controlSize = capacity + Internal::HashMapGroupWidth;
+            return (controlSize + alignof(value_type) - 1) & ~(alignof(value_type) - 1);
+        }
+
+        /// Return slot index of key or capacity when missing.
+        size_type Find(uint64_t key, uint64_t mixed) const
+        {
+            if (_size == 0)
+                return _capacity;
+
+            const int8_t tag = static_cast<int8_t>(mixed & 0x7f);
+            size_type position = static_cast<size_type>(mixed >> 7) & _capacity;
+            size_type step = 0;
+            for (;;)
+            {
+                const Internal::HashMapGroup group(_control + position);
+                uint32_t match = group.Match(tag);
+                while (match != 0)
+                {
+                    const size_type index = (position + ScanForward(match)) & _capacity;
+                    if (_slots[index].first == key)
+                        return index;
+
+                    match &= match - 1;
+                }
+
+                if (group.MatchEmpty() != 0)
+                    return _capacity;
+
+                step += Internal::HashMapGroupWidth;
+                position = (position + step) & _capacity;
+            }
+        }
+
+        /// Return first empty or deleted slot along the probe sequence.
+        size_type FindFirstFree(uint64_t mixed) const
+        {
+            size_type position = static_cast<size_type>(mixed >> 7) & _capacity;
+            size_type step = 0;
+            for (;;)
+            {
+                const uint32_t free = Internal::HashMapGroup(_control + position).MatchEmptyOrDeleted();
+                if (free != 0)
+                    return (position + ScanForward(free)) & _capacity;
+
+                step += Internal::HashMapGroupWidth;
+                position = (position + step) & _capacity;
+            }
+        }
+
+        /// Claim a slot for a new key, the caller constructs the value.
+        size_type PrepareInsert(uint64_t mixed)
+        {
+            size_type index = _capacity > 0 ? FindFirstFree(mixed) : 0;
+            if (_capacity == 0 || (_growthLeft == 0 && _control[index] != Internal::HashMapDeleted))
+            {
+                // Rebuild in place when deleted slots hold most of the space, otherwise grow.
+                Resize(_size + 1 <= GetGrowth(_capacity) / 2 ? _capacity : GetCapacityFor(_size + 1));
+                index = FindFirstFree(mixed);
+            }
+
+            _growthLeft -= _control[index] == Internal::HashMapEmpty;
+            SetControl(index, static_cast<int8_t>(mixed & 0x7f));
+            ++_size;
+            return index;
+        }
+
+        void EraseAt(size_type index)
+        {
+            _slots[index].~value_type();
+            --_size;
+
+            // A slot can go back to empty when no probe sequence ever saw a full group around it.
+            const size_type before = (index - Internal::HashMapGroupWidth) & _capacity;
+            const uint32_t emptyAfter = Internal::HashMapGroup(_control + index).MatchEmpty();
+            const uint32_t emptyBefore = Internal::HashMapGroup(_control + before).MatchEmpty();
+            const bool neverFull = emptyBefore != 0 && emptyAfter != 0
+                && static_cast<uint32_t>(trailing_zeroes(emptyAfter) + leading_zeroes(emptyBefore << 16)) < Internal::HashMapGroupWidth;
+            SetControl(index, neverFull ? Internal::HashMapEmpty : Internal::HashMapDeleted);
+            _growthLeft += neverFull;
+        }
+
+        /// Set control byte and its copy past the sentinel that lets groups read over the end.
+        void SetControl(size_type index, int8_t value)
+        {
+            _control[index] = value;
+            _control[((index - (Internal::HashMapGroupWidth - 1)) & _capacity) + (Internal::HashMapGroupWidth - 1)] = value;
+        }
+
+        void ResetControl()
+        {
+            memset(_control, Internal::HashMapEmpty, _capacity + Internal::HashMapGroupWidth);
+            _control[_capacity] = Internal::HashMapSentinel;
+            _growthLeft = GetGrowth(_capacity) - _size;
+        }
+
+        void Resize(size_type capacity)
+        {
+            int8_t* oldControl = _control;
+            value_type* oldSlots = _slots;
+            const size_type oldCapacity = _capacity;
+
+            const size_type slotOffset = GetSlotOffset(capacity);
+            uint8_t* memory = static_cast<uint8_t*>(::operator new(slotOffset + capacity * sizeof(value_type)));
+            _control = reinterpret_cast<int8_t*>(memory);
+            _slots = reinterpret_cast<value_type*>(memory + slotOffset);
+            _capacity = capacity;
+            ResetControl();
+
+            for (size_type i = 0; i < oldCapacity; ++i)
+            {
+                if (oldControl[i] >= 0)
+                {
+                    const size_type index = FindFirstFree(HashMapHasher::Mix(oldSlots[i].first));
+                    SetControl(index, oldControl[i]);
+                    new (_slots + index) value_type(std::move(oldSlots[i]));
+                    oldSlots[i].~value_type();
+                }
+            }
+
+            if (oldCapacity > 0)
+            {
+                ::operator delete(oldControl);
+            }
+        }
+
+        void DestroySlots()
+        {
+            if (std::is_trivially_destructible<value_type>::value || _size == 0)
+                return;
+
+            for (size_type i = 0; i < _capacity; ++i)
+            {
+                if (_control[i] >= 0)
+                {
+                    _slots[i].~value_type();
+                }
+            }
+        }
+
+        void Deallocate()
+        {
+            if (_capacity > 0)
+            {
+                ::operator delete(_control);
+            }
+        }
+
+        /// Capacity + 1 + 15 control bytes: slots, the sentinel and a copy of the first 15 bytes.
+        int8_t* _control = const_cast<int8_t*>(Internal::GetHashMapEmptyGroup());
+        value_type* _slots = nullptr;
+        size_type _capacity = 0;
+        size_type _size = 0;
+        size_type _growthLeft = 0;
+    };
+
+    namespace Internal
+    {
+        /// Multiply to 128 bits and fold the halves.
+        inline uint64_t HashMix(uint64_t a, uint64_t b)
+        {
+#if defined(__SIZEOF_INT128__)
+            const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+            return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            uint64_t high;
+            const uint64_t low = _umul128(a, b, &high);
+            return low ^ high;
+#else
+            const uint64_t lo = (a & 0xffffffffull) * (b & 0xffffffffull);
+            const uint64_t mid1 = (a >> 32) * (b & 0xffffffffull);
+            const uint64_t mid2 = (a & 0xffffffffull) * (b >> 32);
+            const uint64_t hi = (a >> 32) * (b >> 32);
+            const uint64_t carry = ((lo >> 32) + (mid1 & 0xffffffffull) + (mid2 & 0xffffffffull)) >> 32;
+            return (lo + (mid1 << 32) + (mid2 << 32)) ^ (hi + (mid1 >> 32) + (mid2 >> 32) + carry);
+#endif
+        }
+
+        inline uint64_t HashRead64(const uint8_t* data)
+        {
+            uint64_t value;
+            memcpy(&value, data, sizeof(value));
+            return value;
+        }
+    }
+
+    /// Streaming 64-bit hasher for cache keys. Words are multiplied with a key derived from their position and the
+    /// products are summed, so mixes do not wait on each other. GetValue finalizes with a single 64x64->128 bit
+    /// multiply-fold (wyhash style) and hashing can continue afterwards.
     class Hasher
     {
     public:
-        Hasher(uint64_t value) : _value(value) {}
+        /// Construct with a seed, such as the value of another hasher.
+        Hasher(uint64_t value)
+            : _value(value)
+        {
+        }
+
         Hasher() = default;
 
+        /// Hash size bytes of data.
         template <typename T>
         inline void Data(const T *data, size_t size)
         {
-            size /= sizeof(*data);
-            for (size_t i = 0; i < size; i++)
-            {
-                _value = (_value * 0x100000001b3ull) ^ data[i];
-            }
+            Bytes(data, size);
         }
 
-        inline void UInt32(uint32_t value)
+        ALIMER_FORCE_INLINE void UInt32(uint32_t value)
         {
-            _value = (_value * 0x100000001b3ull) ^ value;
+            // Two values share a 64-bit multiply, the first one waits in _pending. Both factors are odd, so changing
+            // either value always changes the product.
+            if (_pending)
+            {
+                const uint64_t key = PositionKey();
+                _value += (_pending + (key << 1)) * (2 * static_cast<uint64_t>(value) + (RotateKey(key) | 1));
+                _length += 2 * sizeof(value);
+                _pending = 0;
+                return;
+            }
+
+            _pending = 2 * static_cast<uint64_t>(value) + 1;
         }
 
         inline void SInt32(int32_t value)
@@ -76,10 +736,9 @@ namespace Alimer
             UInt32(u.u32);
         }
 
-        inline void UInt64(uint64_t value)
+        ALIMER_FORCE_INLINE void UInt64(uint64_t value)
         {
-            UInt32(value & 0xffffffffu);
-            UInt32(value >> 32);
+            Mix(value, 0, sizeof(value));
         }
 
         template <typename T>
@@ -88,28 +747,73 @@ namespace Alimer
             UInt64(reinterpret_cast<uintptr_t>(ptr));
         }
 
+        /// Hash string with its length first, so consecutive strings cannot run into each other.
         inline void String(const char *str)
         {
-            char c;
-            UInt32(0xff);
-            while ((c = *str++) != '\0')
-            {
-                UInt32(static_cast<uint8_t>(c));
-            }
+            const size_t length = strlen(str);
+            UInt32(static_cast<uint32_t>(length));
+            Bytes(str, length);
         }
 
         inline void String(const Alimer::String &str)
         {
-            UInt32(0xff);
-            for (auto &c : str)
+            UInt32(str.Length());
+            Bytes(str.CString(), str.Length());
+        }
+
+        /// Hash size bytes. Whole pairs of words are mixed in place, only the tail is copied out.
+        void Bytes(const void* data, size_t size)
+        {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            for (; size >= 16; size -= 16, bytes += 16)
+            {
+                Mix(Internal::HashRead64(bytes), Internal::HashRead64(bytes + 8), 16);
+            }
+
+            if (size > 0)
             {
-                UInt32(uint8_t(c));
+                uint64_t tail[2] = {};
+                memcpy(tail, bytes, size);
+                Mix(tail[0], tail[1], static_cast<uint32_t>(size));
             }
         }
 
-        inline uint64_t GetValue() const { return _value; }
+        inline uint64_t GetValue() const
+        {
+            return Internal::HashMix(_value ^ _pending ^ Secret2, _length ^ _pending ^ Secret3);
+        }
 
     private:
-        uint64_t _value = 0xcbf29ce484222325ull;
+        static constexpr uint64_t Secret0 = 0xa0761d6478bd642full;
+        static constexpr uint64_t Secret1 = 0xe7037ed1a0b428dbull;
+        static constexpr uint64_t Secret2 = 0x8ebc6af09c88c6e3ull;
+        static constexpr uint64_t Secret3 = 0x589965cc75374cc3ull;
+
+        /// Key of the current position. Quadratic in the length, so keys of different positions have no small linear
+        /// relation a sum of products could cancel. Constant when the position is known at compile time.
+        ALIMER_FORCE_INLINE uint64_t PositionKey() const
+        {
+            return Internal::HashMix(_length ^ Secret0, _length ^ Secret1);
+        }
+
+        /// Key of the second factor of a UInt32 pair, the halves swapped so it has no linear relation to the first.
+        static ALIMER_FORCE_INLINE uint64_t RotateKey(uint64_t key)
+        {
+            return (key >> 32) | (key << 32);
+        }
+
+        /// Add the mix of two words at the current position, size is the number of input bytes in them.
+        ALIMER_FORCE_INLINE void Mix(uint64_t word0, uint64_t word1, uint32_t size)
+        {
+            const uint64_t key = PositionKey();
+            _value += Internal::HashMix(word0 ^ key, word1 ^ key ^ Secret2);
+            _length += size;
+        }
+
+        uint64_t _value = 0;
+        /// Bytes mixed so far.
+        uint64_t _length = 0;
+        /// Odd encoding of a UInt32 value waiting for the next one, zero if none.
+        uint64_t _pending = 0;
     };
 }
@@ -21,6 +21,10 @@
 //
 
 #include "../Base/MurmurHash.h"
+#include <cstring>
+#if ALIMER_SSE2
+#   include <emmintrin.h>
+#endif
 
 namespace Alimer
 {
@@ -135,6 +139,131 @@ namespace Alimer
         return Hash(h1, h2);
     }
 
+    static const uint32_t WideLaneCount = 8;
+    static const uint32_t WideStripeSize = WideLaneCount * sizeof(uint64_t);
+    /// Stripes between accumulator scrambles.
+    static const uint32_t WideStripesPerBlock = 16;
+
+    static const uint64_t WideSecret[WideLaneCount + 1] =
+    {
+        0xbe4ba423396cfeb8ULL, 0x1cad21f72c81017cULL, 0xdb979083e96dd4deULL, 0x1f67b3b7a4a44072ULL,
+        0x78e5c0cc4ee679cbULL, 0x2172ffcc7dd05a82ULL, 0x8e2443f7744608b8ULL, 0x4c263a81e69035e0ULL,
+        0xcb00c391bb52283cULL
+    };
+
+#if ALIMER_SSE2
+    static void accumulatestripes(uint64_t* lanes, const uint8_t* data, size_t stripeCount, const uint64_t* secret)
+    {
+        __m128i acc[WideLaneCount / 2];
+        __m128i key[WideLaneCount / 2];
+        for (uint32_t i = 0; i < WideLaneCount / 2; i++)
+        {
+            acc[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + i * 2));
+            key[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret + i * 2));
+        }
+
+        for (size_t stripe = 0; stripe < stripeCount; stripe++, data += WideStripeSize)
+        {
+            for (uint32_t i = 0; i < WideLaneCount / 2; i++)
+            {
+                // Low times high half of each keyed 64-bit lane, plus the neighbour lane's input.
+                const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16));
+                const __m128i keyed = _mm_xor_si128(value, key[i]);
+                const __m128i product = _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, _MM_SHUFFLE(2, 3, 0, 1)));
+                acc[i] = _mm_add_epi64(acc[i], _mm_add_epi64(product, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2))));
+            }
+        }
+
+        for (uint32_t i = 0; i < WideLaneCount / 2; i++)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes + i * 2), acc[i]);
+        }
+    }
+#else
+    static void accumulatestripes(uint64_t* lanes, const uint8_t* data, size_t stripeCount, const uint64_t* secret)
+    {
+        for (size_t stripe = 0; stripe < stripeCount; stripe++, data += WideStripeSize)
+        {
+            for (uint32_t i = 0; i < WideLaneCount; i++)
+            {
+                uint64_t value;
+                memcpy(&value, data + i * sizeof(uint64_t), sizeof(value));
+                const uint64_t keyed = value ^ secret[i];
+                lanes[i ^ 1] += value;
+                lanes[i] += (keyed & 0xffffffffULL) * (keyed >> 32);
+            }
+        }
+    }
+#endif
+
+    static void scramblelanes(uint64_t* lanes, const uint64_t* secret)
+    {
+        for (uint32_t i = 0; i < WideLaneCount; i++)
+        {
+            uint64_t lane = lanes[i];
+            lane ^= lane >> 47;
+            lane ^= secret[i + 1];
+            lanes[i] = lane * 0x9e3779b1ULL;
+        }
+    }
+
+    Hash GenerateHashWide(const void* key, int32_t len, uint32_t seed)
+    {
+        const uint8_t* data = static_cast<const uint8_t*>(key);
+        const size_t size = static_cast<size_t>(len);
+
+        uint64_t secret[WideLaneCount + 1];
+        uint64_t lanes[WideLaneCount];
+        for (uint32_t i = 0; i < WideLaneCount; i++)
+        {
+            secret[i] = WideSecret[i] + seed;
+            lanes[i] = WideSecret[i] ^ seed;
+        }
+        secret[WideLaneCount] = WideSecret[WideLaneCount] - seed;
+
+        size_t stripeCount = size / WideStripeSize;
+        for (; stripeCount >= WideStripesPerBlock; stripeCount -= WideStripesPerBlock)
+        {
+            accumulatestripes(lanes, data, WideStripesPerBlock, secret);
+            scramblelanes(lanes, secret);
+            data += WideStripesPerBlock * WideStripeSize;
+        }
+
+        accumulatestripes(lanes, data, stripeCount, secret);
+        data += stripeCount * WideStripeSize;
+
+        // Zero padded tail, the length below tells it apart from real zeros.
+        const size_t tailSize = size % WideStripeSize;
+        if (tailSize > 0)
+        {
+            uint8_t tail[WideStripeSize] = {};
+            memcpy(tail, data, tailSize);
+            accumulatestripes(lanes, tail, 1, secret);
+        }
+
+        // MurmurHash3 style finalization of the lanes.
+        const uint64_t c1 = 0x87c37b91114253d5ULL;
+        const uint64_t c2 = 0x4cf5ad432745937fULL;
+        uint64_t h1 = seed ^ (size * c1);
+        uint64_t h2 = seed ^ (size * c2);
+        for (uint32_t i = 0; i < WideLaneCount / 2; i++)
+        {
+            h1 = _rotl64(h1 ^ fmix64(lanes[i]), 27) * c1;
+            h2 = _rotl64(h2 ^ fmix64(lanes[i + WideLaneCount / 2]), 31) * c2;
+        }
+
+        h1 += h2;
+        h2 += h1;
+
+        h1 = fmix64(h1);
+        h2 = fmix64(h2);
+
+        h1 += h2;
+        h2 += h1;
+
+        return Hash(h1, h2);
+    }
+
     Hash CombineHashes(Hash a, Hash b)
     {
         Hash c;
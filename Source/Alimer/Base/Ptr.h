@@ -23,6 +23,7 @@
 #pragma once
 
 #include "AlimerConfig.h"
+#include "../Base/Allocator.h"
 #include <cassert>
 #include <cstddef>
 #include <memory>
@@ -275,6 +276,8 @@ namespace Alimer
         T* ptr_;
     };
 
+    template <class T> struct IsRelocatable<SharedPtr<T>> : std::true_type {};
+
     /// Perform a static cast from one shared pointer type to another.
     template <class T, class U> SharedPtr<T> StaticCast(const SharedPtr<U>& ptr)
     {
@@ -673,6 +676,8 @@ namespace Alimer
         T * _ptr;
     };
 
+    template <class T> struct IsRelocatable<UniquePtr<T>> : std::true_type {};
+
     /// Pointer which takes ownership of an array allocated with new[] and deletes it when the pointer goes out of scope.
     template <class T> class AutoArrayPtr
     {
@@ -231,27 +231,22 @@ namespace Alimer
             if (_capacity < MIN_CAPACITY)
                 _capacity = MIN_CAPACITY;
 
-            _buffer = new char[_capacity];
+            _buffer = static_cast<char*>(AllocateMemory(_allocator, _capacity, 1));
         }
         else
         {
             if (newLength && _capacity < newLength + 1)
             {
                 // Increase the capacity with half each time it is exceeded
-                while (_capacity < newLength + 1)
+                uint32_t newCapacity = _capacity;
+                while (newCapacity < newLength + 1)
                 {
-                    _capacity += (_capacity + 1) >> 1u;
+                    newCapacity += (newCapacity + 1) >> 1u;
                 }
 
-                auto* newBuffer = new char[_capacity];
-                // Move the existing data to the new buffer, then delete the old buffer
-                if (_length)
-                {
-                    CopyChars(newBuffer, _buffer, _length);
-                }
-                delete[] _buffer;
-
-                _buffer = newBuffer;
+                // Keeps the existing data, the allocator may grow the buffer in place
+                _buffer = static_cast<char*>(ReallocateMemory(_allocator, _buffer, _capacity, newCapacity, 1));
+                _capacity = newCapacity;
             }
         }
 
@@ -266,16 +261,18 @@ namespace Alimer
         if (newCapacity == _capacity)
             return;
 
-        auto* newBuffer = new char[newCapacity];
-        // Move the existing data to the new buffer, then delete the old buffer
-        CopyChars(newBuffer, _buffer, _length + 1);
         if (_capacity)
         {
-            delete[] _buffer;
+            _buffer = static_cast<char*>(ReallocateMemory(_allocator, _buffer, _capacity, newCapacity, 1));
+        }
+        else
+        {
+            auto* newBuffer = static_cast<char*>(AllocateMemory(_allocator, newCapacity, 1));
+            CopyChars(newBuffer, _buffer, _length + 1);
+            _buffer = newBuffer;
         }
 
         _capacity = newCapacity;
-        _buffer = newBuffer;
     }
 
     void String::Compact()
@@ -296,6 +293,7 @@ namespace Alimer
         Alimer::Swap(_length, str._length);
         Alimer::Swap(_capacity, str._capacity);
         Alimer::Swap(_buffer, str._buffer);
+        Alimer::Swap(_allocator, str._allocator);
     }
 
     int String::Compare(const String& str, bool caseSensitive) const
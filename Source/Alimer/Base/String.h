@@ -55,7 +55,16 @@ namespace Alimer
         {
         }
 
-        /// Construct from another string.
+        /// Construct empty with allocator for the buffer, null uses the heap.
+        explicit String(Allocator* allocator) noexcept
+            : _length(0)
+            , _capacity(0)
+            , _buffer(&END_ZERO)
+            , _allocator(allocator)
+        {
+        }
+
+        /// Construct from another string. The copy uses the heap, not the allocator of the other string.
         String(const String& str)
             : _length(0)
             , _capacity(0)
@@ -64,7 +73,7 @@ namespace Alimer
             *this = str;
         }
 
-        /// Move-construct from another string.
+        /// Move-construct from another string, taking its allocator.
         String(String && str) noexcept
             : _length(0)
             , _capacity(0)
@@ -168,7 +177,8 @@ namespace Alimer
         explicit String(char value, uint32_t length);
 
         /// Construct from a convertible value.
-        template <class T> explicit String(const T& value)
+        template <class T, typename std::enable_if<!std::is_convertible<T, Allocator*>::value, int>::type = 0>
+        explicit String(const T& value)
             : _length(0)
             , _capacity(0)
             , _buffer(&END_ZERO)
@@ -180,7 +190,7 @@ namespace Alimer
         ~String()
         {
             if (_capacity) {
-                delete[] _buffer;
+                FreeMemory(_allocator, _buffer, _capacity);
             }
         }
 
@@ -196,11 +206,19 @@ namespace Alimer
             return *this;
         }
 
-        /// Move-assign a string.
+        /// Move-assign a string. Keeps the allocator, the characters are copied if the allocators differ.
         String& operator =(String && rhs) noexcept
         {
             assert(&rhs != this);
-            Swap(rhs);
+            if (_allocator == rhs._allocator)
+            {
+                Swap(rhs);
+            }
+            else
+            {
+                *this = static_cast<const String&>(rhs);
+            }
+
             return *this;
         }
 
@@ -363,7 +381,7 @@ namespace Alimer
         void Compact();
         /// Clear the string.
         void Clear();
-        /// Swap with another string.
+        /// Swap with another string. The allocators are swapped along with the buffers.
         void Swap(String& str);
 
         /// Return comparison result with a string.
@@ -507,6 +525,8 @@ namespace Alimer
 
         /// Return buffer capacity.
         uint32_t Capacity() const { return _capacity; }
+        /// Return allocator of the buffer, null if the heap is used.
+        Allocator* GetAllocator() const { return _allocator; }
 
         /// Return whether the string is empty.
         bool IsEmpty() const { return _length == 0; }
@@ -591,11 +611,15 @@ namespace Alimer
         uint32_t _capacity;
         /// String buffer, point to &endZero if buffer is not allocated.
         char* _buffer;
+        /// Allocator of the buffer, null for the heap.
+        Allocator* _allocator = nullptr;
 
         /// End zero for empty strings.
         static char END_ZERO;
     };
 
+    template <> struct IsRelocatable<String> : std::true_type {};
+
     /// Add a string to a C string.
     inline String operator +(const char* lhs, const String& rhs)
     {
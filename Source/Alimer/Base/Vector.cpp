@@ -26,13 +26,18 @@
 
 namespace Alimer
 {
-    uint8_t* VectorBase::AllocateBuffer(size_t size)
+    uint8_t* VectorBase::AllocateBuffer(size_t size, size_t alignment)
     {
-        return new uint8_t[size];
+        return static_cast<uint8_t*>(AllocateMemory(_allocator, size, alignment));
     }
 
-    void VectorBase::FreeBuffer(const uint8_t* buffer)
+    uint8_t* VectorBase::ReallocateBuffer(size_t oldSize, size_t newSize, size_t alignment)
     {
-        delete[] buffer;
+        return static_cast<uint8_t*>(ReallocateMemory(_allocator, _buffer, oldSize, newSize, alignment));
+    }
+
+    void VectorBase::FreeBuffer(uint8_t* buffer, size_t size)
+    {
+        FreeMemory(_allocator, buffer, size);
     }
 }
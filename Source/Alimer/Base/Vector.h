@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "../Base/Allocator.h"
 #include "../Base/Swap.h"
 #include "../Base/Iterator.h"
 #include "../Debug/Debug.h"
@@ -50,12 +51,19 @@ namespace Alimer
         /// Construct.
         VectorBase() noexcept = default;
 
-        /// Swap with another vector.
+        /// Construct with allocator, null uses the heap.
+        explicit VectorBase(Allocator* allocator) noexcept
+            : _allocator(allocator)
+        {
+        }
+
+        /// Swap with another vector. The allocators are swapped along with the buffers.
         void Swap(VectorBase& rhs)
         {
             Alimer::Swap(_size, rhs._size);
             Alimer::Swap(_capacity, rhs._capacity);
             Alimer::Swap(_buffer, rhs._buffer);
+            Alimer::Swap(_allocator, rhs._allocator);
         }
 
         /// Return number of elements in the vector.
@@ -64,10 +72,13 @@ namespace Alimer
         uint32_t Capacity() const { return _capacity; }
         /// Return whether has no elements.
         bool IsEmpty() const { return _size == 0; }
+        /// Return allocator, null if the heap is used.
+        Allocator* GetAllocator() const { return _allocator; }
 
     protected:
-        static uint8_t* AllocateBuffer(size_t size);
-        static void FreeBuffer(const uint8_t* buffer);
+        uint8_t* AllocateBuffer(size_t size, size_t alignment);
+        uint8_t* ReallocateBuffer(size_t oldSize, size_t newSize, size_t alignment);
+        void FreeBuffer(uint8_t* buffer, size_t size);
 
         /// Size of vector.
         uint32_t _size = 0;
@@ -75,6 +86,8 @@ namespace Alimer
         uint32_t _capacity = 0;
         /// Buffer.
         uint8_t* _buffer = nullptr;
+        /// Allocator of the buffer, null for the heap.
+        Allocator* _allocator = nullptr;
     };
 
     template<typename T> class Vector : public VectorBase
@@ -90,6 +103,12 @@ namespace Alimer
 
         Vector() noexcept = default;
 
+        /// Construct empty with allocator.
+        explicit Vector(Allocator* allocator) noexcept
+            : VectorBase(allocator)
+        {
+        }
+
         /// Construct with initial size.
         explicit Vector(uint32_t size)
         {
@@ -112,14 +131,22 @@ namespace Alimer
             DoInsertElements(0, data, data + size, CopyTag{});
         }
 
-        /// Copy-construct from another vector.
+        /// Copy-construct from another vector. The copy uses the heap, not the allocator of the other vector.
         Vector(const Vector<T>& vector)
+            : VectorBase()
+        {
+            DoInsertElements(0, vector.Begin(), vector.End(), CopyTag{});
+        }
+
+        /// Copy-construct from another vector with allocator.
+        Vector(const Vector<T>& vector, Allocator* allocator)
+            : VectorBase(allocator)
         {
             DoInsertElements(0, vector.Begin(), vector.End(), CopyTag{});
         }
 
-        /// Move-construct from another vector.
-        Vector(Vector<T> && vector)
+        /// Move-construct from another vector, taking its allocator.
+        Vector(Vector<T> && vector) noexcept
         {
             Swap(vector);
         }
@@ -136,27 +163,37 @@ namespace Alimer
         ~Vector()
         {
             DestructElements(Buffer(), _size);
-            FreeBuffer(_buffer);
+            FreeBuffer(_buffer, _capacity * sizeof(T));
         }
 
-        /// Assign from another vector.
+        /// Assign from another vector. Keeps the allocator.
         Vector<T>& operator =(const Vector<T>& rhs)
         {
             // In case of self-assignment do nothing
             if (&rhs != this)
             {
-                Vector<T> copy(rhs);
+                Vector<T> copy(rhs, _allocator);
                 Swap(copy);
             }
 
             return *this;
         }
 
-        /// Move-assign from another vector.
+        /// Move-assign from another vector. Keeps the allocator, elements are moved one by one if the allocators differ.
         Vector<T>& operator =(Vector<T> && rhs)
         {
             ALIMER_ASSERT(&rhs != this);
-            Swap(rhs);
+            if (_allocator == rhs._allocator)
+            {
+                Swap(rhs);
+            }
+            else
+            {
+                Clear();
+                DoInsertElements(0, rhs.Begin(), rhs.End(), MoveTag{});
+                rhs.Clear();
+            }
+
             return *this;
         }
 
@@ -482,20 +519,7 @@ namespace Alimer
 
             if (newCapacity != _capacity)
             {
-                T* newBuffer = nullptr;
-                _capacity = newCapacity;
-
-                if (_capacity)
-                {
-                    newBuffer = reinterpret_cast<T*>(AllocateBuffer(_capacity * sizeof(T)));
-                    // Move the data into the new buffer
-                    ConstructElements(newBuffer, Begin(), End(), MoveTag{});
-                }
-
-                // Delete the old buffer
-                DestructElements(Buffer(), _size);
-                FreeBuffer(_buffer);
-                _buffer = reinterpret_cast<uint8_t*>(newBuffer);
+                Reallocate(newCapacity);
             }
         }
 
@@ -612,6 +636,36 @@ namespace Alimer
             }
         }
 
+        /// Move elements to uninitialized memory and destruct the originals.
+        static void RelocateElements(T* dest, T* src, uint32_t count, std::true_type)
+        {
+            if (count)
+            {
+                memcpy(static_cast<void*>(dest), static_cast<const void*>(src), count * sizeof(T));
+            }
+        }
+
+        static void RelocateElements(T* dest, T* src, uint32_t count, std::false_type)
+        {
+            ConstructElements(dest, src, src + count, MoveTag{});
+            DestructElements(src, count);
+        }
+
+        static void RelocateElements(T* dest, T* src, uint32_t count)
+        {
+            RelocateElements(dest, src, count, IsRelocatable<T>{});
+        }
+
+        /// Move elements to a new buffer of newCapacity, which is at least the size.
+        void Reallocate(uint32_t newCapacity)
+        {
+            T* newBuffer = newCapacity ? reinterpret_cast<T*>(AllocateBuffer(newCapacity * sizeof(T), alignof(T))) : nullptr;
+            RelocateElements(newBuffer, Buffer(), _size);
+            FreeBuffer(_buffer, _capacity * sizeof(T));
+            _buffer = reinterpret_cast<uint8_t*>(newBuffer);
+            _capacity = newCapacity;
+        }
+
         /// Calculate new vector capacity.
         static uint32_t CalculateCapacity(uint32_t size, uint32_t capacity)
         {
@@ -635,21 +689,10 @@ namespace Alimer
             }
             else
             {
-                // Allocate new buffer if necessary and copy the current elements
+                // Allocate new buffer if necessary and move the current elements
                 if (newSize > _capacity)
                 {
-                    T* src = Buffer();
-
-                    // Reallocate vector
-                    Vector<T> newVector;
-                    newVector.Reserve(CalculateCapacity(newSize, _capacity));
-                    newVector._size = _size;
-                    T* dest = newVector.Buffer();
-
-                    // Move old elements
-                    ConstructElements(dest, src, src + _size, MoveTag{});
-
-                    Swap(newVector);
+                    Reallocate(CalculateCapacity(newSize, _capacity));
                 }
 
                 // Initialize the new elements
@@ -670,23 +713,20 @@ namespace Alimer
             if (_size + numElements > _capacity)
             {
                 T* src = Buffer();
+                const uint32_t newCapacity = CalculateCapacity(_size + numElements, _capacity);
+                T* dest = reinterpret_cast<T*>(AllocateBuffer(newCapacity * sizeof(T), alignof(T)));
 
-                // Reallocate vector
-                Vector<T> newVector;
-                newVector.Reserve(CalculateCapacity(_size + numElements, _capacity));
-                newVector._size = _size + numElements;
-                T* dest = newVector.Buffer();
-
-                // Copy or move new elements
+                // Copy or move new elements first, the source may point into the old buffer
                 ConstructElements(dest + pos, start, end, Tag{});
 
                 // Move old elements
-                if (pos > 0)
-                    ConstructElements(dest, src, src + pos, MoveTag{});
-                if (pos < _size)
-                    ConstructElements(dest + pos + numElements, src + pos, src + _size, MoveTag{});
+                RelocateElements(dest, src, pos);
+                RelocateElements(dest + pos + numElements, src + pos, _size - pos);
 
-                Swap(newVector);
+                FreeBuffer(_buffer, _capacity * sizeof(T));
+                _buffer = reinterpret_cast<uint8_t*>(dest);
+                _capacity = newCapacity;
+                _size += numElements;
             }
             else if (numElements > 0)
             {
@@ -741,6 +781,12 @@ namespace Alimer
         /// Construct empty.
         PODVector() noexcept = default;
 
+        /// Construct empty with allocator.
+        explicit PODVector(Allocator* allocator) noexcept
+            : VectorBase(allocator)
+        {
+        }
+
         /// Construct with initial size.
         explicit PODVector(uint32_t size)
         {
@@ -764,12 +810,26 @@ namespace Alimer
             CopyElements(Buffer(), data, size);
         }
 
-        /// Construct from another vector.
+        /// Construct from another vector. The copy uses the heap, not the allocator of the other vector.
         PODVector(const PODVector<T>& vector)
+            : VectorBase()
+        {
+            *this = vector;
+        }
+
+        /// Construct from another vector with allocator.
+        PODVector(const PODVector<T>& vector, Allocator* allocator)
+            : VectorBase(allocator)
         {
             *this = vector;
         }
 
+        /// Move-construct from another vector, taking its allocator.
+        PODVector(PODVector<T>&& vector) noexcept
+        {
+            Swap(vector);
+        }
+
         /// Aggregate initialization constructor.
         PODVector(const std::initializer_list<T>& list) : PODVector()
         {
@@ -782,7 +842,7 @@ namespace Alimer
         /// Destruct.
         ~PODVector()
         {
-            FreeBuffer(_buffer);
+            FreeBuffer(_buffer, _capacity * sizeof(T));
         }
 
         /// Assign from another vector.
@@ -797,6 +857,23 @@ namespace Alimer
             return *this;
         }
 
+        /// Move-assign from another vector. Keeps the allocator, the elements are copied if the allocators differ.
+        PODVector<T>& operator =(PODVector<T>&& rhs)
+        {
+            ALIMER_ASSERT(&rhs != this);
+            if (_allocator == rhs._allocator)
+            {
+                Swap(rhs);
+            }
+            else
+            {
+                *this = static_cast<const PODVector<T>&>(rhs);
+                rhs.Clear();
+            }
+
+            return *this;
+        }
+
         /// Add-assign an element.
         PODVector<T>& operator +=(const T& rhs)
         {
@@ -1082,24 +1159,18 @@ namespace Alimer
         {
             if (newSize > _capacity)
             {
-                if (!_capacity)
+                uint32_t newCapacity = _capacity;
+                if (!newCapacity)
                 {
-                    _capacity = newSize;
+                    newCapacity = newSize;
                 }
                 else
                 {
-                    while (_capacity < newSize)
-                        _capacity += (_capacity + 1) >> 1;
+                    while (newCapacity < newSize)
+                        newCapacity += (newCapacity + 1) >> 1;
                 }
 
-                uint8_t* newBuffer = AllocateBuffer(_capacity * sizeof(T));
-                // Move the data into the new buffer and delete the old
-                if (_buffer)
-                {
-                    CopyElements(reinterpret_cast<T*>(newBuffer), Buffer(), _size);
-                    FreeBuffer(_buffer);
-                }
-                _buffer = newBuffer;
+                Reallocate(newCapacity);
             }
 
             _size = newSize;
@@ -1113,19 +1184,7 @@ namespace Alimer
 
             if (newCapacity != _capacity)
             {
-                uint8_t* newBuffer = nullptr;
-                _capacity = newCapacity;
-
-                if (_capacity)
-                {
-                    newBuffer = AllocateBuffer(_capacity * sizeof(T));
-                    // Move the data into the new buffer
-                    CopyElements(reinterpret_cast<T*>(newBuffer), Buffer(), _size);
-                }
-
-                // Delete the old buffer
-                FreeBuffer(_buffer);
-                _buffer = newBuffer;
+                Reallocate(newCapacity);
             }
         }
 
@@ -1197,6 +1256,13 @@ namespace Alimer
         T* Data() { return reinterpret_cast<T*>(_buffer); }
 
     private:
+        /// Resize the buffer keeping the elements, the allocator may grow it in place.
+        void Reallocate(uint32_t newCapacity)
+        {
+            _buffer = ReallocateBuffer(_capacity * sizeof(T), newCapacity * sizeof(T), alignof(T));
+            _capacity = newCapacity;
+        }
+
         /// Move a range of elements within the vector.
         void MoveRange(uint32_t dest, uint32_t src, uint32_t count)
         {
@@ -1212,6 +1278,9 @@ namespace Alimer
         }
     };
 
+    template <class T> struct IsRelocatable<Vector<T>> : std::true_type {};
+    template <class T> struct IsRelocatable<PODVector<T>> : std::true_type {};
+
     template <class T> typename Alimer::Vector<T>::ConstIterator begin(const Alimer::Vector<T>& v) { return v.Begin(); }
 
     template <class T> typename Alimer::Vector<T>::ConstIterator end(const Alimer::Vector<T>& v) { return v.End(); }
@@ -0,0 +1,229 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Core/EventBus.h"
+#include <algorithm>
+
+namespace Alimer
+{
+    constexpr uint32_t EventBus::RecordAlignment;
+    constexpr uint32_t EventBus::PaddingType;
+
+    uint32_t EventTypeId::Register()
+    {
+        static std::atomic<uint32_t> nextId{ 0 };
+        return nextId.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    EventBus::EventBus(uint32_t ringSize)
+        : _threadCount(JobSystem::GetInstance()->GetThreadCount())
+    {
+        // Power of two keeps positions wrapping with a mask.
+        _ringSize = 256;
+        while (_ringSize < ringSize)
+        {
+            _ringSize <<= 1;
+        }
+
+        _ringMask = _ringSize - 1;
+        _rings.reset(new Ring[_threadCount]);
+        for (uint32_t i = 0; i < _threadCount; ++i)
+        {
+            _rings[i].buffer.reset(new uint8_t[_ringSize]);
+        }
+    }
+
+    EventBus::~EventBus() = default;
+
+    void EventBus::PublishOverflow(Ring& ring, uint32_t type, const void* data, uint32_t size)
+    {
+        std::lock_guard<std::mutex> lock(ring.overflowMutex);
+        ring.overflowing.store(true, std::memory_order_relaxed);
+
+        const size_t offset = ring.overflow.size();
+        ring.overflow.resize(offset + GetRecordSize(size));
+        WriteHeader(ring.overflow.data() + offset, type, size);
+        memcpy(ring.overflow.data() + offset + sizeof(RecordHeader), data, size);
+        _overflowCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint32_t EventBus::Subscribe(uint32_t type, HandlerFunction function, void* userData)
+    {
+        ALIMER_ASSERT(function != nullptr);
+
+        return AddHandler(type, [](const Handler& handler, const void* events, uint32_t count)
+        {
+            reinterpret_cast<HandlerFunction>(handler.function)(handler.userData, events, count);
+        }, reinterpret_cast<GenericFunction>(function), userData);
+    }
+
+    uint32_t EventBus::AddHandler(uint32_t type, Invoker invoke, GenericFunction function, void* userData)
+    {
+        if (type >= _handlers.size())
+        {
+            _handlers.resize(type + 1);
+        }
+
+        const uint32_t handle = _nextHandle++;
+        _handlers[type].push_back({ invoke, function, userData, handle });
+        return handle;
+    }
+
+    void EventBus::Unsubscribe(uint32_t handle)
+    {
+        for (std::vector<Handler>& handlers : _handlers)
+        {
+            for (size_t i = 0; i < handlers.size(); ++i)
+            {
+                if (handlers[i].handle != handle)
+                    continue;
+
+                // Removal is deferred while handlers are being iterated.
+                if (_dispatching)
+                {
+                    handlers[i].invoke = nullptr;
+                    _handlersRemoved = true;
+                }
+                else
+                {
+                    handlers.erase(handlers.begin() + i);
+                }
+                return;
+            }
+        }
+    }
+
+    void EventBus::AppendRecords(const uint8_t* records, uint32_t size)
+    {
+        // Consecutive records usually share a type, the batch lookup is skipped for them.
+        uint32_t currentType = PaddingType;
+        Batch* batch = nullptr;
+
+        uint32_t position = 0;
+        while (position < size)
+        {
+            RecordHeader header;
+            memcpy(&header, records + position, sizeof(header));
+            const uint8_t* event = records + position + sizeof(RecordHeader);
+            position += GetRecordSize(header.size);
+            if (header.type == PaddingType)
+                continue;
+
+            if (header.type != currentType)
+            {
+                if (header.type >= _batches.size())
+                {
+                    _batches.resize(header.type + 1);
+                }
+
+                currentType = header.type;
+                batch = &_batches[currentType];
+                if (batch->count == 0)
+                {
+                    _pendingTypes.push_back(currentType);
+                    batch->eventSize = header.size;
+                }
+            }
+
+            ALIMER_ASSERT_MSG(batch->eventSize == header.size, "Event type %u published with sizes %u and %u", header.type, batch->eventSize, header.size);
+
+            // Storage only grows, it is reused by every dispatch.
+            const size_t offset = static_cast<size_t>(batch->count) * header.size;
+            if (offset + header.size > batch->data.size())
+            {
+                batch->data.resize(std::max(batch->data.size() * 2, offset + header.size));
+            }
+
+            memcpy(batch->data.data() + offset, event, header.size);
+            batch->count++;
+        }
+    }
+
+    void EventBus::DrainRing(Ring& ring)
+    {
+        const uint32_t head = ring.head.load(std::memory_order_acquire);
+        const uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+        if (head == tail)
+            return;
+
+        const uint32_t offset = tail & _ringMask;
+        const uint32_t size = head - tail;
+        const uint32_t first = std::min(size, _ringSize - offset);
+        AppendRecords(ring.buffer.get() + offset, first);
+        AppendRecords(ring.buffer.get(), size - first);
+        ring.tail.store(head, std::memory_order_release);
+    }
+
+    void EventBus::Dispatch()
+    {
+        ALIMER_ASSERT_MSG(!_dispatching, "%s", "EventBus::Dispatch is not reentrant");
+
+        // Gather events of every thread by type, the ring space is released before handlers run.
+        for (uint32_t i = 0; i < _threadCount; ++i)
+        {
+            Ring& ring = _rings[i];
+            DrainRing(ring);
+
+            if (ring.overflowing.load(std::memory_order_relaxed))
+            {
+                // Ring events published before the first spill are visible once the lock is held.
+                std::lock_guard<std::mutex> lock(ring.overflowMutex);
+                DrainRing(ring);
+                AppendRecords(ring.overflow.data(), static_cast<uint32_t>(ring.overflow.size()));
+                ring.overflow.clear();
+                ring.overflowing.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        _dispatching = true;
+        for (uint32_t type : _pendingTypes)
+        {
+            if (type < _handlers.size())
+            {
+                // Handlers subscribed during dispatch get the next batch, they may grow the handler lists.
+                const size_t handlerCount = _handlers[type].size();
+                for (size_t i = 0; i < handlerCount; ++i)
+                {
+                    const Handler handler = _handlers[type][i];
+                    if (handler.invoke)
+                    {
+                        handler.invoke(handler, _batches[type].data.data(), _batches[type].count);
+                    }
+                }
+            }
+
+            _batches[type].count = 0;
+        }
+
+        _pendingTypes.clear();
+        _dispatching = false;
+
+        if (_handlersRemoved)
+        {
+            for (std::vector<Handler>& handlers : _handlers)
+            {
+                handlers.erase(std::remove_if(handlers.begin(), handlers.end(), [](const Handler& handler) { return handler.invoke == nullptr; }), handlers.end());
+            }
+            _handlersRemoved = false;
+        }
+    }
+}
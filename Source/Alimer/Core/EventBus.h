@@ -0,0 +1,228 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Core/JobSystem.h"
+#include "../Debug/Debug.h"
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace Alimer
+{
+    /// Assigns a dense id to every event type published on an EventBus.
+    struct ALIMER_API EventTypeId
+    {
+    public:
+        template <typename T>
+        static uint32_t GetId()
+        {
+            static uint32_t id = Register();
+            return id;
+        }
+
+    private:
+        static uint32_t Register();
+    };
+
+    /// Deferred event queue for high frequency events, alternative to TEvent.
+    /// Threads publish plain data events into their own lock-free ring buffer, Dispatch delivers them at a sync point
+    /// to typed handlers, one call per handler with every event of a type. Use TEvent for immediate, infrequent events.
+    class ALIMER_API EventBus final
+    {
+    public:
+        /// Handler receiving a batch of events of one type.
+        using HandlerFunction = void(*)(void* userData, const void* events, uint32_t count);
+
+        /// Constructor, ringSize bytes are reserved for each JobSystem thread.
+        explicit EventBus(uint32_t ringSize = 64 * 1024);
+
+        /// Destructor, pending events are discarded.
+        ~EventBus();
+
+        /// Queue an event, callable from the main thread and JobSystem workers without locking.
+        template <typename T>
+        void Publish(const T& event)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Events must be trivially copyable");
+            static_assert(alignof(T) <= RecordAlignment, "Event alignment is not supported");
+            Publish(EventTypeId::GetId<T>(), &event, sizeof(T));
+        }
+
+        /// Queue an event of the given type id and size.
+        ALIMER_FORCE_INLINE void Publish(uint32_t type, const void* data, uint32_t size)
+        {
+            const uint32_t threadIndex = JobSystem::GetCurrentThreadIndex();
+            ALIMER_ASSERT_MSG(threadIndex < _threadCount, "Thread %u was not a JobSystem thread when the event bus was created", threadIndex);
+
+            Ring& ring = _rings[threadIndex];
+            const uint32_t recordSize = GetRecordSize(size);
+            const uint32_t head = ring.head.load(std::memory_order_relaxed);
+            const uint32_t offset = head & _ringMask;
+            const uint32_t contiguous = _ringSize - offset;
+            const uint32_t needed = contiguous < recordSize ? recordSize + contiguous : recordSize;
+
+            // Once events spill, keep spilling until Dispatch so the order of the thread is preserved.
+            if (ring.overflowing.load(std::memory_order_relaxed)
+                || head + needed - ring.tail.load(std::memory_order_acquire) > _ringSize)
+            {
+                PublishOverflow(ring, type, data, size);
+                return;
+            }
+
+            uint8_t* record = ring.buffer.get() + offset;
+            uint32_t newHead = head + recordSize;
+            if (contiguous < recordSize)
+            {
+                // Pad to the end of the buffer and wrap.
+                WriteHeader(record, PaddingType, contiguous - static_cast<uint32_t>(sizeof(RecordHeader)));
+                record = ring.buffer.get();
+                newHead += contiguous;
+            }
+
+            WriteHeader(record, type, size);
+            memcpy(record + sizeof(RecordHeader), data, size);
+            ring.head.store(newHead, std::memory_order_release);
+        }
+
+        /// Register a handler for events of type T, returns a handle for Unsubscribe.
+        template <typename T>
+        uint32_t Subscribe(void(*function)(void* userData, const T* events, uint32_t count), void* userData)
+        {
+            using TypedFunction = void(*)(void*, const T*, uint32_t);
+            return AddHandler(EventTypeId::GetId<T>(), [](const Handler& handler, const void* events, uint32_t count)
+            {
+                reinterpret_cast<TypedFunction>(handler.function)(handler.userData, static_cast<const T*>(events), count);
+            }, reinterpret_cast<GenericFunction>(function), userData);
+        }
+
+        /// Register member function (instance->*Method)(const T* events, uint32_t count), invoked without indirection through std::function.
+        template <typename T, typename Class, void(Class::*Method)(const T*, uint32_t)>
+        uint32_t Subscribe(Class* instance)
+        {
+            return AddHandler(EventTypeId::GetId<T>(), [](const Handler& handler, const void* events, uint32_t count)
+            {
+                (static_cast<Class*>(handler.userData)->*Method)(static_cast<const T*>(events), count);
+            }, nullptr, instance);
+        }
+
+        /// Register a handler for the given event type id.
+        uint32_t Subscribe(uint32_t type, HandlerFunction function, void* userData);
+
+        /// Remove a handler, may be called from a handler during Dispatch.
+        void Unsubscribe(uint32_t handle);
+
+        /// Deliver queued events grouped by type, must be called from one thread at a time.
+        /// Events of one type keep the publishing order of each thread, threads are delivered in index order.
+        /// Events published by handlers are delivered on the next Dispatch.
+        void Dispatch();
+
+        /// Return number of events that did not fit a ring buffer and were queued under a lock since creation.
+        uint32_t GetOverflowCount() const { return _overflowCount.load(std::memory_order_relaxed); }
+
+    private:
+        /// Record is the header followed by the event, padded to RecordAlignment.
+        struct RecordHeader
+        {
+            uint32_t type;
+            /// Size of the event.
+            uint32_t size;
+        };
+
+        static constexpr uint32_t RecordAlignment = 8;
+        static constexpr uint32_t PaddingType = ~0u;
+
+        static uint32_t GetRecordSize(uint32_t size)
+        {
+            return (static_cast<uint32_t>(sizeof(RecordHeader)) + size + RecordAlignment - 1) & ~(RecordAlignment - 1);
+        }
+
+        static void WriteHeader(uint8_t* record, uint32_t type, uint32_t size)
+        {
+            const RecordHeader header = { type, size };
+            memcpy(record, &header, sizeof(header));
+        }
+
+        /// Single producer, single consumer ring of event records, the publishing thread owns head.
+        /// Padded so head, tail and the neighbouring rings do not share cache lines.
+        struct Ring
+        {
+            std::unique_ptr<uint8_t[]> buffer;
+            std::atomic<uint32_t> head{ 0 };
+            uint8_t headPadding[ALIMER_CACHE_LINE_SIZE];
+            std::atomic<uint32_t> tail{ 0 };
+            std::atomic<bool> overflowing{ false };
+            std::mutex overflowMutex;
+            std::vector<uint8_t> overflow;
+            uint8_t padding[ALIMER_CACHE_LINE_SIZE];
+        };
+
+        /// Function pointer type the subscribed function is stored as, cast back to its own type before the call.
+        using GenericFunction = void(*)();
+
+        struct Handler;
+        /// Calls the subscribed function of a handler with a batch of events, null once the handler was removed.
+        using Invoker = void(*)(const Handler& handler, const void* events, uint32_t count);
+
+        struct Handler
+        {
+            Invoker invoke;
+            GenericFunction function;
+            void* userData;
+            uint32_t handle;
+        };
+
+        uint32_t AddHandler(uint32_t type, Invoker invoke, GenericFunction function, void* userData);
+
+        void PublishOverflow(Ring& ring, uint32_t type, const void* data, uint32_t size);
+        void DrainRing(Ring& ring);
+        void AppendRecords(const uint8_t* records, uint32_t size);
+
+        uint32_t _threadCount;
+        uint32_t _ringSize;
+        uint32_t _ringMask;
+        std::unique_ptr<Ring[]> _rings;
+        std::atomic<uint32_t> _overflowCount{ 0 };
+
+        /// Events of one type gathered from every thread, in a contiguous array.
+        struct Batch
+        {
+            std::vector<uint8_t> data;
+            uint32_t count = 0;
+            uint32_t eventSize = 0;
+        };
+
+        /// Handlers and gathered events by type id.
+        std::vector<std::vector<Handler>> _handlers;
+        std::vector<Batch> _batches;
+        std::vector<uint32_t> _pendingTypes;
+        uint32_t _nextHandle = 1;
+        bool _dispatching = false;
+        bool _handlersRemoved = false;
+
+        DISALLOW_COPY_MOVE_AND_ASSIGN(EventBus);
+    };
+}
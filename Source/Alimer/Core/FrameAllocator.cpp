@@ -0,0 +1,268 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Core/FrameAllocator.h"
+#include "../Core/JobSystem.h"
+#include "../Debug/Debug.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace Alimer
+{
+    constexpr uint32_t FrameAllocator::MaxFrameCount;
+
+    /// Byte pattern written over released frame memory in debug builds, so use after the frame shows up as garbage.
+    static const int FramePoison = 0xCD;
+    /// Block size of the per-thread scratch arenas.
+    static const size_t ScratchBlockSize = 256 * 1024;
+
+    FrameAllocator::FrameAllocator(uint32_t frameCount, size_t pageSize)
+        : _frameCount(std::max(1u, std::min(frameCount, MaxFrameCount)))
+        , _threadCount(JobSystem::GetInstance()->GetThreadCount())
+        , _pageSize(pageSize)
+        , _regions(_frameCount * _threadCount)
+    {
+    }
+
+    FrameAllocator::~FrameAllocator()
+    {
+        for (Region& region : _regions)
+        {
+            ReleaseRegion(region);
+        }
+
+        while (_freePages)
+        {
+            Page* next = _freePages->next;
+            free(_freePages);
+            _freePages = next;
+        }
+    }
+
+    void FrameAllocator::BeginFrame()
+    {
+        // Count the frame that just ended.
+        Region* regions = &_regions[_currentFrame * _threadCount];
+        size_t frameSize = 0;
+        uint32_t overflowCount = 0;
+        for (uint32_t i = 0; i < _threadCount; ++i)
+        {
+            Region& region = regions[i];
+            if (region.pages)
+            {
+                frameSize += region.usedSize + static_cast<size_t>(region.top - reinterpret_cast<uint8_t*>(region.pages + 1));
+                overflowCount += region.pageCount - 1;
+            }
+        }
+
+        _statistics.frameSize = frameSize;
+        _statistics.highWaterMark = std::max(_statistics.highWaterMark, frameSize);
+        _statistics.overflowCount = overflowCount;
+
+        // The oldest frame is reused.
+        _frameIndex++;
+        _currentFrame = static_cast<uint32_t>(_frameIndex % _frameCount);
+        regions = &_regions[_currentFrame * _threadCount];
+        for (uint32_t i = 0; i < _threadCount; ++i)
+        {
+            ReleaseRegion(regions[i]);
+        }
+
+        _statistics.pageCount = _pageCount;
+    }
+
+    void* FrameAllocator::Allocate(size_t size, size_t alignment)
+    {
+        Region& region = GetRegion();
+        uint8_t* result = AlignUp(region.top, alignment);
+        if (region.pages == nullptr || result + size > region.end)
+        {
+            AddPage(region, size, alignment);
+            result = AlignUp(region.top, alignment);
+        }
+
+        region.last = result;
+        region.top = result + size;
+        return result;
+    }
+
+    void* FrameAllocator::Reallocate(void* ptr, size_t oldSize, size_t newSize, size_t alignment)
+    {
+        Region& region = GetRegion();
+        if (ptr != nullptr && ptr == region.last && region.last + newSize <= region.end)
+        {
+            region.top = region.last + newSize;
+            return ptr;
+        }
+
+        void* newPtr = newSize ? Allocate(newSize, alignment) : nullptr;
+        if (ptr && newPtr)
+        {
+            memcpy(newPtr, ptr, std::min(oldSize, newSize));
+        }
+
+        return newPtr;
+    }
+
+    void FrameAllocator::Free(void* ptr, size_t size)
+    {
+        ALIMER_UNUSED(size);
+        Region& region = GetRegion();
+        if (ptr != nullptr && ptr == region.last)
+        {
+            region.top = region.last;
+            region.last = nullptr;
+        }
+    }
+
+    FrameAllocator::Region& FrameAllocator::GetRegion()
+    {
+        const uint32_t threadIndex = JobSystem::GetCurrentThreadIndex();
+        ALIMER_ASSERT_MSG(threadIndex < _threadCount, "Thread %u was not a JobSystem thread when the frame allocator was created", threadIndex);
+        return _regions[_currentFrame * _threadCount + threadIndex];
+    }
+
+    void FrameAllocator::AddPage(Region& region, size_t size, size_t alignment)
+    {
+        const size_t pageSize = std::max(_pageSize, sizeof(Page) + size + alignment);
+        Page* page = nullptr;
+        if (pageSize == _pageSize)
+        {
+            std::lock_guard<std::mutex> lock(_poolMutex);
+            if (_freePages)
+            {
+                page = _freePages;
+                _freePages = page->next;
+            }
+            else
+            {
+                _pageCount++;
+            }
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(_poolMutex);
+            _pageCount++;
+        }
+
+        if (page == nullptr)
+        {
+            page = static_cast<Page*>(malloc(pageSize));
+            ALIMER_ASSERT_MSG(page != nullptr, "Frame allocator out of memory, %u bytes requested", static_cast<uint32_t>(pageSize));
+            page->size = pageSize;
+        }
+
+        if (region.pages)
+        {
+            region.usedSize += static_cast<size_t>(region.top - reinterpret_cast<uint8_t*>(region.pages + 1));
+        }
+
+        page->next = region.pages;
+        region.pages = page;
+        region.pageCount++;
+        region.top = reinterpret_cast<uint8_t*>(page + 1);
+        region.end = reinterpret_cast<uint8_t*>(page) + pageSize;
+        region.last = nullptr;
+    }
+
+    void FrameAllocator::ReleaseRegion(Region& region)
+    {
+        Page* page = region.pages;
+        while (page)
+        {
+            Page* next = page->next;
+#ifndef NDEBUG
+            // Only the current page is partially used.
+            uint8_t* used = page == region.pages ? region.top : reinterpret_cast<uint8_t*>(page) + page->size;
+            memset(page + 1, FramePoison, static_cast<size_t>(used - reinterpret_cast<uint8_t*>(page + 1)));
+#endif
+            std::lock_guard<std::mutex> lock(_poolMutex);
+            if (page->size == _pageSize)
+            {
+                page->next = _freePages;
+                _freePages = page;
+            }
+            else
+            {
+                free(page);
+                _pageCount--;
+            }
+
+            page = next;
+        }
+
+        region.top = nullptr;
+        region.end = nullptr;
+        region.last = nullptr;
+        region.pages = nullptr;
+        region.usedSize = 0;
+        region.pageCount = 0;
+    }
+
+    uint8_t* FrameAllocator::AlignUp(uint8_t* ptr, size_t alignment)
+    {
+        ALIMER_ASSERT((alignment & (alignment - 1)) == 0);
+        return reinterpret_cast<uint8_t*>((reinterpret_cast<uintptr_t>(ptr) + alignment - 1) & ~(alignment - 1));
+    }
+
+    /// Innermost scratch scope of the calling thread.
+    static thread_local ScratchScope* s_scratchScope = nullptr;
+
+    static ArenaAllocator& GetScratchArena()
+    {
+        static thread_local ArenaAllocator arena(ScratchBlockSize);
+        return arena;
+    }
+
+    ScratchScope::ScratchScope()
+        : _arena(GetScratchArena())
+        , _marker(_arena.GetMarker())
+        , _parent(s_scratchScope)
+    {
+        s_scratchScope = this;
+    }
+
+    ScratchScope::~ScratchScope()
+    {
+        ALIMER_ASSERT_MSG(s_scratchScope == this, "Scratch scope %p destroyed out of order", static_cast<void*>(this));
+        _arena.Rewind(_marker);
+        s_scratchScope = _parent;
+    }
+
+    void* ScratchScope::Allocate(size_t size, size_t alignment)
+    {
+        ALIMER_ASSERT_MSG(s_scratchScope == this, "Scratch scope %p allocates while a nested scope is active", static_cast<void*>(this));
+        return _arena.Allocate(size, alignment);
+    }
+
+    void* ScratchScope::Reallocate(void* ptr, size_t oldSize, size_t newSize, size_t alignment)
+    {
+        ALIMER_ASSERT_MSG(s_scratchScope == this, "Scratch scope %p allocates while a nested scope is active", static_cast<void*>(this));
+        return _arena.Reallocate(ptr, oldSize, newSize, alignment);
+    }
+
+    void ScratchScope::Free(void* ptr, size_t size)
+    {
+        _arena.Free(ptr, size);
+    }
+}
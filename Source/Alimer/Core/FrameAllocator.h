@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Base/Allocator.h"
+#include <mutex>
+#include <vector>
+
+namespace Alimer
+{
+    /// Frame allocator usage counters.
+    struct FrameAllocatorStatistics
+    {
+        /// Bytes allocated in the last completed frame.
+        size_t frameSize = 0;
+        /// Largest frameSize seen.
+        size_t highWaterMark = 0;
+        /// Pages owned, in use or pooled.
+        uint32_t pageCount = 0;
+        /// Pages taken beyond the first of a thread in the last completed frame.
+        uint32_t overflowCount = 0;
+    };
+
+    /// Linear allocator for memory that lives for a few frames, such as per-frame lists and commands.
+    /// Each JobSystem thread bumps its own region without locking, full regions chain a new page from a shared pool.
+    /// Memory allocated during a frame stays valid until BeginFrame has been called frameCount more times.
+    class ALIMER_API FrameAllocator final : public Allocator
+    {
+    public:
+        /// Maximum number of frames in flight.
+        static constexpr uint32_t MaxFrameCount = 3;
+
+        /// Construct with the number of frames memory stays valid, 2 for double and 3 for triple buffering.
+        explicit FrameAllocator(uint32_t frameCount = 2, size_t pageSize = 256 * 1024);
+
+        /// Destruct, releasing all pages.
+        ~FrameAllocator() override;
+
+        /// Start a new frame and release the memory of the frame allocated frameCount frames ago.
+        /// Call from the main thread while no other thread allocates.
+        void BeginFrame();
+
+        /// Allocate from the region of the calling thread, which must be the main thread or a JobSystem worker.
+        void* Allocate(size_t size, size_t alignment) override;
+        /// Resizes the latest allocation of the calling thread in place when it fits.
+        void* Reallocate(void* ptr, size_t oldSize, size_t newSize, size_t alignment) override;
+        /// Only the latest allocation of the calling thread is released, everything else at the end of its frame.
+        void Free(void* ptr, size_t size) override;
+
+        /// Return the number of frames memory stays valid.
+        uint32_t GetFrameCount() const { return _frameCount; }
+
+        /// Return the number of BeginFrame calls.
+        uint64_t GetFrameIndex() const { return _frameIndex; }
+
+        /// Return usage counters, updated by BeginFrame.
+        const FrameAllocatorStatistics& GetStatistics() const { return _statistics; }
+
+    private:
+        struct Page
+        {
+            Page* next;
+            size_t size;
+        };
+
+        /// Bump region of one thread in one frame, padded so regions of different threads do not share cache lines.
+        struct Region
+        {
+            uint8_t* top = nullptr;
+            uint8_t* end = nullptr;
+            /// Start of the latest allocation.
+            uint8_t* last = nullptr;
+            /// Pages of the region, current one first.
+            Page* pages = nullptr;
+            /// Bytes used in pages before the current one.
+            size_t usedSize = 0;
+            uint32_t pageCount = 0;
+            uint8_t padding[128 - 5 * sizeof(void*) - sizeof(uint32_t)];
+        };
+
+        Region& GetRegion();
+        void AddPage(Region& region, size_t size, size_t alignment);
+        void ReleaseRegion(Region& region);
+        static uint8_t* AlignUp(uint8_t* ptr, size_t alignment);
+
+        uint32_t _frameCount;
+        uint32_t _threadCount;
+        size_t _pageSize;
+        uint64_t _frameIndex = 0;
+        /// Regions of the current frame start at _currentFrame * _threadCount.
+        uint32_t _currentFrame = 0;
+        std::vector<Region> _regions;
+
+        /// Pages of the standard size not used by any region.
+        std::mutex _poolMutex;
+        Page* _freePages = nullptr;
+        uint32_t _pageCount = 0;
+
+        FrameAllocatorStatistics _statistics;
+
+    private:
+        DISALLOW_COPY_MOVE_AND_ASSIGN(FrameAllocator);
+    };
+
+    /// Temporary memory from an arena owned by the calling thread, released when the scope ends.
+    /// Scopes nest and only the innermost one may allocate. Containers using it must be destroyed before it.
+    class ALIMER_API ScratchScope final : public Allocator
+    {
+    public:
+        /// Construct, remembering the arena position of the calling thread.
+        ScratchScope();
+
+        /// Destruct, rewinding the arena.
+        ~ScratchScope() override;
+
+        void* Allocate(size_t size, size_t alignment) override;
+        void* Reallocate(void* ptr, size_t oldSize, size_t newSize, size_t alignment) override;
+        void Free(void* ptr, size_t size) override;
+
+    private:
+        ArenaAllocator& _arena;
+        ArenaAllocator::Marker _marker;
+        ScratchScope* _parent;
+
+    private:
+        DISALLOW_COPY_MOVE_AND_ASSIGN(ScratchScope);
+    };
+}
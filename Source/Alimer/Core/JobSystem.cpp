@@ -0,0 +1,469 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Core/JobSystem.h"
+#include "../Core/Platform.h"
+#include "../Debug/Debug.h"
+#include <algorithm>
+#include <string>
+
+namespace Alimer
+{
+    JobSystem *JobSystem::_instance = nullptr;
+    constexpr uint32_t JobSystem::InvalidThreadIndex;
+    static thread_local uint32_t s_threadIndex = JobSystem::InvalidThreadIndex;
+
+    /// Failed polls before an idle worker goes to sleep.
+    static constexpr uint32_t IdleSpinCount = 64;
+
+    JobSystem* JobSystem::GetInstance()
+    {
+        if (!_instance)
+        {
+#ifdef ALIMER_THREADING
+            const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            _instance = new JobSystem(hardwareThreads > 1 ? hardwareThreads - 1 : 0);
+#else
+            _instance = new JobSystem(0);
+#endif
+        }
+
+        return _instance;
+    }
+
+    void JobSystem::Shutdown()
+    {
+        delete _instance;
+        _instance = nullptr;
+    }
+
+    uint32_t JobSystem::GetCurrentThreadIndex()
+    {
+        return s_threadIndex;
+    }
+
+    JobSystem::JobSystem(uint32_t workerCount)
+        : _threadCount(workerCount + 1)
+        , _queues(new WorkQueue[workerCount + 1])
+        , _mainThread(std::this_thread::get_id())
+    {
+        s_threadIndex = 0;
+        _workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; ++i)
+        {
+            _workers.emplace_back(&JobSystem::WorkerMain, this, i + 1);
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _shutdown = true;
+        }
+
+        _wakeCondition.notify_all();
+        for (std::thread& worker : _workers)
+        {
+            worker.join();
+        }
+
+        if (IsMainThread())
+        {
+            s_threadIndex = InvalidThreadIndex;
+        }
+    }
+
+    void JobSystem::Schedule(JobFunction function, void* data, JobCounter* counter, JobPriority priority)
+    {
+        ALIMER_ASSERT_MSG(s_threadIndex < _threadCount, "%s", "Jobs can only be scheduled from job system threads");
+
+        if (counter)
+        {
+            counter->_value.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (_threadCount == 1)
+        {
+            Execute({ function, data, counter }, s_threadIndex);
+            return;
+        }
+
+        Push(s_threadIndex, { function, data, counter }, priority);
+    }
+
+    void JobSystem::ScheduleOnOtherThread(JobFunction function, void* data, JobCounter* counter, JobPriority priority)
+    {
+        ALIMER_ASSERT_MSG(s_threadIndex < _threadCount, "%s", "Jobs can only be scheduled from job system threads");
+
+        if (counter)
+        {
+            counter->_value.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (_threadCount == 1)
+        {
+            Execute({ function, data, counter }, s_threadIndex);
+            return;
+        }
+
+        // Any queue but the one of the caller, the caller still skips the job when stealing.
+        const uint32_t offset = _nextWorker.fetch_add(1, std::memory_order_relaxed) % (_threadCount - 1);
+        Push((s_threadIndex + 1 + offset) % _threadCount, { function, data, counter, s_threadIndex }, priority);
+    }
+
+    void JobSystem::Push(uint32_t queueIndex, const Job& job, JobPriority priority)
+    {
+        // Pairs with the sleeping worker count increment, either the worker sees the job or we see the worker.
+        _queuedJobs.fetch_add(1);
+
+        WorkQueue& queue = _queues[queueIndex];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs[static_cast<uint32_t>(priority)].push_back(job);
+        }
+
+        if (_sleepingWorkers.load() != 0)
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _wakeCondition.notify_one();
+        }
+    }
+
+    void JobSystem::ScheduleOnMainThread(JobFunction function, void* data, JobCounter* counter)
+    {
+        if (counter)
+        {
+            counter->_value.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::lock_guard<std::mutex> lock(_mainThreadMutex);
+        _mainThreadJobs.push_back({ function, data, counter });
+    }
+
+    void JobSystem::RunMainThreadJobs()
+    {
+        ALIMER_ASSERT_MSG(IsMainThread(), "%s", "Main thread jobs must be run from the main thread");
+
+        Job job;
+        while (PopMainThreadJob(job))
+        {
+            Execute(job, s_threadIndex);
+        }
+    }
+
+    void JobSystem::Wait(const JobCounter& counter)
+    {
+        const uint32_t threadIndex = s_threadIndex;
+        ALIMER_ASSERT_MSG(threadIndex < _threadCount, "%s", "Only job system threads can wait for jobs");
+
+        const bool mainThread = IsMainThread();
+        while (!counter.IsDone())
+        {
+            Job job;
+            if (mainThread && PopMainThreadJob(job))
+            {
+                Execute(job, threadIndex);
+            }
+            else if (!TryExecuteJob(threadIndex))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    bool JobSystem::PopJob(uint32_t threadIndex, Job& job)
+    {
+        if (_queuedJobs.load(std::memory_order_relaxed) == 0)
+            return false;
+
+        const uint32_t queueCount = GetThreadCount();
+        for (uint32_t priority = 0; priority < static_cast<uint32_t>(JobPriority::Count); ++priority)
+        {
+            // Own queue first, newest job is the most likely to be in cache.
+            {
+                WorkQueue& queue = _queues[threadIndex];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (TakeJob(queue.jobs[priority], true, threadIndex, job))
+                {
+                    _queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+
+            // Steal the oldest job of another queue, starting from the next one to spread thieves.
+            for (uint32_t i = 1; i < queueCount; ++i)
+            {
+                WorkQueue& queue = _queues[(threadIndex + i) % queueCount];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (TakeJob(queue.jobs[priority], false, threadIndex, job))
+                {
+                    _queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    bool JobSystem::TakeJob(std::deque<Job>& jobs, bool newest, uint32_t threadIndex, Job& job)
+    {
+        // Excluded jobs are rare, the first candidate is almost always taken.
+        for (size_t i = 0, count = jobs.size(); i < count; ++i)
+        {
+            const size_t index = newest ? count - 1 - i : i;
+            if (jobs[index].excludedThread != threadIndex)
+            {
+                job = jobs[index];
+                jobs.erase(jobs.begin() + index);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool JobSystem::PopMainThreadJob(Job& job)
+    {
+        std::lock_guard<std::mutex> lock(_mainThreadMutex);
+        if (_mainThreadJobs.empty())
+            return false;
+
+        job = _mainThreadJobs.front();
+        _mainThreadJobs.pop_front();
+        return true;
+    }
+
+    bool JobSystem::TryExecuteJob(uint32_t threadIndex)
+    {
+        Job job;
+        if (!PopJob(threadIndex, job))
+            return false;
+
+        Execute(job, threadIndex);
+        return true;
+    }
+
+    void JobSystem::Execute(const Job& job, uint32_t threadIndex)
+    {
+        job.function(job.data, threadIndex);
+        if (job.counter)
+        {
+            job.counter->_value.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    void JobSystem::WorkerMain(uint32_t threadIndex)
+    {
+        s_threadIndex = threadIndex;
+        SetCurrentThreadName(("Worker " + std::to_string(threadIndex)).c_str());
+
+        uint32_t idleCount = 0;
+        for (;;)
+        {
+            if (TryExecuteJob(threadIndex))
+            {
+                idleCount = 0;
+                continue;
+            }
+
+            if (++idleCount < IdleSpinCount)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _sleepingWorkers.fetch_add(1);
+            _wakeCondition.wait(lock, [this] { return _shutdown || _queuedJobs.load() != 0; });
+            _sleepingWorkers.fetch_sub(1);
+            if (_shutdown && _queuedJobs.load() == 0)
+                return;
+
+            idleCount = 0;
+        }
+    }
+
+    namespace
+    {
+        struct ParallelForContext
+        {
+            void(*invoke)(void*, uint32_t, uint32_t);
+            void* context;
+            uint32_t count;
+            uint32_t grainSize;
+            uint32_t divisor;
+            std::atomic<uint32_t> next;
+
+            void Run()
+            {
+                // Guided scheduling: take a share of the remaining work, so few atomics are needed at the start
+                // and small ranges at the end balance the load. Sizes are whole grains, ranges start on grain boundaries.
+                uint32_t begin = next.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    uint32_t size;
+                    do
+                    {
+                        if (begin >= count)
+                            return;
+
+                        const uint32_t remaining = count - begin;
+                        size = std::max(grainSize, remaining / divisor);
+                        size = std::min((size + grainSize - 1) / grainSize * grainSize, remaining);
+                    } while (!next.compare_exchange_weak(begin, begin + size, std::memory_order_relaxed));
+
+                    invoke(context, begin, begin + size);
+                    begin += size;
+                }
+            }
+        };
+    }
+
+    void JobSystem::ParallelForImpl(uint32_t count, uint32_t grainSize, void(*invoke)(void*, uint32_t, uint32_t), void* context)
+    {
+        if (count == 0)
+            return;
+
+        const uint32_t threadCount = GetThreadCount();
+        if (grainSize == 0)
+        {
+            grainSize = std::max(count / (threadCount * 8), 1u);
+        }
+
+        const uint32_t batchCount = (count + grainSize - 1) / grainSize;
+        const uint32_t helperCount = std::min(threadCount - 1, batchCount - 1);
+        if (helperCount == 0)
+        {
+            invoke(context, 0, count);
+            return;
+        }
+
+        ParallelForContext parallelContext;
+        parallelContext.invoke = invoke;
+        parallelContext.context = context;
+        parallelContext.count = count;
+        parallelContext.grainSize = grainSize;
+        parallelContext.divisor = (helperCount + 1) * 2;
+        parallelContext.next.store(0, std::memory_order_relaxed);
+
+        JobCounter counter;
+        for (uint32_t i = 0; i < helperCount; ++i)
+        {
+            Schedule([](void* data, uint32_t)
+            {
+                static_cast<ParallelForContext*>(data)->Run();
+            }, &parallelContext, &counter, JobPriority::High);
+        }
+
+        parallelContext.Run();
+
+        // Help executing pending jobs until every helper is done with the shared context.
+        Wait(counter);
+    }
+
+    uint32_t JobGraph::AddJob(JobSystem::JobFunction function, void* data, JobPriority priority)
+    {
+        _nodes.emplace_back();
+        Node& node = _nodes.back();
+        node.graph = this;
+        node.function = function;
+        node.data = data;
+        node.priority = priority;
+        node.dependencyCount = 0;
+        return static_cast<uint32_t>(_nodes.size() - 1);
+    }
+
+    void JobGraph::AddDependency(uint32_t before, uint32_t after)
+    {
+        ALIMER_ASSERT(before < _nodes.size() && after < _nodes.size() && before != after);
+
+        _nodes[before].successors.push_back(after);
+        _nodes[after].dependencyCount++;
+    }
+
+    void JobGraph::Run()
+    {
+#ifndef NDEBUG
+        // Every job must be reachable in topological order, a cycle would never complete.
+        {
+            std::vector<uint32_t> pending(_nodes.size());
+            std::vector<uint32_t> ready;
+            for (uint32_t i = 0; i < _nodes.size(); ++i)
+            {
+                pending[i] = _nodes[i].dependencyCount;
+                if (pending[i] == 0)
+                    ready.push_back(i);
+            }
+
+            size_t visited = 0;
+            while (!ready.empty())
+            {
+                const uint32_t index = ready.back();
+                ready.pop_back();
+                visited++;
+                for (uint32_t successor : _nodes[index].successors)
+                {
+                    if (--pending[successor] == 0)
+                        ready.push_back(successor);
+                }
+            }
+
+            ALIMER_ASSERT_MSG(visited == _nodes.size(), "%s", "Job graph contains a dependency cycle");
+        }
+#endif
+
+        for (Node& node : _nodes)
+        {
+            node.pendingDependencies.store(node.dependencyCount, std::memory_order_relaxed);
+        }
+
+        JobSystem* jobSystem = JobSystem::GetInstance();
+        for (Node& node : _nodes)
+        {
+            if (node.dependencyCount == 0)
+            {
+                jobSystem->Schedule(RunNode, &node, &_counter, node.priority);
+            }
+        }
+
+        jobSystem->Wait(_counter);
+    }
+
+    void JobGraph::RunNode(void* data, uint32_t threadIndex)
+    {
+        Node* node = static_cast<Node*>(data);
+        node->function(node->data, threadIndex);
+
+        // Successors are scheduled before this job completes, so the counter cannot reach zero early.
+        JobGraph* graph = node->graph;
+        for (uint32_t successor : node->successors)
+        {
+            Node& next = graph->_nodes[successor];
+            if (next.pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                JobSystem::GetInstance()->Schedule(RunNode, &next, &graph->_counter, next.priority);
+            }
+        }
+    }
+}
@@ -0,0 +1,262 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "AlimerConfig.h"
+#include "../Debug/Debug.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Alimer
+{
+    /// Job priority, higher priority jobs are picked first by every thread.
+    enum class JobPriority : uint32_t
+    {
+        High,
+        Normal,
+        Low,
+        Count
+    };
+
+    /// Counter of jobs in flight, incremented when a job is scheduled and decremented once it completes.
+    class JobCounter final
+    {
+    public:
+        JobCounter() = default;
+
+        /// Return whether every job associated with the counter has completed.
+        bool IsDone() const { return _value.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> _value{ 0 };
+
+        DISALLOW_COPY_MOVE_AND_ASSIGN(JobCounter);
+    };
+
+    /// Pool of worker threads executing jobs.
+    /// Each thread owns a queue it pushes to and pops from (newest first), idle threads steal the oldest jobs of other queues.
+    class ALIMER_API JobSystem final
+    {
+    public:
+        /// Job entry point, receives the user data and the index of the executing thread.
+        using JobFunction = void(*)(void* data, uint32_t threadIndex);
+
+        /// Thread index of threads that do not belong to the job system.
+        static constexpr uint32_t InvalidThreadIndex = 0xFFFFFFFFu;
+
+        /// Returns the job system instance, creating it on first use.
+        static JobSystem* GetInstance();
+
+        /// Shutdown the job system, waiting for workers to exit.
+        static void Shutdown();
+
+        /// Number of threads executing jobs, including the non worker (main) thread.
+        uint32_t GetThreadCount() const { return _threadCount; }
+
+        /// Index of the calling thread in [0, GetThreadCount()), 0 for the thread that created the job system.
+        /// Other threads get InvalidThreadIndex and must not schedule, wait or use per-thread storage.
+        static uint32_t GetCurrentThreadIndex();
+
+        /// Return whether the calling thread is the thread that created the job system.
+        bool IsMainThread() const { return std::this_thread::get_id() == _mainThread; }
+
+        /// Queue a job on the queue of the calling thread, counter is decremented once the job has completed.
+        void Schedule(JobFunction function, void* data, JobCounter* counter = nullptr, JobPriority priority = JobPriority::Normal);
+
+        /// Queue a job the calling thread never executes, not even while it waits, for long jobs that must overlap the caller.
+        /// Queues rotate between the other threads, the job runs immediately when there are none.
+        void ScheduleOnOtherThread(JobFunction function, void* data, JobCounter* counter = nullptr, JobPriority priority = JobPriority::Normal);
+
+        /// Queue a job that is only executed by the main thread, in RunMainThreadJobs or while it waits.
+        void ScheduleOnMainThread(JobFunction function, void* data, JobCounter* counter = nullptr);
+
+        /// Execute jobs queued for the main thread, must be called from the main thread.
+        void RunMainThreadJobs();
+
+        /// Wait until every job of the counter has completed, the calling thread executes pending jobs meanwhile.
+        void Wait(const JobCounter& counter);
+
+        /// Run function(begin, end) over [0, count) in ranges of whole grains, the calling thread executes ranges as well.
+        /// Every range begins on a multiple of grainSize and only the last one may end short of a grain boundary.
+        /// Ranges start large and shrink towards grainSize as work runs out. Returns once all ranges have completed.
+        template <typename Func>
+        void ParallelFor(uint32_t count, uint32_t grainSize, Func&& function)
+        {
+            using FunctionType = typename std::remove_reference<Func>::type;
+            ParallelForImpl(count, grainSize, [](void* context, uint32_t begin, uint32_t end)
+            {
+                (*static_cast<FunctionType*>(context))(begin, end);
+            }, &function);
+        }
+
+        /// Run function(begin, end) over [0, count) with a grain size derived from the thread count.
+        template <typename Func>
+        void ParallelFor(uint32_t count, Func&& function)
+        {
+            ParallelFor(count, 0, std::forward<Func>(function));
+        }
+
+    private:
+        /// Constructor.
+        explicit JobSystem(uint32_t workerCount);
+        /// Destructor.
+        ~JobSystem();
+
+        struct Job
+        {
+            JobFunction function;
+            void* data;
+            JobCounter* counter;
+            /// Thread that must not execute the job.
+            uint32_t excludedThread = InvalidThreadIndex;
+        };
+
+        /// Jobs pushed by one thread, padded to avoid false sharing with neighbouring queues.
+        struct WorkQueue
+        {
+            std::mutex mutex;
+            std::deque<Job> jobs[static_cast<uint32_t>(JobPriority::Count)];
+            uint8_t padding[ALIMER_CACHE_LINE_SIZE];
+        };
+
+        void ParallelForImpl(uint32_t count, uint32_t grainSize, void(*invoke)(void*, uint32_t, uint32_t), void* context);
+        void Push(uint32_t queueIndex, const Job& job, JobPriority priority);
+        void WorkerMain(uint32_t threadIndex);
+        bool PopJob(uint32_t threadIndex, Job& job);
+        static bool TakeJob(std::deque<Job>& jobs, bool newest, uint32_t threadIndex, Job& job);
+        bool PopMainThreadJob(Job& job);
+        bool TryExecuteJob(uint32_t threadIndex);
+        void Execute(const Job& job, uint32_t threadIndex);
+
+        static JobSystem *_instance;
+
+        /// Fixed before workers start, they read it while the worker list is being filled.
+        uint32_t _threadCount;
+        std::vector<std::thread> _workers;
+        std::unique_ptr<WorkQueue[]> _queues;
+        std::atomic<uint32_t> _nextWorker{ 0 };
+        std::deque<Job> _mainThreadJobs;
+        std::mutex _mainThreadMutex;
+        std::thread::id _mainThread;
+
+        /// Jobs queued and not yet picked by any thread, lets idle workers go to sleep.
+        std::atomic<uint32_t> _queuedJobs{ 0 };
+        std::atomic<uint32_t> _sleepingWorkers{ 0 };
+        std::mutex _sleepMutex;
+        std::condition_variable _wakeCondition;
+        bool _shutdown = false;
+
+        DISALLOW_COPY_MOVE_AND_ASSIGN(JobSystem);
+    };
+
+    /// Graph of jobs with dependencies, a job starts once every job it depends on has completed.
+    class ALIMER_API JobGraph final
+    {
+    public:
+        /// Constructor.
+        JobGraph() = default;
+
+        /// Add a job and return its index.
+        uint32_t AddJob(JobSystem::JobFunction function, void* data, JobPriority priority = JobPriority::Normal);
+
+        /// Make the job after start only once the job before has completed.
+        void AddDependency(uint32_t before, uint32_t after);
+
+        /// Get number of jobs.
+        uint32_t GetJobCount() const { return static_cast<uint32_t>(_nodes.size()); }
+
+        /// Remove all jobs.
+        void Clear() { _nodes.clear(); }
+
+        /// Schedule the jobs without dependencies and wait until the whole graph has completed.
+        void Run();
+
+    private:
+        struct Node
+        {
+            JobGraph* graph;
+            JobSystem::JobFunction function;
+            void* data;
+            JobPriority priority;
+            uint32_t dependencyCount;
+            std::vector<uint32_t> successors;
+            std::atomic<uint32_t> pendingDependencies;
+        };
+
+        static void RunNode(void* data, uint32_t threadIndex);
+
+        /// Deque keeps nodes in place as jobs are added.
+        std::deque<Node> _nodes;
+        JobCounter _counter;
+
+        DISALLOW_COPY_MOVE_AND_ASSIGN(JobGraph);
+    };
+
+    /// Per-thread storage indexed by JobSystem thread index, lets parallel callbacks accumulate results without locks.
+    template <typename T>
+    class PerThread final
+    {
+    public:
+        PerThread()
+            : _slots(JobSystem::GetInstance()->GetThreadCount())
+        {
+        }
+
+        explicit PerThread(const T& value)
+            : _slots(JobSystem::GetInstance()->GetThreadCount(), Slot{ value, {} })
+        {
+        }
+
+        /// Get the value of the calling thread.
+        T& Local()
+        {
+            const uint32_t threadIndex = JobSystem::GetCurrentThreadIndex();
+            ALIMER_ASSERT_MSG(threadIndex < _slots.size(), "Thread %u has no per-thread slot", threadIndex);
+            return _slots[threadIndex].value;
+        }
+
+        /// Number of per-thread values.
+        uint32_t Size() const { return static_cast<uint32_t>(_slots.size()); }
+
+        T& operator[](uint32_t index) { return _slots[index].value; }
+        const T& operator[](uint32_t index) const { return _slots[index].value; }
+
+    private:
+        // Pad slots to avoid false sharing between workers.
+        struct Slot
+        {
+            T value;
+            uint8_t padding[ALIMER_CACHE_LINE_SIZE];
+        };
+
+        std::vector<Slot> _slots;
+    };
+}
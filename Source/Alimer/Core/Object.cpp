@@ -23,6 +23,7 @@
 #include "../Core/Object.h"
 #include "../Core/Log.h"
 #include <map>
+#include <mutex>
 
 namespace Alimer
 {
@@ -30,27 +31,6 @@ namespace Alimer
     {
         struct SubSystemContext
         {
-            void AddSubsystem(Object* subsystem)
-            {
-                _subsystems[subsystem->GetType()] = subsystem;
-            }
-
-            void RemoveSubsystem(Object* subsystem)
-            {
-                _subsystems.erase(subsystem->GetType());
-            }
-
-            void RemoveSubsystem(StringHash type)
-            {
-                _subsystems.erase(type);
-            }
-
-            Object* GetSubsystem(StringHash type)
-            {
-                auto it = _subsystems.find(type);
-                return it != _subsystems.end() ? it->second : nullptr;
-            }
-
             void RegisterFactory(ObjectFactory* factory)
             {
                 auto it = _factories.find(factory->GetType());
@@ -88,9 +68,6 @@ namespace Alimer
             }
 
         private:
-            /// Registered subsystems.
-            std::map<StringHash, Object*> _subsystems;
-
             /// Registered object factories.
             std::map<StringHash, UniquePtr<ObjectFactory>> _factories;
         };
@@ -100,38 +77,51 @@ namespace Alimer
             static SubSystemContext s_context;
             return s_context;
         }
+
+        // Subsystem registry, constant initialized so subsystems can be added during static initialization.
+        static std::mutex s_subsystemMutex;
+        /// Subsystem type hash of each slot, slots are never released.
+        static uint32_t s_subsystemTypes[Object::MaxSubsystems];
+        static std::atomic<uint32_t> s_subsystemSlotCount{ 1 };
+
+        /// Return slot of a type or 0 if none was assigned. Lock free, the few slot types are scanned linearly.
+        static uint32_t FindSubsystemSlot(StringHash type)
+        {
+            const uint32_t count = s_subsystemSlotCount.load(std::memory_order_acquire);
+            for (uint32_t slot = 1; slot < count; ++slot)
+            {
+                if (s_subsystemTypes[slot] == type.Value())
+                    return slot;
+            }
+
+            return 0;
+        }
     }
 
     TypeInfo::TypeInfo(const char* typeName, const TypeInfo* baseTypeInfo)
         : _type(typeName)
         , _typeName(typeName)
         , _baseTypeInfo(baseTypeInfo)
+        , _depth(baseTypeInfo ? baseTypeInfo->_depth + 1 : 0)
     {
-    }
+        ALIMER_ASSERT_MSG(_depth < MaxDepth, "Class hierarchy of %s is deeper than %u", typeName, MaxDepth);
 
-    bool TypeInfo::IsTypeOf(StringHash type) const
-    {
-        const TypeInfo* current = this;
-        while (current)
+        for (uint32_t i = 0; i < _depth; ++i)
         {
-            if (current->GetType() == type)
-                return true;
-
-            current = current->GetBaseTypeInfo();
+            _display[i] = baseTypeInfo->_display[i];
         }
 
-        return false;
+        _display[_depth] = this;
     }
 
-    bool TypeInfo::IsTypeOf(const TypeInfo* typeInfo) const
+    constexpr uint32_t TypeInfo::MaxDepth;
+
+    bool TypeInfo::IsTypeOf(StringHash type) const
     {
-        const TypeInfo* current = this;
-        while (current)
+        for (uint32_t i = 0; i <= _depth; ++i)
         {
-            if (current == typeInfo)
+            if (_display[i]->GetType() == type)
                 return true;
-
-            current = current->GetBaseTypeInfo();
         }
 
         return false;
@@ -142,31 +132,67 @@ namespace Alimer
         return GetTypeInfo()->IsTypeOf(type);
     }
 
-
-
-    bool Object::IsInstanceOf(const TypeInfo* typeInfo) const
-    {
-        return GetTypeInfo()->IsTypeOf(typeInfo);
-    }
+    constexpr uint32_t Object::MaxSubsystems;
+    std::atomic<Object*> Object::_subsystems[MaxSubsystems];
 
     void Object::AddSubsystem(Object* subsystem)
     {
-        details::Context().AddSubsystem(subsystem);
+        ALIMER_ASSERT(subsystem);
+
+        const uint32_t slot = GetSubsystemSlot(subsystem->GetType());
+        if (slot != 0)
+        {
+            // Release pairs with the acquire in GetSubsystem, readers see a fully constructed subsystem.
+            _subsystems[slot].store(subsystem, std::memory_order_release);
+        }
     }
 
     void Object::RemoveSubsystem(Object* subsystem)
     {
-        details::Context().RemoveSubsystem(subsystem);
+        const uint32_t slot = details::FindSubsystemSlot(subsystem->GetType());
+        if (slot != 0)
+        {
+            Object* expected = subsystem;
+            _subsystems[slot].compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+        }
     }
 
     void Object::RemoveSubsystem(StringHash type)
     {
-        details::Context().RemoveSubsystem(type);
+        const uint32_t slot = details::FindSubsystemSlot(type);
+        if (slot != 0)
+        {
+            _subsystems[slot].store(nullptr, std::memory_order_release);
+        }
     }
 
     Object* Object::GetSubsystem(StringHash type)
     {
-        return details::Context().GetSubsystem(type);
+        const uint32_t slot = details::FindSubsystemSlot(type);
+        return _subsystems[slot].load(std::memory_order_acquire);
+    }
+
+    uint32_t Object::GetSubsystemSlot(StringHash type)
+    {
+        uint32_t slot = details::FindSubsystemSlot(type);
+        if (slot != 0)
+            return slot;
+
+        std::lock_guard<std::mutex> lock(details::s_subsystemMutex);
+        slot = details::FindSubsystemSlot(type);
+        if (slot != 0)
+            return slot;
+
+        // Out of slots, the type maps to the empty slot 0.
+        slot = details::s_subsystemSlotCount.load(std::memory_order_relaxed);
+        ALIMER_ASSERT_MSG(slot < MaxSubsystems, "More than %u subsystem types", MaxSubsystems - 1);
+        if (slot == MaxSubsystems)
+            return 0;
+
+        // Type is written before the count is published, readers scan without locking.
+        details::s_subsystemTypes[slot] = type.Value();
+        details::s_subsystemSlotCount.store(slot + 1, std::memory_order_release);
+        return slot;
     }
 
     void Object::RegisterFactory(ObjectFactory* factory)
@@ -26,13 +26,18 @@
 #include "../Base/Ptr.h"
 #include "../Base/StringHash.h"
 #include "../Core/Event.h"
+#include <atomic>
 
 namespace Alimer
 {
     /// Type info.
+    /// Each type stores its ancestors indexed by depth (Cohen display), so type checks take constant time.
     class ALIMER_API TypeInfo final
     {
     public:
+        /// Maximum depth of a class hierarchy.
+        static constexpr uint32_t MaxDepth = 16;
+
         /// Constructor.
         TypeInfo(const char* typeName, const TypeInfo* baseTypeInfo);
         /// Destructor.
@@ -41,7 +46,10 @@ namespace Alimer
         /// Check current type is type of specified type.
         bool IsTypeOf(StringHash type) const;
         /// Check current type is type of specified type.
-        bool IsTypeOf(const TypeInfo* typeInfo) const;
+        bool IsTypeOf(const TypeInfo* typeInfo) const
+        {
+            return typeInfo != nullptr && typeInfo->_depth <= _depth && _display[typeInfo->_depth] == typeInfo;
+        }
         /// Check current type is type of specified class type.
         template<typename T> bool IsTypeOf() const { return IsTypeOf(T::GetTypeInfoStatic()); }
 
@@ -51,6 +59,8 @@ namespace Alimer
         const String& GetTypeName() const { return _typeName; }
         /// Return base type info.
         const TypeInfo* GetBaseTypeInfo() const { return _baseTypeInfo; }
+        /// Return number of base classes.
+        uint32_t GetDepth() const { return _depth; }
 
     private:
         /// Type.
@@ -59,6 +69,10 @@ namespace Alimer
         String _typeName;
         /// Base class type info.
         const TypeInfo* _baseTypeInfo;
+        /// Number of base classes.
+        uint32_t _depth;
+        /// Ancestors from the root at index 0 down to this type at index _depth.
+        const TypeInfo* _display[MaxDepth];
 
         DISALLOW_COPY_MOVE_AND_ASSIGN(TypeInfo);
     };
@@ -86,7 +100,7 @@ namespace Alimer
         /// Check current instance is type of specified type.
         bool IsInstanceOf(StringHash type) const;
         /// Check current instance is type of specified type.
-        bool IsInstanceOf(const TypeInfo* typeInfo) const;
+        bool IsInstanceOf(const TypeInfo* typeInfo) const { return GetTypeInfo()->IsTypeOf(typeInfo); }
         /// Check current instance is type of specified class.
         template<typename T> bool IsInstanceOf() const { return IsInstanceOf(T::GetTypeInfoStatic()); }
         /// Cast the object to specified most derived class.
@@ -94,17 +108,28 @@ namespace Alimer
         /// Cast the object to specified most derived class.
         template<typename T> const T* Cast() const { return IsInstanceOf<T>() ? static_cast<const T*>(this) : nullptr; }
 
-        /// Add a subsystem that can be accessed globally. Note that the subsystems container does not own the objects.
+        /// Maximum number of subsystem types, slot 0 is never assigned and stays empty.
+        static constexpr uint32_t MaxSubsystems = 64;
+
+        /// Add a subsystem that can be accessed globally, replacing any subsystem of the same type.
+        /// Note that the subsystems container does not own the objects, a subsystem must be removed before it is destroyed.
         static void AddSubsystem(Object* subsystem);
-        /// Remove a subsystem by object pointer.
+        /// Remove a subsystem by object pointer, does nothing if another object of the same type replaced it.
         static void RemoveSubsystem(Object* subsystem);
         /// Remove a subsystem by type.
         static void RemoveSubsystem(StringHash type);
         /// Return a subsystem by type, or null if not registered.
         static Object* GetSubsystem(StringHash type);
 
-        /// Return a subsystem, template version.
-        template <class T> static T* GetSubsystem() { return static_cast<T*>(GetSubsystem(T::GetTypeStatic())); }
+        /// Return the registry slot of a subsystem type, assigned on first use. Thread safe.
+        static uint32_t GetSubsystemSlot(StringHash type);
+
+        /// Return a subsystem, template version. The slot is looked up once, later calls are a single load.
+        template <class T> static T* GetSubsystem()
+        {
+            static const uint32_t slot = GetSubsystemSlot(T::GetTypeStatic());
+            return static_cast<T*>(_subsystems[slot].load(std::memory_order_acquire));
+        }
 
         /// Register an object factory.
         static void RegisterFactory(ObjectFactory* factory);
@@ -126,6 +151,10 @@ namespace Alimer
 
         /// Return a type name from hash, or empty if not known. Requires a registered object factory.
         static const String& GetTypeNameFromType(StringHash type);
+
+    private:
+        /// Registered subsystems by slot.
+        static std::atomic<Object*> _subsystems[MaxSubsystems];
     };
 
     /// Base class for object factories.
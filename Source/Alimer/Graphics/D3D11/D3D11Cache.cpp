@@ -60,7 +60,7 @@ namespace Alimer
 #if TODO
         auto hash = shader->GetHash();
         auto it = _shaders.find(hash);
-        if (it != end(_shaders))
+        if (it != _shaders.end())
         {
             return it->second.Get();
         }
@@ -178,7 +178,7 @@ namespace Alimer
 
         auto hash = hasher.GetValue();
         auto it = _inputLayouts.find(hash);
-        if (it != end(_inputLayouts))
+        if (it != _inputLayouts.end())
         {
             return it->second.Get();
         }
@@ -0,0 +1,44 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Math/BoundingBox.h"
+#include <cmath>
+
+namespace Alimer
+{
+    BoundingBox BoundingBox::Transformed(const mat4& matrix) const
+    {
+        // Transform the center and project the extents on the absolute axes (Arvo).
+        const vec3 center = GetCenter();
+        const vec3 extents = GetExtents();
+        vec3 newCenter = matrix[3].xyz();
+        vec3 newExtents(0.0f);
+        for (int i = 0; i < 3; i++)
+        {
+            const vec3 axis = matrix[i].xyz();
+            newCenter = newCenter + axis * center[i];
+            newExtents = newExtents + vec3(std::abs(axis.x), std::abs(axis.y), std::abs(axis.z)) * extents[i];
+        }
+
+        return FromCenterExtents(newCenter, newExtents);
+    }
+}
@@ -0,0 +1,88 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Math/Math.h"
+#include <cfloat>
+
+namespace Alimer
+{
+    /// Axis aligned bounding box.
+    class ALIMER_API BoundingBox
+    {
+    public:
+        /// Construct undefined box, merging the first point defines it.
+        BoundingBox() noexcept : min(FLT_MAX), max(-FLT_MAX) {}
+
+        /// Construct from minimum and maximum corners.
+        BoundingBox(const vec3& min_, const vec3& max_) : min(min_), max(max_) {}
+
+        /// Construct from center and half size.
+        static BoundingBox FromCenterExtents(const vec3& center, const vec3& extents) { return BoundingBox(center - extents, center + extents); }
+
+        /// Return whether the box has been defined.
+        bool IsDefined() const { return min.x <= max.x; }
+
+        vec3 GetCenter() const { return (max + min) * 0.5f; }
+        /// Return half size.
+        vec3 GetExtents() const { return (max - min) * 0.5f; }
+        vec3 GetSize() const { return max - min; }
+
+        /// Grow to include point.
+        void Merge(const vec3& point)
+        {
+            min = Alimer::min(min, point);
+            max = Alimer::max(max, point);
+        }
+
+        /// Grow to include box.
+        void Merge(const BoundingBox& box)
+        {
+            min = Alimer::min(min, box.min);
+            max = Alimer::max(max, box.max);
+        }
+
+        /// Return whether the boxes overlap, touching counts as overlap.
+        bool Intersects(const BoundingBox& box) const
+        {
+            return min.x <= box.max.x && max.x >= box.min.x
+                && min.y <= box.max.y && max.y >= box.min.y
+                && min.z <= box.max.z && max.z >= box.min.z;
+        }
+
+        bool Contains(const vec3& point) const
+        {
+            return point.x >= min.x && point.x <= max.x
+                && point.y >= min.y && point.y <= max.y
+                && point.z >= min.z && point.z <= max.z;
+        }
+
+        /// Return the box enclosing this box transformed by affine matrix.
+        BoundingBox Transformed(const mat4& matrix) const;
+
+        /// Minimum corner.
+        vec3 min;
+        /// Maximum corner.
+        vec3 max;
+    };
+}
@@ -0,0 +1,94 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Math/BoundingSphere.h"
+#include <cmath>
+
+namespace Alimer
+{
+    BoundingSphere::BoundingSphere(const BoundingBox& box)
+        : center(box.GetCenter())
+        , radius(length(box.GetExtents()))
+    {
+    }
+
+    void BoundingSphere::Merge(const vec3& point)
+    {
+        if (!IsDefined())
+        {
+            center = point;
+            radius = 0.0f;
+            return;
+        }
+
+        const vec3 offset = point - center;
+        const float distance = length(offset);
+        if (distance > radius)
+        {
+            // Move the center half way towards the point so the far side stays enclosed.
+            const float newRadius = (radius + distance) * 0.5f;
+            center = center + offset * ((newRadius - radius) / distance);
+            radius = newRadius;
+        }
+    }
+
+    void BoundingSphere::Merge(const BoundingSphere& sphere)
+    {
+        if (!sphere.IsDefined())
+        {
+            return;
+        }
+
+        if (!IsDefined())
+        {
+            *this = sphere;
+            return;
+        }
+
+        const vec3 offset = sphere.center - center;
+        const float distance = length(offset);
+        if (distance + sphere.radius <= radius)
+        {
+            return;
+        }
+
+        if (distance + radius <= sphere.radius)
+        {
+            *this = sphere;
+            return;
+        }
+
+        const float newRadius = (radius + distance + sphere.radius) * 0.5f;
+        center = center + offset * ((newRadius - radius) / distance);
+        radius = newRadius;
+    }
+
+    BoundingSphere BoundingSphere::Transformed(const mat4& matrix) const
+    {
+        const float scaleX = dot(matrix[0].xyz(), matrix[0].xyz());
+        const float scaleY = dot(matrix[1].xyz(), matrix[1].xyz());
+        const float scaleZ = dot(matrix[2].xyz(), matrix[2].xyz());
+        const float scale = std::sqrt(max(scaleX, max(scaleY, scaleZ)));
+        const vec4 newCenter = matrix * vec4(center, 1.0f);
+        return BoundingSphere(newCenter.xyz(), radius * scale);
+    }
+}
@@ -0,0 +1,73 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Math/BoundingBox.h"
+
+namespace Alimer
+{
+    /// Bounding sphere.
+    class ALIMER_API BoundingSphere
+    {
+    public:
+        /// Construct undefined sphere, merging the first point defines it.
+        BoundingSphere() noexcept : center(0.0f), radius(-1.0f) {}
+
+        /// Construct from center and radius.
+        BoundingSphere(const vec3& center_, float radius_) : center(center_), radius(radius_) {}
+
+        /// Construct the sphere enclosing box.
+        explicit BoundingSphere(const BoundingBox& box);
+
+        /// Return whether the sphere has been defined.
+        bool IsDefined() const { return radius >= 0.0f; }
+
+        /// Grow to include point.
+        void Merge(const vec3& point);
+
+        /// Grow to include sphere.
+        void Merge(const BoundingSphere& sphere);
+
+        /// Return whether the spheres overlap, touching counts as overlap.
+        bool Intersects(const BoundingSphere& sphere) const
+        {
+            const vec3 offset = sphere.center - center;
+            const float radiusSum = radius + sphere.radius;
+            return dot(offset, offset) <= radiusSum * radiusSum;
+        }
+
+        bool Contains(const vec3& point) const
+        {
+            const vec3 offset = point - center;
+            return dot(offset, offset) <= radius * radius;
+        }
+
+        /// Return the sphere enclosing this sphere transformed by affine matrix, non uniform scale uses the largest axis.
+        BoundingSphere Transformed(const mat4& matrix) const;
+
+        /// Sphere center.
+        vec3 center;
+        /// Sphere radius, negative when undefined.
+        float radius;
+    };
+}
@@ -0,0 +1,106 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Math/Frustum.h"
+#include <cmath>
+
+namespace Alimer
+{
+    constexpr uint32_t Frustum::PlaneCount;
+
+    Frustum::Frustum() noexcept
+    {
+        for (uint32_t i = 0; i < PlaneCount; i++)
+        {
+            _planes[i] = Plane(vec3(0.0f), 1.0f);
+        }
+    }
+
+    Frustum::Frustum(const mat4& viewProjection)
+    {
+        Define(viewProjection);
+    }
+
+    void Frustum::Define(const mat4& viewProjection)
+    {
+        // Gribb-Hartmann, clip space point is inside when -w <= x, y <= w and 0 <= z <= w.
+        const mat4& m = viewProjection;
+        const vec4 row0(m[0].x, m[1].x, m[2].x, m[3].x);
+        const vec4 row1(m[0].y, m[1].y, m[2].y, m[3].y);
+        const vec4 row2(m[0].z, m[1].z, m[2].z, m[3].z);
+        const vec4 row3(m[0].w, m[1].w, m[2].w, m[3].w);
+
+        _planes[static_cast<uint32_t>(FrustumPlane::Left)] = Plane(row3 + row0).Normalized();
+        _planes[static_cast<uint32_t>(FrustumPlane::Right)] = Plane(row3 - row0).Normalized();
+        _planes[static_cast<uint32_t>(FrustumPlane::Bottom)] = Plane(row3 + row1).Normalized();
+        _planes[static_cast<uint32_t>(FrustumPlane::Top)] = Plane(row3 - row1).Normalized();
+        _planes[static_cast<uint32_t>(FrustumPlane::Near)] = Plane(row2).Normalized();
+        _planes[static_cast<uint32_t>(FrustumPlane::Far)] = Plane(row3 - row2).Normalized();
+    }
+
+    bool Frustum::Contains(const vec3& point) const
+    {
+        for (uint32_t i = 0; i < PlaneCount; i++)
+        {
+            if (_planes[i].Distance(point) < 0.0f)
+                return false;
+        }
+
+        return true;
+    }
+
+    Intersection Frustum::Intersects(const BoundingBox& box) const
+    {
+        const vec3 center = box.GetCenter();
+        const vec3 extents = box.GetExtents();
+        Intersection result = Intersection::Inside;
+        for (uint32_t i = 0; i < PlaneCount; i++)
+        {
+            const Plane& plane = _planes[i];
+            const float distance = plane.Distance(center);
+            const float radius = dot(vec3(std::abs(plane.normal.x), std::abs(plane.normal.y), std::abs(plane.normal.z)), extents);
+            if (distance + radius < 0.0f)
+                return Intersection::Outside;
+
+            if (distance - radius < 0.0f)
+                result = Intersection::Intersects;
+        }
+
+        return result;
+    }
+
+    Intersection Frustum::Intersects(const BoundingSphere& sphere) const
+    {
+        Intersection result = Intersection::Inside;
+        for (uint32_t i = 0; i < PlaneCount; i++)
+        {
+            const float distance = _planes[i].Distance(sphere.center);
+            if (distance + sphere.radius < 0.0f)
+                return Intersection::Outside;
+
+            if (distance - sphere.radius < 0.0f)
+                result = Intersection::Intersects;
+        }
+
+        return result;
+    }
+}
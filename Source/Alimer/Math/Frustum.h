@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Math/Plane.h"
+#include "../Math/BoundingSphere.h"
+
+namespace Alimer
+{
+    /// Result of a containment test.
+    enum class Intersection : uint32_t
+    {
+        Outside,
+        Intersects,
+        Inside
+    };
+
+    /// Frustum planes.
+    enum class FrustumPlane : uint32_t
+    {
+        Left,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        Count
+    };
+
+    /// Convex volume bounded by six planes with normals pointing inside.
+    class ALIMER_API Frustum
+    {
+    public:
+        static constexpr uint32_t PlaneCount = static_cast<uint32_t>(FrustumPlane::Count);
+
+        /// Construct frustum that contains everything.
+        Frustum() noexcept;
+
+        /// Construct from view projection matrix, see Define.
+        explicit Frustum(const mat4& viewProjection);
+
+        /// Extract normalized world space planes from view projection matrix with [0, 1] clip depth.
+        void Define(const mat4& viewProjection);
+
+        const Plane& GetPlane(FrustumPlane plane) const { return _planes[static_cast<uint32_t>(plane)]; }
+        const Plane* GetPlanes() const { return _planes; }
+
+        bool Contains(const vec3& point) const;
+
+        /// Test box, conservative: boxes near frustum corners may report Intersects while being outside.
+        Intersection Intersects(const BoundingBox& box) const;
+
+        /// Test sphere, conservative like the box test.
+        Intersection Intersects(const BoundingSphere& sphere) const;
+
+    private:
+        Plane _planes[PlaneCount];
+    };
+}
@@ -0,0 +1,387 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Math/FrustumCulling.inl"
+#include "../Math/MatrixKernels.h"
+#include "../Math/MathUtil.h"
+#include "../Core/JobSystem.h"
+#include "../Debug/Debug.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Alimer
+{
+    static const uint32_t ParallelCullThreshold = 16384;
+    static const uint32_t ParallelGrainSize = 4096;
+    /// Items culled per step by the index list variants, the mask lives on the stack.
+    static const uint32_t IndexChunkSize = 1024;
+
+    uint32_t BoundingBoxArray::Add(const BoundingBox& box)
+    {
+        const uint32_t index = GetSize();
+        Resize(index + 1);
+        Set(index, box);
+        return index;
+    }
+
+    void BoundingBoxArray::Set(uint32_t index, const BoundingBox& box)
+    {
+        ALIMER_ASSERT_MSG(index < GetSize(), "Index out of bounds. (%u, size %u)", index, GetSize());
+        const vec3 center = box.GetCenter();
+        const vec3 extents = box.GetExtents();
+        _centerX[index] = center.x;
+        _centerY[index] = center.y;
+        _centerZ[index] = center.z;
+        _extentX[index] = extents.x;
+        _extentY[index] = extents.y;
+        _extentZ[index] = extents.z;
+    }
+
+    BoundingBox BoundingBoxArray::Get(uint32_t index) const
+    {
+        ALIMER_ASSERT_MSG(index < GetSize(), "Index out of bounds. (%u, size %u)", index, GetSize());
+        return BoundingBox::FromCenterExtents(
+            vec3(_centerX[index], _centerY[index], _centerZ[index]),
+            vec3(_extentX[index], _extentY[index], _extentZ[index]));
+    }
+
+    void BoundingBoxArray::Resize(uint32_t size)
+    {
+        _centerX.resize(size);
+        _centerY.resize(size);
+        _centerZ.resize(size);
+        _extentX.resize(size);
+        _extentY.resize(size);
+        _extentZ.resize(size);
+    }
+
+    void BoundingBoxArray::Clear()
+    {
+        Resize(0);
+    }
+
+    uint32_t BoundingSphereArray::Add(const BoundingSphere& sphere)
+    {
+        const uint32_t index = GetSize();
+        Resize(index + 1);
+        Set(index, sphere);
+        return index;
+    }
+
+    void BoundingSphereArray::Set(uint32_t index, const BoundingSphere& sphere)
+    {
+        ALIMER_ASSERT_MSG(index < GetSize(), "Index out of bounds. (%u, size %u)", index, GetSize());
+        _centerX[index] = sphere.center.x;
+        _centerY[index] = sphere.center.y;
+        _centerZ[index] = sphere.center.z;
+        _radius[index] = sphere.radius;
+    }
+
+    BoundingSphere BoundingSphereArray::Get(uint32_t index) const
+    {
+        ALIMER_ASSERT_MSG(index < GetSize(), "Index out of bounds. (%u, size %u)", index, GetSize());
+        return BoundingSphere(vec3(_centerX[index], _centerY[index], _centerZ[index]), _radius[index]);
+    }
+
+    void BoundingSphereArray::Resize(uint32_t size)
+    {
+        _centerX.resize(size);
+        _centerY.resize(size);
+        _centerZ.resize(size);
+        _radius.resize(size);
+    }
+
+    void BoundingSphereArray::Clear()
+    {
+        Resize(0);
+    }
+
+    template <typename Input, bool(*IsVisible)(const CullingPlanes&, const Input&, uint32_t)>
+    static void CullScalar(const CullingPlanes& planes, const Input& input, uint32_t begin, uint32_t end, uint32_t* visibility)
+    {
+        for (uint32_t i = begin; i < end; i += 32)
+        {
+            *visibility++ = CullWordScalar<Input, IsVisible>(planes, input, i, i + 32 < end ? i + 32 : end);
+        }
+    }
+
+#if ALIMER_SSE2
+    struct SsePlanes
+    {
+        __m128 normalX[Frustum::PlaneCount];
+        __m128 normalY[Frustum::PlaneCount];
+        __m128 normalZ[Frustum::PlaneCount];
+        __m128 absNormalX[Frustum::PlaneCount];
+        __m128 absNormalY[Frustum::PlaneCount];
+        __m128 absNormalZ[Frustum::PlaneCount];
+        __m128 distance[Frustum::PlaneCount];
+
+        explicit SsePlanes(const CullingPlanes& planes)
+        {
+            for (uint32_t i = 0; i < Frustum::PlaneCount; i++)
+            {
+                normalX[i] = _mm_set1_ps(planes.normalX[i]);
+                normalY[i] = _mm_set1_ps(planes.normalY[i]);
+                normalZ[i] = _mm_set1_ps(planes.normalZ[i]);
+                absNormalX[i] = _mm_set1_ps(planes.absNormalX[i]);
+                absNormalY[i] = _mm_set1_ps(planes.absNormalY[i]);
+                absNormalZ[i] = _mm_set1_ps(planes.absNormalZ[i]);
+                distance[i] = _mm_set1_ps(planes.distance[i]);
+            }
+        }
+    };
+
+    /// Visibility bits of the four boxes starting at index.
+    static inline uint32_t CullBoxes4(const SsePlanes& planes, const CullingBoxes& boxes, uint32_t index)
+    {
+        const __m128 centerX = _mm_loadu_ps(boxes.centerX + index);
+        const __m128 centerY = _mm_loadu_ps(boxes.centerY + index);
+        const __m128 centerZ = _mm_loadu_ps(boxes.centerZ + index);
+        const __m128 extentX = _mm_loadu_ps(boxes.extentX + index);
+        const __m128 extentY = _mm_loadu_ps(boxes.extentY + index);
+        const __m128 extentZ = _mm_loadu_ps(boxes.extentZ + index);
+        __m128 outside = _mm_setzero_ps();
+        for (uint32_t i = 0; i < Frustum::PlaneCount; i++)
+        {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(planes.normalX[i], centerX), _mm_mul_ps(planes.normalY[i], centerY));
+            distance = _mm_add_ps(_mm_add_ps(distance, _mm_mul_ps(planes.normalZ[i], centerZ)), planes.distance[i]);
+            __m128 radius = _mm_add_ps(_mm_mul_ps(planes.absNormalX[i], extentX), _mm_mul_ps(planes.absNormalY[i], extentY));
+            radius = _mm_add_ps(radius, _mm_mul_ps(planes.absNormalZ[i], extentZ));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+        }
+
+        return static_cast<uint32_t>(_mm_movemask_ps(outside)) ^ 0xFu;
+    }
+
+    /// Visibility bits of the four spheres starting at index.
+    static inline uint32_t CullSpheres4(const SsePlanes& planes, const CullingSpheres& spheres, uint32_t index)
+    {
+        const __m128 centerX = _mm_loadu_ps(spheres.centerX + index);
+        const __m128 centerY = _mm_loadu_ps(spheres.centerY + index);
+        const __m128 centerZ = _mm_loadu_ps(spheres.centerZ + index);
+        const __m128 radius = _mm_loadu_ps(spheres.radius + index);
+        __m128 outside = _mm_setzero_ps();
+        for (uint32_t i = 0; i < Frustum::PlaneCount; i++)
+        {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(planes.normalX[i], centerX), _mm_mul_ps(planes.normalY[i], centerY));
+            distance = _mm_add_ps(_mm_add_ps(distance, _mm_mul_ps(planes.normalZ[i], centerZ)), planes.distance[i]);
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+        }
+
+        return static_cast<uint32_t>(_mm_movemask_ps(outside)) ^ 0xFu;
+    }
+
+    static void CullBoxesSse(const CullingPlanes& planes, const CullingBoxes& boxes, uint32_t begin, uint32_t end, uint32_t* visibility)
+    {
+        const SsePlanes ssePlanes(planes);
+        uint32_t i = begin;
+        for (; i + 32 <= end; i += 32)
+        {
+            uint32_t word = 0;
+            for (uint32_t lane = 0; lane < 32; lane += 4)
+            {
+                word |= CullBoxes4(ssePlanes, boxes, i + lane) << lane;
+            }
+
+            *visibility++ = word;
+        }
+
+        if (i < end)
+        {
+            *visibility = CullWordScalar<CullingBoxes, IsBoxVisible>(planes, boxes, i, end);
+        }
+    }
+
+    static void CullSpheresSse(const CullingPlanes& planes, const CullingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visibility)
+    {
+        const SsePlanes ssePlanes(planes);
+        uint32_t i = begin;
+        for (; i + 32 <= end; i += 32)
+        {
+            uint32_t word = 0;
+            for (uint32_t lane = 0; lane < 32; lane += 4)
+            {
+                word |= CullSpheres4(ssePlanes, spheres, i + lane) << lane;
+            }
+
+            *visibility++ = word;
+        }
+
+        if (i < end)
+        {
+            *visibility = CullWordScalar<CullingSpheres, IsSphereVisible>(planes, spheres, i, end);
+        }
+    }
+#endif
+
+    static CullingKernelTable GetCullingKernels()
+    {
+        CullingKernelTable table = {
+            CullScalar<CullingBoxes, IsBoxVisible>,
+            CullScalar<CullingSpheres, IsSphereVisible>
+        };
+
+#if ALIMER_SSE2
+        const SimdLevel level = GetSimdLevel();
+        if (level >= SimdLevel::SSE2)
+        {
+            table = { CullBoxesSse, CullSpheresSse };
+        }
+
+        if (level >= SimdLevel::AVX)
+        {
+            GetAvxCullingKernels(table);
+        }
+#endif
+
+        return table;
+    }
+
+    static CullingPlanes GetCullingPlanes(const Frustum& frustum)
+    {
+        CullingPlanes result;
+        for (uint32_t i = 0; i < Frustum::PlaneCount; i++)
+        {
+            const Plane& plane = frustum.GetPlanes()[i];
+            result.normalX[i] = plane.normal.x;
+            result.normalY[i] = plane.normal.y;
+            result.normalZ[i] = plane.normal.z;
+            result.absNormalX[i] = std::abs(plane.normal.x);
+            result.absNormalY[i] = std::abs(plane.normal.y);
+            result.absNormalZ[i] = std::abs(plane.normal.z);
+            result.distance[i] = plane.distance;
+        }
+
+        return result;
+    }
+
+    static CullingBoxes GetCullingInput(const BoundingBoxArray& boxes)
+    {
+        return { boxes.GetCenterX(), boxes.GetCenterY(), boxes.GetCenterZ(), boxes.GetExtentX(), boxes.GetExtentY(), boxes.GetExtentZ() };
+    }
+
+    static CullingSpheres GetCullingInput(const BoundingSphereArray& spheres)
+    {
+        return { spheres.GetCenterX(), spheres.GetCenterY(), spheres.GetCenterZ(), spheres.GetRadius() };
+    }
+
+    template <typename Input, typename Function>
+    static void CullMask(Function cull, const CullingPlanes& planes, const Input& input, uint32_t count, uint32_t* visibility)
+    {
+        if (count < ParallelCullThreshold)
+        {
+            if (count > 0)
+            {
+                cull(planes, input, 0, count, visibility);
+            }
+            return;
+        }
+
+        // Split over mask words, each batch owns whole words and writes disjoint memory.
+        JobSystem::GetInstance()->ParallelFor(GetVisibilityMaskSize(count), ParallelGrainSize / 32, [&](uint32_t beginWord, uint32_t endWord) {
+            cull(planes, input, beginWord * 32, std::min(endWord * 32, count), visibility + beginWord);
+        });
+    }
+
+    template <typename Input, typename Function>
+    static uint32_t CullIndices(Function cull, const CullingPlanes& planes, const Input& input, uint32_t count, ArrayView<uint32_t> indices)
+    {
+        if (count >= ParallelCullThreshold)
+        {
+            std::vector<uint32_t> visibility(GetVisibilityMaskSize(count));
+            CullMask(cull, planes, input, count, visibility.data());
+            return GetVisibleIndices(ArrayView<const uint32_t>(visibility.data(), static_cast<uint32_t>(visibility.size())), count, indices);
+        }
+
+        uint32_t visibility[IndexChunkSize / 32];
+        uint32_t visibleCount = 0;
+        for (uint32_t begin = 0; begin < count; begin += IndexChunkSize)
+        {
+            const uint32_t end = begin + IndexChunkSize < count ? begin + IndexChunkSize : count;
+            cull(planes, input, begin, end, visibility);
+            for (uint32_t word = 0; word < GetVisibilityMaskSize(end - begin); word++)
+            {
+                uint32_t bits = visibility[word];
+                while (bits != 0)
+                {
+                    indices.data()[visibleCount++] = begin + word * 32 + ScanForward(bits);
+                    bits &= bits - 1;
+                }
+            }
+        }
+
+        return visibleCount;
+    }
+
+    void CullBoxes(const Frustum& frustum, const BoundingBoxArray& boxes, ArrayView<uint32_t> visibility)
+    {
+        const uint32_t count = boxes.GetSize();
+        ALIMER_ASSERT_MSG(visibility.size() >= GetVisibilityMaskSize(count), "Visibility mask too small (%u, %u)", visibility.size(), GetVisibilityMaskSize(count));
+        CullMask(GetCullingKernels().cullBoxes, GetCullingPlanes(frustum), GetCullingInput(boxes), count, visibility.data());
+    }
+
+    void CullSpheres(const Frustum& frustum, const BoundingSphereArray& spheres, ArrayView<uint32_t> visibility)
+    {
+        const uint32_t count = spheres.GetSize();
+        ALIMER_ASSERT_MSG(visibility.size() >= GetVisibilityMaskSize(count), "Visibility mask too small (%u, %u)", visibility.size(), GetVisibilityMaskSize(count));
+        CullMask(GetCullingKernels().cullSpheres, GetCullingPlanes(frustum), GetCullingInput(spheres), count, visibility.data());
+    }
+
+    uint32_t CullBoxesToIndices(const Frustum& frustum, const BoundingBoxArray& boxes, ArrayView<uint32_t> indices)
+    {
+        const uint32_t count = boxes.GetSize();
+        ALIMER_ASSERT_MSG(indices.size() >= count, "Index list too small (%u, %u)", indices.size(), count);
+        return CullIndices(GetCullingKernels().cullBoxes, GetCullingPlanes(frustum), GetCullingInput(boxes), count, indices);
+    }
+
+    uint32_t CullSpheresToIndices(const Frustum& frustum, const BoundingSphereArray& spheres, ArrayView<uint32_t> indices)
+    {
+        const uint32_t count = spheres.GetSize();
+        ALIMER_ASSERT_MSG(indices.size() >= count, "Index list too small (%u, %u)", indices.size(), count);
+        return CullIndices(GetCullingKernels().cullSpheres, GetCullingPlanes(frustum), GetCullingInput(spheres), count, indices);
+    }
+
+    uint32_t GetVisibleIndices(ArrayView<const uint32_t> visibility, uint32_t count, ArrayView<uint32_t> indices)
+    {
+        ALIMER_ASSERT_MSG(visibility.size() >= GetVisibilityMaskSize(count), "Visibility mask too small (%u, %u)", visibility.size(), GetVisibilityMaskSize(count));
+
+        uint32_t visibleCount = 0;
+        for (uint32_t word = 0; word < GetVisibilityMaskSize(count); word++)
+        {
+            uint32_t bits = visibility[word];
+            // Ignore bits past count in the last word.
+            if (word * 32 + 32 > count)
+            {
+                bits &= (1u << (count - word * 32)) - 1;
+            }
+
+            while (bits != 0)
+            {
+                ALIMER_ASSERT_MSG(visibleCount < indices.size(), "Index list too small (%u, %u)", visibleCount, indices.size());
+                indices.data()[visibleCount++] = word * 32 + ScanForward(bits);
+                bits &= bits - 1;
+            }
+        }
+
+        return visibleCount;
+    }
+}
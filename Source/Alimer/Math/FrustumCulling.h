@@ -0,0 +1,103 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Base/Containers.h"
+#include "../Math/Frustum.h"
+#include <vector>
+
+namespace Alimer
+{
+    /// Bounding boxes stored as separate center and extent arrays for batch culling.
+    class ALIMER_API BoundingBoxArray
+    {
+    public:
+        /// Append box and return its index.
+        uint32_t Add(const BoundingBox& box);
+        void Set(uint32_t index, const BoundingBox& box);
+        BoundingBox Get(uint32_t index) const;
+        void Resize(uint32_t size);
+        void Clear();
+
+        uint32_t GetSize() const { return static_cast<uint32_t>(_centerX.size()); }
+        const float* GetCenterX() const { return _centerX.data(); }
+        const float* GetCenterY() const { return _centerY.data(); }
+        const float* GetCenterZ() const { return _centerZ.data(); }
+        const float* GetExtentX() const { return _extentX.data(); }
+        const float* GetExtentY() const { return _extentY.data(); }
+        const float* GetExtentZ() const { return _extentZ.data(); }
+
+    private:
+        std::vector<float> _centerX;
+        std::vector<float> _centerY;
+        std::vector<float> _centerZ;
+        std::vector<float> _extentX;
+        std::vector<float> _extentY;
+        std::vector<float> _extentZ;
+    };
+
+    /// Bounding spheres stored as separate center and radius arrays for batch culling.
+    class ALIMER_API BoundingSphereArray
+    {
+    public:
+        /// Append sphere and return its index.
+        uint32_t Add(const BoundingSphere& sphere);
+        void Set(uint32_t index, const BoundingSphere& sphere);
+        BoundingSphere Get(uint32_t index) const;
+        void Resize(uint32_t size);
+        void Clear();
+
+        uint32_t GetSize() const { return static_cast<uint32_t>(_centerX.size()); }
+        const float* GetCenterX() const { return _centerX.data(); }
+        const float* GetCenterY() const { return _centerY.data(); }
+        const float* GetCenterZ() const { return _centerZ.data(); }
+        const float* GetRadius() const { return _radius.data(); }
+
+    private:
+        std::vector<float> _centerX;
+        std::vector<float> _centerY;
+        std::vector<float> _centerZ;
+        std::vector<float> _radius;
+    };
+
+    /// Number of words in a visibility mask with one bit per item.
+    inline uint32_t GetVisibilityMaskSize(uint32_t count) { return (count + 31) / 32; }
+
+    // Culling uses the kernels selected by SetSimdLevel, every level gives the same result as Frustum::Intersects
+    // returning anything but Outside. Inputs of 16384 or more items are split over the job system.
+
+    /// Set bit i of visibility when box i is not outside the frustum, visibility holds GetVisibilityMaskSize words.
+    ALIMER_API void CullBoxes(const Frustum& frustum, const BoundingBoxArray& boxes, ArrayView<uint32_t> visibility);
+
+    /// Set bit i of visibility when sphere i is not outside the frustum, visibility holds GetVisibilityMaskSize words.
+    ALIMER_API void CullSpheres(const Frustum& frustum, const BoundingSphereArray& spheres, ArrayView<uint32_t> visibility);
+
+    /// Write indices of visible boxes in increasing order and return their count, indices holds one entry per box.
+    ALIMER_API uint32_t CullBoxesToIndices(const Frustum& frustum, const BoundingBoxArray& boxes, ArrayView<uint32_t> indices);
+
+    /// Write indices of visible spheres in increasing order and return their count, indices holds one entry per sphere.
+    ALIMER_API uint32_t CullSpheresToIndices(const Frustum& frustum, const BoundingSphereArray& spheres, ArrayView<uint32_t> indices);
+
+    /// Write indices of the first count bits set in visibility in increasing order and return their count.
+    ALIMER_API uint32_t GetVisibleIndices(ArrayView<const uint32_t> visibility, uint32_t count, ArrayView<uint32_t> indices);
+}
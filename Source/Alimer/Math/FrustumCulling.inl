@@ -0,0 +1,120 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Internal culling kernels shared by FrustumCulling.cpp and the AVX translation unit.
+
+#pragma once
+
+#include "../Math/FrustumCulling.h"
+
+namespace Alimer
+{
+    /// Frustum planes split by component, with absolute normals for the box extents.
+    struct CullingPlanes
+    {
+        float normalX[Frustum::PlaneCount];
+        float normalY[Frustum::PlaneCount];
+        float normalZ[Frustum::PlaneCount];
+        float absNormalX[Frustum::PlaneCount];
+        float absNormalY[Frustum::PlaneCount];
+        float absNormalZ[Frustum::PlaneCount];
+        float distance[Frustum::PlaneCount];
+    };
+
+    struct CullingBoxes
+    {
+        const float* centerX;
+        const float* centerY;
+        const float* centerZ;
+        const float* extentX;
+        const float* extentY;
+        const float* extentZ;
+    };
+
+    struct CullingSpheres
+    {
+        const float* centerX;
+        const float* centerY;
+        const float* centerZ;
+        const float* radius;
+    };
+
+    /// Cull items [begin, end), begin is a multiple of 32 and visibility points to the word of item begin.
+    using CullBoxesFunction = void(*)(const CullingPlanes& planes, const CullingBoxes& boxes, uint32_t begin, uint32_t end, uint32_t* visibility);
+    using CullSpheresFunction = void(*)(const CullingPlanes& planes, const CullingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visibility);
+
+    struct CullingKernelTable
+    {
+        CullBoxesFunction cullBoxes;
+        CullSpheresFunction cullSpheres;
+    };
+
+    /// Fill table with AVX kernels, returns false when they were not compiled in.
+    bool GetAvxCullingKernels(CullingKernelTable& table);
+
+    namespace
+    {
+        // The SIMD kernels evaluate the same expressions in the same order, an item is outside
+        // when (distance to center + projected radius) < 0 for any plane. NaN inputs stay visible.
+
+        inline bool IsBoxVisible(const CullingPlanes& planes, const CullingBoxes& boxes, uint32_t index)
+        {
+            for (uint32_t i = 0; i < Frustum::PlaneCount; i++)
+            {
+                const float distance = planes.normalX[i] * boxes.centerX[index] + planes.normalY[i] * boxes.centerY[index]
+                    + planes.normalZ[i] * boxes.centerZ[index] + planes.distance[i];
+                const float radius = planes.absNormalX[i] * boxes.extentX[index] + planes.absNormalY[i] * boxes.extentY[index]
+                    + planes.absNormalZ[i] * boxes.extentZ[index];
+                if (distance + radius < 0.0f)
+                    return false;
+            }
+
+            return true;
+        }
+
+        inline bool IsSphereVisible(const CullingPlanes& planes, const CullingSpheres& spheres, uint32_t index)
+        {
+            for (uint32_t i = 0; i < Frustum::PlaneCount; i++)
+            {
+                const float distance = planes.normalX[i] * spheres.centerX[index] + planes.normalY[i] * spheres.centerY[index]
+                    + planes.normalZ[i] * spheres.centerZ[index] + planes.distance[i];
+                if (distance + spheres.radius[index] < 0.0f)
+                    return false;
+            }
+
+            return true;
+        }
+
+        /// Visibility bits of items [begin, end), at most 32 items.
+        template <typename Input, bool(*IsVisible)(const CullingPlanes&, const Input&, uint32_t)>
+        inline uint32_t CullWordScalar(const CullingPlanes& planes, const Input& input, uint32_t begin, uint32_t end)
+        {
+            uint32_t word = 0;
+            for (uint32_t i = begin; i < end; i++)
+            {
+                word |= static_cast<uint32_t>(IsVisible(planes, input, i)) << (i - begin);
+            }
+
+            return word;
+        }
+    }
+}
@@ -0,0 +1,179 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Only called after MatrixKernels.cpp detected AVX support. Like MatrixKernelsAVX.cpp, GCC and Clang
+// enable AVX only after FrustumCulling.h so no inline engine function is emitted with VEX encoding.
+
+#include "../Math/FrustumCulling.h"
+
+#if ALIMER_SSE2 && !defined(__AVX__) && defined(__GNUC__)
+#   define ALIMER_AVX_TARGET 1
+#endif
+
+#if ALIMER_SSE2 && (defined(__AVX__) || defined(ALIMER_AVX_TARGET))
+#include <immintrin.h>
+
+#if defined(ALIMER_AVX_TARGET) && defined(__clang__)
+#   pragma clang attribute push(__attribute__((target("avx"))), apply_to = function)
+#elif defined(ALIMER_AVX_TARGET)
+#   pragma GCC push_options
+#   pragma GCC target("avx")
+#endif
+
+#include "../Math/FrustumCulling.inl"
+
+namespace Alimer
+{
+    namespace
+    {
+        struct AvxPlanes
+        {
+            __m256 normalX[Frustum::PlaneCount];
+            __m256 normalY[Frustum::PlaneCount];
+            __m256 normalZ[Frustum::PlaneCount];
+            __m256 absNormalX[Frustum::PlaneCount];
+            __m256 absNormalY[Frustum::PlaneCount];
+            __m256 absNormalZ[Frustum::PlaneCount];
+            __m256 distance[Frustum::PlaneCount];
+
+            explicit AvxPlanes(const CullingPlanes& planes)
+            {
+                for (uint32_t i = 0; i < Frustum::PlaneCount; i++)
+                {
+                    normalX[i] = _mm256_set1_ps(planes.normalX[i]);
+                    normalY[i] = _mm256_set1_ps(planes.normalY[i]);
+                    normalZ[i] = _mm256_set1_ps(planes.normalZ[i]);
+                    absNormalX[i] = _mm256_set1_ps(planes.absNormalX[i]);
+                    absNormalY[i] = _mm256_set1_ps(planes.absNormalY[i]);
+                    absNormalZ[i] = _mm256_set1_ps(planes.absNormalZ[i]);
+                    distance[i] = _mm256_set1_ps(planes.distance[i]);
+                }
+            }
+        };
+
+        /// Visibility bits of the eight boxes starting at index.
+        inline uint32_t CullBoxes8(const AvxPlanes& planes, const CullingBoxes& boxes, uint32_t index)
+        {
+            const __m256 centerX = _mm256_loadu_ps(boxes.centerX + index);
+            const __m256 centerY = _mm256_loadu_ps(boxes.centerY + index);
+            const __m256 centerZ = _mm256_loadu_ps(boxes.centerZ + index);
+            const __m256 extentX = _mm256_loadu_ps(boxes.extentX + index);
+            const __m256 extentY = _mm256_loadu_ps(boxes.extentY + index);
+            const __m256 extentZ = _mm256_loadu_ps(boxes.extentZ + index);
+            __m256 outside = _mm256_setzero_ps();
+            for (uint32_t i = 0; i < Frustum::PlaneCount; i++)
+            {
+                __m256 distance = _mm256_add_ps(_mm256_mul_ps(planes.normalX[i], centerX), _mm256_mul_ps(planes.normalY[i], centerY));
+                distance = _mm256_add_ps(_mm256_add_ps(distance, _mm256_mul_ps(planes.normalZ[i], centerZ)), planes.distance[i]);
+                __m256 radius = _mm256_add_ps(_mm256_mul_ps(planes.absNormalX[i], extentX), _mm256_mul_ps(planes.absNormalY[i], extentY));
+                radius = _mm256_add_ps(radius, _mm256_mul_ps(planes.absNormalZ[i], extentZ));
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+            }
+
+            return static_cast<uint32_t>(_mm256_movemask_ps(outside)) ^ 0xFFu;
+        }
+
+        /// Visibility bits of the eight spheres starting at index.
+        inline uint32_t CullSpheres8(const AvxPlanes& planes, const CullingSpheres& spheres, uint32_t index)
+        {
+            const __m256 centerX = _mm256_loadu_ps(spheres.centerX + index);
+            const __m256 centerY = _mm256_loadu_ps(spheres.centerY + index);
+            const __m256 centerZ = _mm256_loadu_ps(spheres.centerZ + index);
+            const __m256 radius = _mm256_loadu_ps(spheres.radius + index);
+            __m256 outside = _mm256_setzero_ps();
+            for (uint32_t i = 0; i < Frustum::PlaneCount; i++)
+            {
+                __m256 distance = _mm256_add_ps(_mm256_mul_ps(planes.normalX[i], centerX), _mm256_mul_ps(planes.normalY[i], centerY));
+                distance = _mm256_add_ps(_mm256_add_ps(distance, _mm256_mul_ps(planes.normalZ[i], centerZ)), planes.distance[i]);
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+            }
+
+            return static_cast<uint32_t>(_mm256_movemask_ps(outside)) ^ 0xFFu;
+        }
+
+        void CullBoxesAvx(const CullingPlanes& planes, const CullingBoxes& boxes, uint32_t begin, uint32_t end, uint32_t* visibility)
+        {
+            const AvxPlanes avxPlanes(planes);
+            uint32_t i = begin;
+            for (; i + 32 <= end; i += 32)
+            {
+                uint32_t word = 0;
+                for (uint32_t lane = 0; lane < 32; lane += 8)
+                {
+                    word |= CullBoxes8(avxPlanes, boxes, i + lane) << lane;
+                }
+
+                *visibility++ = word;
+            }
+
+            if (i < end)
+            {
+                *visibility = CullWordScalar<CullingBoxes, IsBoxVisible>(planes, boxes, i, end);
+            }
+        }
+
+        void CullSpheresAvx(const CullingPlanes& planes, const CullingSpheres& spheres, uint32_t begin, uint32_t end, uint32_t* visibility)
+        {
+            const AvxPlanes avxPlanes(planes);
+            uint32_t i = begin;
+            for (; i + 32 <= end; i += 32)
+            {
+                uint32_t word = 0;
+                for (uint32_t lane = 0; lane < 32; lane += 8)
+                {
+                    word |= CullSpheres8(avxPlanes, spheres, i + lane) << lane;
+                }
+
+                *visibility++ = word;
+            }
+
+            if (i < end)
+            {
+                *visibility = CullWordScalar<CullingSpheres, IsSphereVisible>(planes, spheres, i, end);
+            }
+        }
+    }
+
+    bool GetAvxCullingKernels(CullingKernelTable& table)
+    {
+        table = { CullBoxesAvx, CullSpheresAvx };
+        return true;
+    }
+}
+
+#if defined(ALIMER_AVX_TARGET) && defined(__clang__)
+#   pragma clang attribute pop
+#elif defined(ALIMER_AVX_TARGET)
+#   pragma GCC pop_options
+#endif
+
+#else
+#include "../Math/FrustumCulling.inl"
+
+namespace Alimer
+{
+    bool GetAvxCullingKernels(CullingKernelTable&)
+    {
+        return false;
+    }
+}
+#endif
@@ -26,6 +26,12 @@
 #include <stdint.h>
 #include <cmath>
 
+#if ALIMER_SSE2
+#   include <xmmintrin.h>
+#elif ALIMER_NEON
+#   include <arm_neon.h>
+#endif
+
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable : 4201 4203 4244 4702) 
@@ -635,6 +641,14 @@ template <typename T> inline tvec4<T> func(const tvec4<T> &a, const tvec4<T> &b,
     // cross
     inline vec3 cross(const vec3 &a, const vec3 &b) { return vec3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x); }
 
+    // length, normalize
+    inline float length(const vec2 &v) { return std::sqrt(dot(v, v)); }
+    inline float length(const vec3 &v) { return std::sqrt(dot(v, v)); }
+    inline float length(const vec4 &v) { return std::sqrt(dot(v, v)); }
+    inline vec2 normalize(const vec2 &v) { return v * (1.0f / length(v)); }
+    inline vec3 normalize(const vec3 &v) { return v * (1.0f / length(v)); }
+    inline vec4 normalize(const vec4 &v) { return v * (1.0f / length(v)); }
+
     // matrix multiply
     inline tvec2<float> operator*(const mat2 &m, const tvec2<float>& v)
     {
@@ -677,14 +691,91 @@ template <typename T> inline tvec4<T> func(const tvec4<T> &a, const tvec4<T> &b,
         return mat4(m[0] / s, m[1] / s, m[2] / s, m[3] / s);
     }
 
+#if ALIMER_SSE2
+    inline __m128 mat4_mul_sse(const __m128 m[4], __m128 v)
+    {
+        __m128 r = _mm_mul_ps(m[0], _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+        r = _mm_add_ps(r, _mm_mul_ps(m[1], _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+        r = _mm_add_ps(r, _mm_mul_ps(m[2], _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+        return _mm_add_ps(r, _mm_mul_ps(m[3], _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+    }
+#elif ALIMER_NEON
+    inline float32x4_t mat4_mul_neon(const float32x4_t m[4], float32x4_t v)
+    {
+        float32x4_t r = vmulq_n_f32(m[0], vgetq_lane_f32(v, 0));
+        r = vmlaq_n_f32(r, m[1], vgetq_lane_f32(v, 1));
+        r = vmlaq_n_f32(r, m[2], vgetq_lane_f32(v, 2));
+        return vmlaq_n_f32(r, m[3], vgetq_lane_f32(v, 3));
+    }
+#endif
+
     inline vec4 operator*(const mat4& m, const vec4& v)
     {
+#if ALIMER_SSE2
+        const __m128 columns[4] = { _mm_loadu_ps(m[0].data), _mm_loadu_ps(m[1].data), _mm_loadu_ps(m[2].data), _mm_loadu_ps(m[3].data) };
+        vec4 result;
+        _mm_storeu_ps(result.data, mat4_mul_sse(columns, _mm_loadu_ps(v.data)));
+        return result;
+#elif ALIMER_NEON
+        const float32x4_t columns[4] = { vld1q_f32(m[0].data), vld1q_f32(m[1].data), vld1q_f32(m[2].data), vld1q_f32(m[3].data) };
+        vec4 result;
+        vst1q_f32(result.data, mat4_mul_neon(columns, vld1q_f32(v.data)));
+        return result;
+#else
         return m[0] * v.x + m[1] * v.y + m[2] * v.z + m[3] * v.w;
+#endif
     }
 
     inline mat4 operator*(const mat4& a, const mat4& b)
     {
+#if ALIMER_SSE2
+        const __m128 columns[4] = { _mm_loadu_ps(a[0].data), _mm_loadu_ps(a[1].data), _mm_loadu_ps(a[2].data), _mm_loadu_ps(a[3].data) };
+        mat4 result(mat4::NO_INIT);
+        for (size_t column = 0; column < 4; column++)
+        {
+            _mm_storeu_ps(result[column].data, mat4_mul_sse(columns, _mm_loadu_ps(b[column].data)));
+        }
+        return result;
+#elif ALIMER_NEON
+        const float32x4_t columns[4] = { vld1q_f32(a[0].data), vld1q_f32(a[1].data), vld1q_f32(a[2].data), vld1q_f32(a[3].data) };
+        mat4 result(mat4::NO_INIT);
+        for (size_t column = 0; column < 4; column++)
+        {
+            vst1q_f32(result[column].data, mat4_mul_neon(columns, vld1q_f32(b[column].data)));
+        }
+        return result;
+#else
         return mat4(a * b[0], a * b[1], a * b[2], a * b[3]);
+#endif
+    }
+
+    // quat operators
+    inline quat conjugate(const quat& q)
+    {
+        return quat(q.w, -q.x, -q.y, -q.z);
+    }
+
+    inline quat normalize(const quat& q)
+    {
+        const float invLength = 1.0f / std::sqrt(dot(q.as_vec4(), q.as_vec4()));
+        return quat(q.as_vec4() * invLength);
+    }
+
+    inline quat operator*(const quat& a, const quat& b)
+    {
+        return quat(
+            a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+            a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w);
+    }
+
+    /// Rotate vector by unit quaternion.
+    inline vec3 operator*(const quat& q, const vec3& v)
+    {
+        const vec3 u(q.x, q.y, q.z);
+        const vec3 t = cross(u, v) * 2.0f;
+        return v + t * q.w + cross(u, t);
     }
 
     inline mat3 mat3_cast(const mat4 &m)
@@ -699,6 +790,29 @@ template <typename T> inline tvec4<T> func(const tvec4<T> &a, const tvec4<T> &b,
         }
         return result;
     }
+
+    inline mat3 mat3_cast(const quat &q)
+    {
+        const float xx = q.x * q.x;
+        const float yy = q.y * q.y;
+        const float zz = q.z * q.z;
+        const float xy = q.x * q.y;
+        const float xz = q.x * q.z;
+        const float yz = q.y * q.z;
+        const float wx = q.w * q.x;
+        const float wy = q.w * q.y;
+        const float wz = q.w * q.z;
+
+        return mat3(
+            tvec3<float>(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy)),
+            tvec3<float>(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx)),
+            tvec3<float>(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy)));
+    }
+
+    inline mat4 mat4_cast(const quat &q)
+    {
+        return mat4(mat3_cast(q));
+    }
 }
 
 #ifdef _MSC_VER
@@ -0,0 +1,184 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Math/MathBatch.h"
+#include "../Math/MatrixKernels.h"
+
+namespace Alimer
+{
+#if ALIMER_SSE2
+    /// Load four vec3 and transpose to x, y and z lanes.
+    static inline void LoadVec3x4(const vec3* source, __m128& x, __m128& y, __m128& z)
+    {
+        const float* data = reinterpret_cast<const float*>(source);
+        const __m128 a = _mm_loadu_ps(data);        // x0 y0 z0 x1
+        const __m128 b = _mm_loadu_ps(data + 4);    // y1 z1 x2 y2
+        const __m128 c = _mm_loadu_ps(data + 8);    // z2 x3 y3 z3
+        x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+        y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+    }
+
+    /// Transpose x, y and z lanes back and store four vec3.
+    static inline void StoreVec3x4(vec3* dest, __m128 x, __m128 y, __m128 z)
+    {
+        const __m128 xy01 = _mm_unpacklo_ps(x, y);
+        const __m128 xy23 = _mm_unpackhi_ps(x, y);
+        const __m128 a = _mm_shuffle_ps(xy01, _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0));
+        const __m128 b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), xy23, _MM_SHUFFLE(1, 0, 2, 0));
+        const __m128 c = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        float* data = reinterpret_cast<float*>(dest);
+        _mm_storeu_ps(data, a);
+        _mm_storeu_ps(data + 4, b);
+        _mm_storeu_ps(data + 8, c);
+    }
+
+    /// r = a * b + c
+    static inline __m128 MultiplyAdd(__m128 a, __m128 b, __m128 c)
+    {
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+    }
+
+    /// Cross product of x, y and z lanes.
+    static inline void Cross(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz, __m128& x, __m128& y, __m128& z)
+    {
+        x = _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by));
+        y = _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz));
+        z = _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx));
+    }
+#endif
+
+    void TransformPoints(const mat4& matrix, ArrayView<const vec3> points, ArrayView<vec3> output)
+    {
+        ALIMER_ASSERT_MSG(points.size() == output.size(), "Size mismatch (%u, %u)", points.size(), output.size());
+
+        const uint32_t count = points.size();
+        const vec3* source = points.data();
+        vec3* dest = output.data();
+        uint32_t i = 0;
+
+#if ALIMER_SSE2
+        const __m128 m00 = _mm_set1_ps(matrix[0].x), m01 = _mm_set1_ps(matrix[0].y), m02 = _mm_set1_ps(matrix[0].z);
+        const __m128 m10 = _mm_set1_ps(matrix[1].x), m11 = _mm_set1_ps(matrix[1].y), m12 = _mm_set1_ps(matrix[1].z);
+        const __m128 m20 = _mm_set1_ps(matrix[2].x), m21 = _mm_set1_ps(matrix[2].y), m22 = _mm_set1_ps(matrix[2].z);
+        const __m128 m30 = _mm_set1_ps(matrix[3].x), m31 = _mm_set1_ps(matrix[3].y), m32 = _mm_set1_ps(matrix[3].z);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x, y, z;
+            LoadVec3x4(source + i, x, y, z);
+            const __m128 rx = MultiplyAdd(m00, x, MultiplyAdd(m10, y, MultiplyAdd(m20, z, m30)));
+            const __m128 ry = MultiplyAdd(m01, x, MultiplyAdd(m11, y, MultiplyAdd(m21, z, m31)));
+            const __m128 rz = MultiplyAdd(m02, x, MultiplyAdd(m12, y, MultiplyAdd(m22, z, m32)));
+            StoreVec3x4(dest + i, rx, ry, rz);
+        }
+#elif ALIMER_NEON
+        for (; i + 4 <= count; i += 4)
+        {
+            const float32x4x3_t v = vld3q_f32(reinterpret_cast<const float*>(source + i));
+            float32x4x3_t r;
+            for (int row = 0; row < 3; row++)
+            {
+                float32x4_t value = vdupq_n_f32(matrix[3][row]);
+                value = vmlaq_n_f32(value, v.val[0], matrix[0][row]);
+                value = vmlaq_n_f32(value, v.val[1], matrix[1][row]);
+                r.val[row] = vmlaq_n_f32(value, v.val[2], matrix[2][row]);
+            }
+            vst3q_f32(reinterpret_cast<float*>(dest + i), r);
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            const vec3 point = source[i];
+            dest[i] = (matrix[0] * point.x + matrix[1] * point.y + matrix[2] * point.z + matrix[3]).xyz();
+        }
+    }
+
+    void MultiplyMatrices(ArrayView<const mat4> a, ArrayView<const mat4> b, ArrayView<mat4> output)
+    {
+        ALIMER_ASSERT_MSG(a.size() == b.size() && a.size() == output.size(), "Size mismatch (%u, %u, %u)", a.size(), b.size(), output.size());
+
+        MultiplyMatrices(a.data(), b.data(), output.data(), a.size());
+    }
+
+    void RotateVectors(ArrayView<const quat> rotations, ArrayView<const vec3> vectors, ArrayView<vec3> output)
+    {
+        ALIMER_ASSERT_MSG(rotations.size() == vectors.size() && vectors.size() == output.size(), "Size mismatch (%u, %u, %u)", rotations.size(), vectors.size(), output.size());
+
+        const uint32_t count = vectors.size();
+        const quat* q = rotations.data();
+        const vec3* source = vectors.data();
+        vec3* dest = output.data();
+        uint32_t i = 0;
+
+#if ALIMER_SSE2
+        const __m128 two = _mm_set1_ps(2.0f);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 qx = _mm_loadu_ps(q[i + 0].as_vec4().data);
+            __m128 qy = _mm_loadu_ps(q[i + 1].as_vec4().data);
+            __m128 qz = _mm_loadu_ps(q[i + 2].as_vec4().data);
+            __m128 qw = _mm_loadu_ps(q[i + 3].as_vec4().data);
+            _MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+
+            __m128 x, y, z;
+            LoadVec3x4(source + i, x, y, z);
+
+            // v' = v + w * t + cross(u, t), t = 2 * cross(u, v)
+            __m128 tx, ty, tz;
+            Cross(qx, qy, qz, x, y, z, tx, ty, tz);
+            tx = _mm_mul_ps(tx, two);
+            ty = _mm_mul_ps(ty, two);
+            tz = _mm_mul_ps(tz, two);
+
+            __m128 cx, cy, cz;
+            Cross(qx, qy, qz, tx, ty, tz, cx, cy, cz);
+            StoreVec3x4(dest + i,
+                _mm_add_ps(MultiplyAdd(qw, tx, x), cx),
+                _mm_add_ps(MultiplyAdd(qw, ty, y), cy),
+                _mm_add_ps(MultiplyAdd(qw, tz, z), cz));
+        }
+#elif ALIMER_NEON
+        for (; i + 4 <= count; i += 4)
+        {
+            const float32x4x4_t r = vld4q_f32(reinterpret_cast<const float*>(q + i));
+            const float32x4x3_t v = vld3q_f32(reinterpret_cast<const float*>(source + i));
+
+            float32x4x3_t t;
+            t.val[0] = vmulq_n_f32(vmlsq_f32(vmulq_f32(r.val[1], v.val[2]), r.val[2], v.val[1]), 2.0f);
+            t.val[1] = vmulq_n_f32(vmlsq_f32(vmulq_f32(r.val[2], v.val[0]), r.val[0], v.val[2]), 2.0f);
+            t.val[2] = vmulq_n_f32(vmlsq_f32(vmulq_f32(r.val[0], v.val[1]), r.val[1], v.val[0]), 2.0f);
+
+            float32x4x3_t result;
+            result.val[0] = vaddq_f32(vmlaq_f32(v.val[0], r.val[3], t.val[0]), vmlsq_f32(vmulq_f32(r.val[1], t.val[2]), r.val[2], t.val[1]));
+            result.val[1] = vaddq_f32(vmlaq_f32(v.val[1], r.val[3], t.val[1]), vmlsq_f32(vmulq_f32(r.val[2], t.val[0]), r.val[0], t.val[2]));
+            result.val[2] = vaddq_f32(vmlaq_f32(v.val[2], r.val[3], t.val[2]), vmlsq_f32(vmulq_f32(r.val[0], t.val[1]), r.val[1], t.val[0]));
+            vst3q_f32(reinterpret_cast<float*>(dest + i), result);
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            dest[i] = q[i] * source[i];
+        }
+    }
+}
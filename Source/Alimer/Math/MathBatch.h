@@ -0,0 +1,38 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Base/Containers.h"
+#include "../Math/Math.h"
+
+namespace Alimer
+{
+    /// Transform points (w = 1) by affine matrix, output may alias input.
+    ALIMER_API void TransformPoints(const mat4& matrix, ArrayView<const vec3> points, ArrayView<vec3> output);
+
+    /// Multiply matrices pairwise, output[i] = a[i] * b[i].
+    ALIMER_API void MultiplyMatrices(ArrayView<const mat4> a, ArrayView<const mat4> b, ArrayView<mat4> output);
+
+    /// Rotate vectors by unit quaternions pairwise, output may alias vectors.
+    ALIMER_API void RotateVectors(ArrayView<const quat> rotations, ArrayView<const vec3> vectors, ArrayView<vec3> output);
+}
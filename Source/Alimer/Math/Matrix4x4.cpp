@@ -23,19 +23,20 @@
 // SIMD code adopted from DirectXMath: https://github.com/Microsoft/DirectXMath
 
 #include "../Math/Matrix4x4.h"
+#include "../Math/MatrixKernels.h"
 #include "../Core/Log.h"
 #include <cstdio>
 
 #if defined(__AVX2__)
 #   define SIMD_PERMUTE_PS( v, c ) _mm_permute_ps( v, c )
-#elif defined(ALIMER_SSE2)
+#elif ALIMER_SSE2
 #   define SIMD_PERMUTE_PS( v, c ) _mm_shuffle_ps( v, v, c )
 #endif
 
 #if ALIMER_SSE2
 namespace Alimer
 {
-    __declspec(align(16)) struct SimdFloat32
+    struct alignas(16) SimdFloat32
     {
         union
         {
@@ -49,7 +50,7 @@ namespace Alimer
         inline operator __m128d() const { return _mm_castps_pd(v); }
     };
 
-    __declspec(align(16)) struct SimdMatrix
+    struct alignas(16) SimdMatrix
     {
         __m128 data[4];
 
@@ -119,72 +120,8 @@ namespace Alimer
 
     void Matrix4x4::Decompose(vec3 &scale, quat &rotation, vec3 &trans)
     {
-        vec4 rot;
-
-        // Make a lot of assumptions.
-        // We don't need skew, nor perspective.
-
-        // Isolate translation.
-        trans = Column(3).xyz();
-
-        ALIMER_UNUSED(scale);
-        ALIMER_UNUSED(rotation);
-
-        /*vec3 cols[3];
-        cols[0] = Column(0).xyz();
-        cols[1] = Column(1).xyz();
-        cols[2] = Column(2).xyz();
-
-        scale.x = length(cols[0]);
-        scale.y = length(cols[1]);
-        scale.z = length(cols[2]);
-
-        // Isolate scale.
-        cols[0] /= scale.x;
-        cols[1] /= scale.y;
-        cols[2] /= scale.z;
-
-        vec3 pdum3 = cross(cols[1], cols[2]);
-        if (dot(cols[0], pdum3) < 0.0f)
-        {
-            scale = -scale;
-            cols[0] = -cols[0];
-            cols[1] = -cols[1];
-            cols[2] = -cols[2];
-        }
-
-        int i, j, k = 0;
-        float root, trace = cols[0].x + cols[1].y + cols[2].z;
-        if (trace > 0.0f)
-        {
-            root = sqrt(trace + 1.0f);
-            rot.w = 0.5f * root;
-            root = 0.5f / root;
-            rot.x = root * (cols[1].z - cols[2].y);
-            rot.y = root * (cols[2].x - cols[0].z);
-            rot.z = root * (cols[0].y - cols[1].x);
-        }
-        else
-        {
-            static const int Next[3] = { 1, 2, 0 };
-
-            i = 0;
-            if (cols[1].y > cols[0].x) i = 1;
-            if (cols[2].z > cols[i][i]) i = 2;
-
-            j = Next[i];
-            k = Next[j];
-
-            root = sqrt(cols[i][i] - cols[j][j] - cols[k][k] + 1.0f);
-
-            rot[i] = 0.5f * root;
-            root = 0.5f / root;
-            rot[j] = root * (cols[i][j] + cols[j][i]);
-            rot[k] = root * (cols[i][k] + cols[k][i]);
-            rot.w = root * (cols[j][k] - cols[k][j]);
-        }*/
-
-        rotation = quat(rot);
+        // Translation is stored in the last column.
+        decompose(mat4(Column(0), Column(1), Column(2), Column(3)), scale, rotation, trans);
     }
 
     String Matrix4x4::ToString() const
@@ -207,7 +144,7 @@ namespace Alimer
 
     void Matrix4x4::Transpose(Matrix4x4& result) const
     {
-#ifdef ALIMER_SSE2
+#if ALIMER_SSE2
         __m128 m0 = _mm_loadu_ps(&m11);
         __m128 m1 = _mm_loadu_ps(&m21);
         __m128 m2 = _mm_loadu_ps(&m31);
@@ -239,73 +176,19 @@ namespace Alimer
 
     Matrix4x4 Matrix4x4::Inverse() const
     {
-        float v0 = m31 * m42 - m32 * m41;
-        float v1 = m31 * m43 - m33 * m41;
-        float v2 = m31 * m44 - m34 * m41;
-        float v3 = m32 * m43 - m33 * m42;
-        float v4 = m32 * m44 - m34 * m42;
-        float v5 = m33 * m44 - m34 * m43;
-
-        float i00 = (v5 * m22 - v4 * m23 + v3 * m24);
-        float i10 = -(v5 * m21 - v2 * m23 + v1 * m24);
-        float i20 = (v4 * m21 - v2 * m22 + v0 * m24);
-        float i30 = -(v3 * m21 - v1 * m22 + v0 * m23);
-
-        float invDet = 1.0f / (i00 * m11 + i10 * m21 + i20 * m13 + i30 * m14);
-
-        i00 *= invDet;
-        i10 *= invDet;
-        i20 *= invDet;
-        i30 *= invDet;
-
-        float i01 = -(v5 * m12 - v4 * m13 + v3 * m14) * invDet;
-        float i11 = (v5 * m11 - v2 * m13 + v1 * m14) * invDet;
-        float i21 = -(v4 * m11 - v2 * m21 + v0 * m14) * invDet;
-        float i31 = (v3 * m11 - v1 * m21 + v0 * m13) * invDet;
-
-        v0 = m21 * m42 - m22 * m41;
-        v1 = m21 * m43 - m23 * m41;
-        v2 = m21 * m44 - m24 * m41;
-        v3 = m22 * m43 - m23 * m42;
-        v4 = m22 * m44 - m24 * m42;
-        v5 = m23 * m44 - m24 * m43;
-
-        float i02 = (v5 * m12 - v4 * m13 + v3 * m14) * invDet;
-        float i12 = -(v5 * m11 - v2 * m13 + v1 * m14) * invDet;
-        float i22 = (v4 * m11 - v2 * m12 + v0 * m14) * invDet;
-        float i32 = -(v3 * m11 - v1 * m12 + v0 * m13) * invDet;
-
-        v0 = m32 * m21 - m31 * m22;
-        v1 = m33 * m21 - m31 * m13;
-        v2 = m34 * m21 - m31 * m24;
-        v3 = m33 * m22 - m32 * m23;
-        v4 = m34 * m22 - m32 * m24;
-        v5 = m34 * m23 - m33 * m24;
-
-        float i03 = -(v5 * m12 - v4 * m13 + v3 * m14) * invDet;
-        float i13 = (v5 * m11 - v2 * m13 + v1 * m14) * invDet;
-        float i23 = -(v4 * m11 - v2 * m12 + v0 * m14) * invDet;
-        float i33 = (v3 * m11 - v1 * m12 + v0 * m13) * invDet;
-
-        return Matrix4x4(
-            i00, i01, i02, i03,
-            i10, i11, i12, i13,
-            i20, i21, i22, i23,
-            i30, i31, i32, i33);
+        // inverse(transpose(M)) == transpose(inverse(M)), the storage order does not matter.
+        const mat4 matrix = inverse(mat4(Row(0), Row(1), Row(2), Row(3)));
+        return Matrix4x4(matrix[0], matrix[1], matrix[2], matrix[3]);
     }
 
     Matrix4x4 Matrix4x4::CreateLookAt(const vec3 &eye, const vec3 &target, const vec3 &up)
     {
-        /*vec3 const f(normalize(target - eye));
-        vec3 const s(normalize(cross(f, up)));
-        vec3 const u(cross(s, f));*/
-
-        ALIMER_UNUSED(eye);
-        ALIMER_UNUSED(target);
-        ALIMER_UNUSED(up);
+        const vec3 f(normalize(target - eye));
+        const vec3 s(normalize(cross(f, up)));
+        const vec3 u(cross(s, f));
 
         Matrix4x4 result;
-        /*result.data[0][0] = s.x;
+        result.data[0][0] = s.x;
         result.data[1][0] = s.y;
         result.data[2][0] = s.z;
         result.data[0][1] = u.x;
@@ -316,7 +199,7 @@ namespace Alimer
         result.data[2][2] = -f.z;
         result.data[3][0] = -dot(s, eye);
         result.data[3][1] = -dot(u, eye);
-        result.data[3][2] = dot(f, eye);*/
+        result.data[3][2] = dot(f, eye);
         return result;
     }
 
@@ -43,7 +43,7 @@
 #   endif
 #endif /* ALIMER_SIMD */
 
-#ifdef ALIMER_SSE2
+#if ALIMER_SSE2
 #   include <xmmintrin.h>
 #   include <emmintrin.h>
 #endif /* ALIMER_SSE2 */
@@ -141,7 +141,7 @@ namespace Alimer
         // Comparison operators
         bool operator == (const Matrix4x4& rhs) const
         {
-#ifdef ALIMER_SSE2
+#if ALIMER_SSE2
             __m128 c0 = _mm_cmpeq_ps(_mm_loadu_ps(&m11), _mm_loadu_ps(&rhs.m11));
             __m128 c1 = _mm_cmpeq_ps(_mm_loadu_ps(&m21), _mm_loadu_ps(&rhs.m21));
             c0 = _mm_and_ps(c0, c1);
@@ -173,7 +173,7 @@ namespace Alimer
         /// Multiply a Vector3 which is assumed to represent position.
         vec3 operator *(const vec3& rhs) const
         {
-#ifdef ALIMER_SSE2
+#if ALIMER_SSE2
             __m128 vec = _mm_set_ps(1.f, rhs.z, rhs.y, rhs.x);
             __m128 r0 = _mm_mul_ps(_mm_loadu_ps(&m11), vec);
             __m128 r1 = _mm_mul_ps(_mm_loadu_ps(&m21), vec);
@@ -194,7 +194,7 @@ namespace Alimer
 #else
             float invW = 1.0f / (m41 * rhs.x + m42 * rhs.y + m43 * rhs.z + m44);
 
-            return Vector3(
+            return vec3(
                 (m11 * rhs.x + m12 * rhs.y + m13 * rhs.z + m14) * invW,
                 (m21 * rhs.x + m22 * rhs.y + m23 * rhs.z + m24) * invW,
                 (m31 * rhs.x + m32 * rhs.y + m33 * rhs.z + m34) * invW
@@ -205,7 +205,7 @@ namespace Alimer
         /// Multiply a Vector4.
         vec4 operator *(const vec4& rhs) const
         {
-#ifdef ALIMER_SSE2
+#if ALIMER_SSE2
             __m128 vec = _mm_loadu_ps(&rhs.x);
             __m128 r0 = _mm_mul_ps(_mm_loadu_ps(&m11), vec);
             __m128 r1 = _mm_mul_ps(_mm_loadu_ps(&m21), vec);
@@ -223,8 +223,8 @@ namespace Alimer
             _mm_storeu_ps(&ret.x, vec);
             return ret;
 #else
-            return Vector4(
-                m11 * rhs.x + m21 * rhs.y + m31 * rhs.z + m41 * rhs.w,
+            return vec4(
+                m11 * rhs.x + m12 * rhs.y + m13 * rhs.z + m14 * rhs.w,
                 m21 * rhs.x + m22 * rhs.y + m23 * rhs.z + m24 * rhs.w,
                 m31 * rhs.x + m32 * rhs.y + m33 * rhs.z + m34 * rhs.w,
                 m41 * rhs.x + m42 * rhs.y + m43 * rhs.z + m44 * rhs.w
@@ -235,7 +235,7 @@ namespace Alimer
         /// Add a matrix.
         Matrix4x4 operator +(const Matrix4x4& rhs) const
         {
-#ifdef ALIMER_SSE2
+#if ALIMER_SSE2
             Matrix4x4 result;
             _mm_storeu_ps(&result.m11, _mm_add_ps(_mm_loadu_ps(&m11), _mm_loadu_ps(&rhs.m11)));
             _mm_storeu_ps(&result.m21, _mm_add_ps(_mm_loadu_ps(&m21), _mm_loadu_ps(&rhs.m21)));
@@ -244,7 +244,7 @@ namespace Alimer
             return result;
 #else
             return Matrix4x4(
-                m11 + rhs.m12,
+                m11 + rhs.m11,
                 m12 + rhs.m12,
                 m13 + rhs.m13,
                 m14 + rhs.m14,
@@ -267,7 +267,7 @@ namespace Alimer
         /// Subtract a matrix.
         Matrix4x4 operator -(const Matrix4x4& rhs) const
         {
-#ifdef ALIMER_SSE2
+#if ALIMER_SSE2
             Matrix4x4 result;
             _mm_storeu_ps(&result.m11, _mm_sub_ps(_mm_loadu_ps(&m11), _mm_loadu_ps(&rhs.m11)));
             _mm_storeu_ps(&result.m21, _mm_sub_ps(_mm_loadu_ps(&m21), _mm_loadu_ps(&rhs.m21)));
@@ -276,7 +276,7 @@ namespace Alimer
             return result;
 #else
             return Matrix4x4(
-                m11 - rhs.m12,
+                m11 - rhs.m11,
                 m12 - rhs.m12,
                 m13 - rhs.m13,
                 m14 - rhs.m14,
@@ -299,7 +299,7 @@ namespace Alimer
         /// Multiply with a scalar.
         Matrix4x4 operator *(float rhs) const
         {
-#ifdef ALIMER_SSE2
+#if ALIMER_SSE2
             const __m128 mul = _mm_set1_ps(rhs);
             Matrix4x4 result;
             _mm_storeu_ps(&result.m11, _mm_mul_ps(_mm_loadu_ps(&m11), mul));
@@ -332,7 +332,7 @@ namespace Alimer
         /// Multiply a matrix.
         Matrix4x4 operator *(const Matrix4x4& rhs) const
         {
-#ifdef ALIMER_SSE2
+#if ALIMER_SSE2
             Matrix4x4 result;
 
             __m128 r0 = _mm_loadu_ps(&rhs.m11);
@@ -0,0 +1,161 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Math/MatrixKernels.h"
+#include "../Math/MatrixKernels.inl"
+
+#if ALIMER_SSE2
+#   if ALIMER_COMPILER_MSVC
+#       include <intrin.h>
+#   else
+#       include <cpuid.h>
+#   endif
+#endif
+
+namespace Alimer
+{
+    static SimdLevel DetectSimdLevel()
+    {
+#if ALIMER_SSE2
+        int info[4] = {};
+#   if ALIMER_COMPILER_MSVC
+        __cpuid(info, 1);
+#   else
+        __cpuid(1, info[0], info[1], info[2], info[3]);
+#   endif
+
+        // AVX needs both CPU support and OS support for saving the ymm state.
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (osxsave && avx)
+        {
+#   if ALIMER_COMPILER_MSVC
+            const uint64_t xcr0 = _xgetbv(0);
+#   else
+            uint32_t eax, edx;
+            __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            const uint64_t xcr0 = (uint64_t(edx) << 32) | eax;
+#   endif
+            MatrixKernelTable table;
+            if ((xcr0 & 6) == 6 && GetAvxMatrixKernels(table))
+            {
+                return SimdLevel::AVX;
+            }
+        }
+
+        return SimdLevel::SSE2;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+
+    static MatrixKernelTable CreateKernelTable(SimdLevel level)
+    {
+        MatrixKernelTable table = {
+            MultiplyMatricesKernel<ScalarOps>,
+            InverseMatricesKernel<ScalarOps>,
+            InverseAffineMatricesKernel<ScalarOps>,
+            DecomposeKernel<ScalarOps>
+        };
+
+#if ALIMER_SSE2
+        if (level >= SimdLevel::SSE2)
+        {
+            table = {
+                MultiplyMatricesKernel<SseOps>,
+                InverseMatricesKernel<SseOps>,
+                InverseAffineMatricesKernel<SseOps>,
+                DecomposeKernel<SseOps>
+            };
+        }
+
+        if (level >= SimdLevel::AVX)
+        {
+            GetAvxMatrixKernels(table);
+        }
+#endif
+
+        return table;
+    }
+
+    struct MatrixKernelState
+    {
+        SimdLevel level;
+        MatrixKernelTable kernels;
+    };
+
+    static MatrixKernelState& GetState()
+    {
+        static MatrixKernelState state = { GetSupportedSimdLevel(), CreateKernelTable(GetSupportedSimdLevel()) };
+        return state;
+    }
+
+    SimdLevel GetSupportedSimdLevel()
+    {
+        static const SimdLevel level = DetectSimdLevel();
+        return level;
+    }
+
+    SimdLevel GetSimdLevel()
+    {
+        return GetState().level;
+    }
+
+    void SetSimdLevel(SimdLevel level)
+    {
+        MatrixKernelState& state = GetState();
+        state.level = level < GetSupportedSimdLevel() ? level : GetSupportedSimdLevel();
+        state.kernels = CreateKernelTable(state.level);
+    }
+
+    const char* GetSimdLevelName(SimdLevel level)
+    {
+        switch (level)
+        {
+        case SimdLevel::Scalar: return "Scalar";
+        case SimdLevel::SSE2: return "SSE2";
+        case SimdLevel::AVX: return "AVX";
+        }
+
+        return "Unknown";
+    }
+
+    void MultiplyMatrices(const mat4* a, const mat4* b, mat4* output, uint32_t count)
+    {
+        GetState().kernels.multiply(a, b, output, count);
+    }
+
+    void InverseMatrices(const mat4* matrices, mat4* output, uint32_t count)
+    {
+        GetState().kernels.inverse(matrices, output, count);
+    }
+
+    void InverseAffineMatrices(const mat4* matrices, mat4* output, uint32_t count)
+    {
+        GetState().kernels.inverseAffine(matrices, output, count);
+    }
+
+    void decompose(const mat4& matrix, vec3& scale, quat& rotation, vec3& translation)
+    {
+        GetState().kernels.decompose(matrix, scale, rotation, translation);
+    }
+}
@@ -0,0 +1,77 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Math/Math.h"
+
+namespace Alimer
+{
+    /// Instruction set used by the math kernels.
+    enum class SimdLevel : uint32_t
+    {
+        Scalar,
+        SSE2,
+        AVX
+    };
+
+    /// Get the best level supported by the CPU, detected once with CPUID.
+    ALIMER_API SimdLevel GetSupportedSimdLevel();
+
+    /// Get the level used by the math kernels.
+    ALIMER_API SimdLevel GetSimdLevel();
+
+    /// Select math kernels, clamped to the supported level. Not thread safe, meant for startup and benchmarks.
+    ALIMER_API void SetSimdLevel(SimdLevel level);
+
+    /// Get level name.
+    ALIMER_API const char* GetSimdLevelName(SimdLevel level);
+
+    // Every level runs the same operations in the same order without fused multiply-add,
+    // results are bit identical (0 ULP) to the Scalar level. Multiply also matches mat4 operator*.
+
+    /// Multiply matrices pairwise, output[i] = a[i] * b[i].
+    ALIMER_API void MultiplyMatrices(const mat4* a, const mat4* b, mat4* output, uint32_t count);
+
+    /// Invert matrices, singular matrices give non finite results.
+    ALIMER_API void InverseMatrices(const mat4* matrices, mat4* output, uint32_t count);
+
+    /// Invert matrices whose last row is (0, 0, 0, 1).
+    ALIMER_API void InverseAffineMatrices(const mat4* matrices, mat4* output, uint32_t count);
+
+    /// Decompose affine matrix without skew into scale, rotation and translation.
+    ALIMER_API void decompose(const mat4& matrix, vec3& scale, quat& rotation, vec3& translation);
+
+    inline mat4 inverse(const mat4& matrix)
+    {
+        mat4 result(mat4::NO_INIT);
+        InverseMatrices(&matrix, &result, 1);
+        return result;
+    }
+
+    inline mat4 inverse_affine(const mat4& matrix)
+    {
+        mat4 result(mat4::NO_INIT);
+        InverseAffineMatrices(&matrix, &result, 1);
+        return result;
+    }
+}
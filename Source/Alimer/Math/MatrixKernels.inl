@@ -0,0 +1,373 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Matrix kernels written once against a 4 lane vector interface, included by MatrixKernels.cpp
+// and MatrixKernelsAVX.cpp. Every level runs the same operations in the same order which keeps
+// the results bit identical. The anonymous namespace gives each translation unit its own copy,
+// so code built with AVX enabled is never merged with the baseline instantiations.
+
+#pragma once
+
+#include "../Math/Math.h"
+
+namespace Alimer
+{
+    /// Kernels of one level, filled by MatrixKernels.cpp and MatrixKernelsAVX.cpp.
+    struct MatrixKernelTable
+    {
+        void(*multiply)(const mat4*, const mat4*, mat4*, uint32_t);
+        void(*inverse)(const mat4*, mat4*, uint32_t);
+        void(*inverseAffine)(const mat4*, mat4*, uint32_t);
+        void(*decompose)(const mat4&, vec3&, quat&, vec3&);
+    };
+
+    /// Defined in MatrixKernelsAVX.cpp, returns false when built without AVX support.
+    bool GetAvxMatrixKernels(MatrixKernelTable& table);
+
+    namespace
+    {
+        /// Scalar emulation of a 4 lane vector, the portable reference level.
+        struct ScalarOps
+        {
+            struct V
+            {
+                float lanes[4];
+            };
+
+            static inline V Load(const float* data) { return V{ { data[0], data[1], data[2], data[3] } }; }
+            static inline void Store(float* data, V v) { data[0] = v.lanes[0]; data[1] = v.lanes[1]; data[2] = v.lanes[2]; data[3] = v.lanes[3]; }
+            static inline V Constant(float x, float y, float z, float w) { return V{ { x, y, z, w } }; }
+            static inline V Add(V a, V b) { return V{ { a.lanes[0] + b.lanes[0], a.lanes[1] + b.lanes[1], a.lanes[2] + b.lanes[2], a.lanes[3] + b.lanes[3] } }; }
+            static inline V Sub(V a, V b) { return V{ { a.lanes[0] - b.lanes[0], a.lanes[1] - b.lanes[1], a.lanes[2] - b.lanes[2], a.lanes[3] - b.lanes[3] } }; }
+            static inline V Mul(V a, V b) { return V{ { a.lanes[0] * b.lanes[0], a.lanes[1] * b.lanes[1], a.lanes[2] * b.lanes[2], a.lanes[3] * b.lanes[3] } }; }
+            static inline V Div(V a, V b) { return V{ { a.lanes[0] / b.lanes[0], a.lanes[1] / b.lanes[1], a.lanes[2] / b.lanes[2], a.lanes[3] / b.lanes[3] } }; }
+            static inline V Sqrt(V a) { return V{ { std::sqrt(a.lanes[0]), std::sqrt(a.lanes[1]), std::sqrt(a.lanes[2]), std::sqrt(a.lanes[3]) } }; }
+
+            /// Returns (a[X], a[Y], b[Z], b[W]), same as _mm_shuffle_ps.
+            template <int X, int Y, int Z, int W>
+            static inline V Shuffle(V a, V b) { return V{ { a.lanes[X], a.lanes[Y], b.lanes[Z], b.lanes[W] } }; }
+        };
+
+#if ALIMER_SSE2
+        struct SseOps
+        {
+            using V = __m128;
+
+            static inline V Load(const float* data) { return _mm_loadu_ps(data); }
+            static inline void Store(float* data, V v) { _mm_storeu_ps(data, v); }
+            static inline V Constant(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+            static inline V Add(V a, V b) { return _mm_add_ps(a, b); }
+            static inline V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+            static inline V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+            static inline V Div(V a, V b) { return _mm_div_ps(a, b); }
+            static inline V Sqrt(V a) { return _mm_sqrt_ps(a); }
+
+            template <int X, int Y, int Z, int W>
+            static inline V Shuffle(V a, V b) { return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X)); }
+        };
+#endif
+
+        template <class Ops>
+        inline typename Ops::V Splat0(typename Ops::V v) { return Ops::template Shuffle<0, 0, 0, 0>(v, v); }
+        template <class Ops>
+        inline typename Ops::V Splat1(typename Ops::V v) { return Ops::template Shuffle<1, 1, 1, 1>(v, v); }
+        template <class Ops>
+        inline typename Ops::V Splat2(typename Ops::V v) { return Ops::template Shuffle<2, 2, 2, 2>(v, v); }
+        template <class Ops>
+        inline typename Ops::V Splat3(typename Ops::V v) { return Ops::template Shuffle<3, 3, 3, 3>(v, v); }
+
+        /// xyz cross product, w lane is zero for finite input.
+        template <class Ops>
+        inline typename Ops::V Cross3(typename Ops::V a, typename Ops::V b)
+        {
+            const typename Ops::V left = Ops::Mul(Ops::template Shuffle<1, 2, 0, 3>(a, a), Ops::template Shuffle<2, 0, 1, 3>(b, b));
+            const typename Ops::V right = Ops::Mul(Ops::template Shuffle<2, 0, 1, 3>(a, a), Ops::template Shuffle<1, 2, 0, 3>(b, b));
+            return Ops::Sub(left, right);
+        }
+
+        /// Transpose xyz of three vectors, w lanes of the result are zero.
+        template <class Ops>
+        inline void Transpose3(typename Ops::V a, typename Ops::V b, typename Ops::V c, typename Ops::V out[3])
+        {
+            using V = typename Ops::V;
+            const V zero = Ops::Constant(0.0f, 0.0f, 0.0f, 0.0f);
+            const V t0 = Ops::template Shuffle<0, 1, 0, 1>(a, b);
+            const V t1 = Ops::template Shuffle<2, 3, 2, 3>(a, b);
+            const V t2 = Ops::template Shuffle<0, 1, 0, 1>(c, zero);
+            const V t3 = Ops::template Shuffle<2, 3, 2, 3>(c, zero);
+            out[0] = Ops::template Shuffle<0, 2, 0, 2>(t0, t2);
+            out[1] = Ops::template Shuffle<1, 3, 1, 3>(t0, t2);
+            out[2] = Ops::template Shuffle<0, 2, 0, 2>(t1, t3);
+        }
+
+        /// result[j] = a * b[j], columns in the same order as mat4 operator*.
+        template <class Ops>
+        inline void MultiplyKernel(const typename Ops::V a[4], const typename Ops::V b[4], typename Ops::V result[4])
+        {
+            for (int column = 0; column < 4; column++)
+            {
+                const typename Ops::V v = b[column];
+                typename Ops::V r = Ops::Mul(a[0], Splat0<Ops>(v));
+                r = Ops::Add(r, Ops::Mul(a[1], Splat1<Ops>(v)));
+                r = Ops::Add(r, Ops::Mul(a[2], Splat2<Ops>(v)));
+                result[column] = Ops::Add(r, Ops::Mul(a[3], Splat3<Ops>(v)));
+            }
+        }
+
+        // 2x2 blocks stored as (m00, m01, m10, m11).
+        template <class Ops>
+        inline typename Ops::V Mat2Mul(typename Ops::V a, typename Ops::V b)
+        {
+            return Ops::Add(
+                Ops::Mul(a, Ops::template Shuffle<0, 3, 0, 3>(b, b)),
+                Ops::Mul(Ops::template Shuffle<1, 0, 3, 2>(a, a), Ops::template Shuffle<2, 1, 2, 1>(b, b)));
+        }
+
+        /// adjugate(a) * b
+        template <class Ops>
+        inline typename Ops::V Mat2AdjMul(typename Ops::V a, typename Ops::V b)
+        {
+            return Ops::Sub(
+                Ops::Mul(Ops::template Shuffle<3, 3, 0, 0>(a, a), b),
+                Ops::Mul(Ops::template Shuffle<1, 1, 2, 2>(a, a), Ops::template Shuffle<2, 3, 0, 1>(b, b)));
+        }
+
+        /// a * adjugate(b)
+        template <class Ops>
+        inline typename Ops::V Mat2MulAdj(typename Ops::V a, typename Ops::V b)
+        {
+            return Ops::Sub(
+                Ops::Mul(a, Ops::template Shuffle<3, 0, 3, 0>(b, b)),
+                Ops::Mul(Ops::template Shuffle<1, 0, 3, 2>(a, a), Ops::template Shuffle<2, 1, 2, 1>(b, b)));
+        }
+
+        /// General inverse with the 2x2 block method, singular input gives non finite results.
+        template <class Ops>
+        inline void InverseKernel(const typename Ops::V m[4], typename Ops::V result[4])
+        {
+            using V = typename Ops::V;
+
+            // Sub matrices.
+            const V A = Ops::template Shuffle<0, 1, 0, 1>(m[0], m[1]);
+            const V B = Ops::template Shuffle<2, 3, 2, 3>(m[0], m[1]);
+            const V C = Ops::template Shuffle<0, 1, 0, 1>(m[2], m[3]);
+            const V D = Ops::template Shuffle<2, 3, 2, 3>(m[2], m[3]);
+
+            // Determinants as (|A|, |B|, |C|, |D|).
+            const V detSub = Ops::Sub(
+                Ops::Mul(Ops::template Shuffle<0, 2, 0, 2>(m[0], m[2]), Ops::template Shuffle<1, 3, 1, 3>(m[1], m[3])),
+                Ops::Mul(Ops::template Shuffle<1, 3, 1, 3>(m[0], m[2]), Ops::template Shuffle<0, 2, 0, 2>(m[1], m[3])));
+            const V detA = Splat0<Ops>(detSub);
+            const V detB = Splat1<Ops>(detSub);
+            const V detC = Splat2<Ops>(detSub);
+            const V detD = Splat3<Ops>(detSub);
+
+            const V D_C = Mat2AdjMul<Ops>(D, C);
+            const V A_B = Mat2AdjMul<Ops>(A, B);
+            V X = Ops::Sub(Ops::Mul(detD, A), Mat2Mul<Ops>(B, D_C));
+            V W = Ops::Sub(Ops::Mul(detA, D), Mat2Mul<Ops>(C, A_B));
+            V Y = Ops::Sub(Ops::Mul(detB, C), Mat2MulAdj<Ops>(D, A_B));
+            V Z = Ops::Sub(Ops::Mul(detC, B), Mat2MulAdj<Ops>(A, D_C));
+
+            // |M| = |A| |D| + |B| |C| - tr((A# B)(D# C))
+            V trace = Ops::Mul(A_B, Ops::template Shuffle<0, 2, 1, 3>(D_C, D_C));
+            trace = Ops::Add(trace, Ops::template Shuffle<2, 3, 0, 1>(trace, trace));
+            trace = Ops::Add(trace, Ops::template Shuffle<1, 0, 3, 2>(trace, trace));
+            const V det = Ops::Sub(Ops::Add(Ops::Mul(detA, detD), Ops::Mul(detB, detC)), trace);
+
+            const V invDet = Ops::Div(Ops::Constant(1.0f, -1.0f, -1.0f, 1.0f), det);
+            X = Ops::Mul(X, invDet);
+            Y = Ops::Mul(Y, invDet);
+            Z = Ops::Mul(Z, invDet);
+            W = Ops::Mul(W, invDet);
+
+            // Adjugate shuffle combined with the store shuffle.
+            result[0] = Ops::template Shuffle<3, 1, 3, 1>(X, Y);
+            result[1] = Ops::template Shuffle<2, 0, 2, 0>(X, Y);
+            result[2] = Ops::template Shuffle<3, 1, 3, 1>(Z, W);
+            result[3] = Ops::template Shuffle<2, 0, 2, 0>(Z, W);
+        }
+
+        /// Inverse of matrix whose last row is (0, 0, 0, 1).
+        template <class Ops>
+        inline void InverseAffineKernel(const typename Ops::V m[4], typename Ops::V result[4])
+        {
+            using V = typename Ops::V;
+
+            // Rows of the adjugate of the upper 3x3.
+            V r0 = Cross3<Ops>(m[1], m[2]);
+            V r1 = Cross3<Ops>(m[2], m[0]);
+            V r2 = Cross3<Ops>(m[0], m[1]);
+
+            const V dot = Ops::Mul(m[0], r0);
+            const V det = Ops::Add(Ops::Add(Splat0<Ops>(dot), Splat1<Ops>(dot)), Splat2<Ops>(dot));
+            const V invDet = Ops::Div(Ops::Constant(1.0f, 1.0f, 1.0f, 1.0f), det);
+            r0 = Ops::Mul(r0, invDet);
+            r1 = Ops::Mul(r1, invDet);
+            r2 = Ops::Mul(r2, invDet);
+
+            Transpose3<Ops>(r0, r1, r2, result);
+
+            // -(R^-1 t), w lane becomes one.
+            const V t = m[3];
+            V p = Ops::Mul(result[0], Splat0<Ops>(t));
+            p = Ops::Add(p, Ops::Mul(result[1], Splat1<Ops>(t)));
+            p = Ops::Add(p, Ops::Mul(result[2], Splat2<Ops>(t)));
+            result[3] = Ops::Sub(Ops::Constant(0.0f, 0.0f, 0.0f, 1.0f), p);
+        }
+
+        /// Rotation from orthonormal columns, shared by every level.
+        inline quat QuaternionFromColumns(const float columns[3][4])
+        {
+            vec4 rotation;
+            const float trace = columns[0][0] + columns[1][1] + columns[2][2];
+            if (trace > 0.0f)
+            {
+                float root = std::sqrt(trace + 1.0f);
+                rotation.w = 0.5f * root;
+                root = 0.5f / root;
+                rotation.x = root * (columns[1][2] - columns[2][1]);
+                rotation.y = root * (columns[2][0] - columns[0][2]);
+                rotation.z = root * (columns[0][1] - columns[1][0]);
+            }
+            else
+            {
+                static const int Next[3] = { 1, 2, 0 };
+
+                int i = 0;
+                if (columns[1][1] > columns[0][0]) i = 1;
+                if (columns[2][2] > columns[i][i]) i = 2;
+
+                const int j = Next[i];
+                const int k = Next[j];
+
+                float root = std::sqrt(columns[i][i] - columns[j][j] - columns[k][k] + 1.0f);
+                rotation[i] = 0.5f * root;
+                root = 0.5f / root;
+                rotation[j] = root * (columns[i][j] + columns[j][i]);
+                rotation[k] = root * (columns[i][k] + columns[k][i]);
+                rotation.w = root * (columns[j][k] - columns[k][j]);
+            }
+
+            return quat(rotation);
+        }
+
+        /// Decompose affine matrix without skew.
+        template <class Ops>
+        inline void DecomposeKernel(const mat4& matrix, vec3& scale, quat& rotation, vec3& translation)
+        {
+            using V = typename Ops::V;
+
+            V columns[3] = { Ops::Load(matrix[0].data), Ops::Load(matrix[1].data), Ops::Load(matrix[2].data) };
+            V rows[3];
+            Transpose3<Ops>(columns[0], columns[1], columns[2], rows);
+
+            // Column lengths in lanes 0-2, lane 3 is forced to one.
+            V lengthSquared = Ops::Add(Ops::Add(Ops::Mul(rows[0], rows[0]), Ops::Mul(rows[1], rows[1])), Ops::Mul(rows[2], rows[2]));
+            lengthSquared = Ops::Add(lengthSquared, Ops::Constant(0.0f, 0.0f, 0.0f, 1.0f));
+            V scaling = Ops::Sqrt(lengthSquared);
+            const V invScale = Ops::Div(Ops::Constant(1.0f, 1.0f, 1.0f, 1.0f), scaling);
+            columns[0] = Ops::Mul(columns[0], Splat0<Ops>(invScale));
+            columns[1] = Ops::Mul(columns[1], Splat1<Ops>(invScale));
+            columns[2] = Ops::Mul(columns[2], Splat2<Ops>(invScale));
+
+            // Negative determinant, flip to keep a proper rotation.
+            const V dot = Ops::Mul(columns[0], Cross3<Ops>(columns[1], columns[2]));
+            float det[4];
+            Ops::Store(det, Ops::Add(Ops::Add(Splat0<Ops>(dot), Splat1<Ops>(dot)), Splat2<Ops>(dot)));
+            if (det[0] < 0.0f)
+            {
+                const V negate = Ops::Constant(-1.0f, -1.0f, -1.0f, -1.0f);
+                scaling = Ops::Mul(scaling, negate);
+                columns[0] = Ops::Mul(columns[0], negate);
+                columns[1] = Ops::Mul(columns[1], negate);
+                columns[2] = Ops::Mul(columns[2], negate);
+            }
+
+            float rotationColumns[3][4];
+            Ops::Store(rotationColumns[0], columns[0]);
+            Ops::Store(rotationColumns[1], columns[1]);
+            Ops::Store(rotationColumns[2], columns[2]);
+
+            float scaleData[4];
+            Ops::Store(scaleData, scaling);
+            scale = vec3(scaleData[0], scaleData[1], scaleData[2]);
+            rotation = QuaternionFromColumns(rotationColumns);
+            translation = matrix[3].xyz();
+        }
+
+        template <class Ops>
+        inline void LoadMatrix(const mat4& matrix, typename Ops::V result[4])
+        {
+            for (int column = 0; column < 4; column++)
+            {
+                result[column] = Ops::Load(matrix[column].data);
+            }
+        }
+
+        template <class Ops>
+        inline void StoreMatrix(const typename Ops::V columns[4], mat4& matrix)
+        {
+            for (int column = 0; column < 4; column++)
+            {
+                Ops::Store(matrix[column].data, columns[column]);
+            }
+        }
+
+        template <class Ops>
+        void MultiplyMatricesKernel(const mat4* a, const mat4* b, mat4* output, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                typename Ops::V left[4], right[4], result[4];
+                LoadMatrix<Ops>(a[i], left);
+                LoadMatrix<Ops>(b[i], right);
+                MultiplyKernel<Ops>(left, right, result);
+                StoreMatrix<Ops>(result, output[i]);
+            }
+        }
+
+        template <class Ops>
+        void InverseMatricesKernel(const mat4* matrices, mat4* output, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                typename Ops::V columns[4], result[4];
+                LoadMatrix<Ops>(matrices[i], columns);
+                InverseKernel<Ops>(columns, result);
+                StoreMatrix<Ops>(result, output[i]);
+            }
+        }
+
+        template <class Ops>
+        void InverseAffineMatricesKernel(const mat4* matrices, mat4* output, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                typename Ops::V columns[4], result[4];
+                LoadMatrix<Ops>(matrices[i], columns);
+                InverseAffineKernel<Ops>(columns, result);
+                StoreMatrix<Ops>(result, output[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,156 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Only called after MatrixKernels.cpp detected AVX support. GCC and Clang build the translation unit
+// for the baseline and enable AVX from the kernels onwards, engine headers are included first so the
+// inline functions they define keep baseline code and the linker can not pick a VEX encoded copy.
+
+#include "../Math/MatrixKernels.h"
+
+#if ALIMER_SSE2 && !defined(__AVX__) && defined(__GNUC__)
+#   define ALIMER_AVX_TARGET 1
+#endif
+
+#if ALIMER_SSE2 && (defined(__AVX__) || defined(ALIMER_AVX_TARGET))
+#include <immintrin.h>
+
+#if defined(ALIMER_AVX_TARGET) && defined(__clang__)
+#   pragma clang attribute push(__attribute__((target("avx"))), apply_to = function)
+#elif defined(ALIMER_AVX_TARGET)
+#   pragma GCC push_options
+#   pragma GCC target("avx")
+#endif
+
+#include "../Math/MatrixKernels.inl"
+
+namespace Alimer
+{
+    namespace
+    {
+        /// Two matrices per register, one in each 128 bit half.
+        struct AvxOps
+        {
+            using V = __m256;
+
+            static inline V Load(const float* low, const float* high) { return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1); }
+            static inline void Store(float* low, float* high, V v) { _mm_storeu_ps(low, _mm256_castps256_ps128(v)); _mm_storeu_ps(high, _mm256_extractf128_ps(v, 1)); }
+            static inline V Constant(float x, float y, float z, float w) { return _mm256_setr_ps(x, y, z, w, x, y, z, w); }
+            static inline V Add(V a, V b) { return _mm256_add_ps(a, b); }
+            static inline V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+            static inline V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+            static inline V Div(V a, V b) { return _mm256_div_ps(a, b); }
+            static inline V Sqrt(V a) { return _mm256_sqrt_ps(a); }
+
+            template <int X, int Y, int Z, int W>
+            static inline V Shuffle(V a, V b) { return _mm256_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X)); }
+        };
+
+        inline void LoadMatrixPair(const mat4& low, const mat4& high, __m256 result[4])
+        {
+            for (int column = 0; column < 4; column++)
+            {
+                result[column] = AvxOps::Load(low[column].data, high[column].data);
+            }
+        }
+
+        inline void StoreMatrixPair(const __m256 columns[4], mat4& low, mat4& high)
+        {
+            for (int column = 0; column < 4; column++)
+            {
+                AvxOps::Store(low[column].data, high[column].data, columns[column]);
+            }
+        }
+
+        void MultiplyMatricesAvx(const mat4* a, const mat4* b, mat4* output, uint32_t count)
+        {
+            uint32_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                __m256 left[4], right[4], result[4];
+                LoadMatrixPair(a[i], a[i + 1], left);
+                LoadMatrixPair(b[i], b[i + 1], right);
+                MultiplyKernel<AvxOps>(left, right, result);
+                StoreMatrixPair(result, output[i], output[i + 1]);
+            }
+
+            MultiplyMatricesKernel<SseOps>(a + i, b + i, output + i, count - i);
+        }
+
+        void InverseMatricesAvx(const mat4* matrices, mat4* output, uint32_t count)
+        {
+            uint32_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                __m256 columns[4], result[4];
+                LoadMatrixPair(matrices[i], matrices[i + 1], columns);
+                InverseKernel<AvxOps>(columns, result);
+                StoreMatrixPair(result, output[i], output[i + 1]);
+            }
+
+            InverseMatricesKernel<SseOps>(matrices + i, output + i, count - i);
+        }
+
+        void InverseAffineMatricesAvx(const mat4* matrices, mat4* output, uint32_t count)
+        {
+            uint32_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                __m256 columns[4], result[4];
+                LoadMatrixPair(matrices[i], matrices[i + 1], columns);
+                InverseAffineKernel<AvxOps>(columns, result);
+                StoreMatrixPair(result, output[i], output[i + 1]);
+            }
+
+            InverseAffineMatricesKernel<SseOps>(matrices + i, output + i, count - i);
+        }
+    }
+
+    bool GetAvxMatrixKernels(MatrixKernelTable& table)
+    {
+        table.multiply = MultiplyMatricesAvx;
+        table.inverse = InverseMatricesAvx;
+        table.inverseAffine = InverseAffineMatricesAvx;
+        // Single matrix, the SSE kernel built with VEX encoding.
+        table.decompose = DecomposeKernel<SseOps>;
+        return true;
+    }
+}
+
+#if defined(ALIMER_AVX_TARGET) && defined(__clang__)
+#   pragma clang attribute pop
+#elif defined(ALIMER_AVX_TARGET)
+#   pragma GCC pop_options
+#endif
+
+#else
+#include "../Math/MatrixKernels.inl"
+
+namespace Alimer
+{
+    bool GetAvxMatrixKernels(MatrixKernelTable& table)
+    {
+        ALIMER_UNUSED(table);
+        return false;
+    }
+}
+
+#endif
@@ -0,0 +1,61 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Math/Math.h"
+#include <cmath>
+
+namespace Alimer
+{
+    /// Plane with normal pointing to the positive half space, dot(normal, point) + distance = 0 on the plane.
+    class ALIMER_API Plane
+    {
+    public:
+        /// Construct the XZ plane through origin.
+        Plane() noexcept : normal(0.0f, 1.0f, 0.0f), distance(0.0f) {}
+
+        /// Construct from normal and distance.
+        Plane(const vec3& normal_, float distance_) : normal(normal_), distance(distance_) {}
+
+        /// Construct from normal and point on the plane.
+        Plane(const vec3& normal_, const vec3& point) : normal(normal_), distance(-dot(normal_, point)) {}
+
+        /// Construct from (a, b, c, d) coefficients.
+        explicit Plane(const vec4& plane) : normal(plane.x, plane.y, plane.z), distance(plane.w) {}
+
+        /// Return signed distance to point, only a true distance when the plane is normalized.
+        float Distance(const vec3& point) const { return dot(normal, point) + distance; }
+
+        /// Return plane with unit length normal.
+        Plane Normalized() const
+        {
+            const float invLength = 1.0f / std::sqrt(dot(normal, normal));
+            return Plane(normal * invLength, distance * invLength);
+        }
+
+        /// Plane normal.
+        vec3 normal;
+        /// Plane distance from origin along the negative normal.
+        float distance;
+    };
+}
@@ -0,0 +1,47 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Math/Ray.h"
+#include <cmath>
+
+namespace Alimer
+{
+    float Ray::HitDistance(const BoundingBox& box) const
+    {
+        return RayHitDistance(origin, vec3(1.0f) / direction, box);
+    }
+
+    float Ray::HitDistance(const BoundingSphere& sphere) const
+    {
+        const vec3 offset = origin - sphere.center;
+        const float c = dot(offset, offset) - sphere.radius * sphere.radius;
+        if (c <= 0.0f)
+            return 0.0f;
+
+        const float b = dot(offset, direction);
+        const float discriminant = b * b - c;
+        if (b > 0.0f || discriminant < 0.0f)
+            return std::numeric_limits<float>::infinity();
+
+        return -b - std::sqrt(discriminant);
+    }
+}
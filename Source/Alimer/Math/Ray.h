@@ -0,0 +1,66 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Math/BoundingSphere.h"
+#include <limits>
+
+namespace Alimer
+{
+    /// Half line from origin along direction.
+    class ALIMER_API Ray
+    {
+    public:
+        /// Construct ray along negative Z from origin.
+        Ray() noexcept : origin(0.0f), direction(0.0f, 0.0f, -1.0f) {}
+
+        /// Construct from origin and direction, direction is normalized.
+        Ray(const vec3& origin_, const vec3& direction_) : origin(origin_), direction(normalize(direction_)) {}
+
+        /// Return point at distance along the ray.
+        vec3 GetPoint(float distance) const { return origin + direction * distance; }
+
+        /// Return distance to the box entry point, 0 when the origin is inside and infinity on miss.
+        float HitDistance(const BoundingBox& box) const;
+
+        /// Return distance to the sphere entry point, 0 when the origin is inside and infinity on miss.
+        float HitDistance(const BoundingSphere& sphere) const;
+
+        /// Ray origin.
+        vec3 origin;
+        /// Unit length direction.
+        vec3 direction;
+    };
+
+    /// Slab test against box with precomputed 1 / direction, for testing many boxes against one ray.
+    inline float RayHitDistance(const vec3& origin, const vec3& inverseDirection, const BoundingBox& box)
+    {
+        const vec3 t0 = (box.min - origin) * inverseDirection;
+        const vec3 t1 = (box.max - origin) * inverseDirection;
+        const vec3 tmin = min(t0, t1);
+        const vec3 tmax = max(t0, t1);
+        const float entry = max(max(tmin.x, tmin.y), max(tmin.z, 0.0f));
+        const float exit = min(min(tmax.x, tmax.y), tmax.z);
+        return entry <= exit ? entry : std::numeric_limits<float>::infinity();
+    }
+}
@@ -21,6 +21,7 @@
 //
 
 #include "../Math/Transform.h"
+#include "../Math/MatrixKernels.h"
 #include "../Core/Log.h"
 
 namespace Alimer
@@ -54,7 +55,7 @@ namespace Alimer
 
     void Transform::Decompose()
     {
-        //_matrix.Decompose(_scale, _rotation, _position);
+        decompose(_matrix, _scale, _rotation, _position);
     }
 
     void Transform::Update() const
@@ -62,12 +63,13 @@ namespace Alimer
         if (!_dirty)
             return;
 
-        mat4 S; // = glm::scale(_scale);
-        mat4 R; // = glm::mat4_cast(rotation_);
-        mat4 T = mat4::translate(_position);
-
-        mat4 model = R * S;
-        _matrix = T * model;
+        // T * R * S without the full matrix products.
+        const mat3 rotation = mat3_cast(_rotation);
+        _matrix = mat4(
+            vec4(rotation[0] * _scale.x, 0.0f),
+            vec4(rotation[1] * _scale.y, 0.0f),
+            vec4(rotation[2] * _scale.z, 0.0f),
+            vec4(_position, 1.0f));
 
         _dirty = false;
     }
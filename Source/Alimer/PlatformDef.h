@@ -200,7 +200,7 @@
 #	undef ALIMER_SSE2
 #	define ALIMER_SSE2 1
 #endif
-#if defined(_M_ARM) || defined(__ARM_NEON__)
+#if defined(_M_ARM) || defined(__ARM_NEON__) || defined(__ARM_NEON)
 #	undef ALIMER_NEON
 #	define ALIMER_NEON 1
 #endif
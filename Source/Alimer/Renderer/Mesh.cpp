@@ -42,6 +42,8 @@ namespace Alimer
 
         _vertexCount = positions.Size();
         _indexCount = indices.Size();
+        _positions = positions;
+        _indices = indices;
 
         // Create vertex buffer.
         _vertexStride = sizeof(vec3) + sizeof(Color4);
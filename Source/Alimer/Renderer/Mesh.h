@@ -72,6 +72,11 @@ namespace Alimer
         Buffer* GetVertexBuffer() const { return _vertexBuffer.Get(); }
         Buffer* GetIndexBuffer() const { return _indexBuffer.Get(); }
 
+        /// Get CPU side positions, used by occlusion culling.
+        const PODVector<vec3>& GetPositions() const { return _positions; }
+        /// Get CPU side indices, used by occlusion culling.
+        const PODVector<uint16_t>& GetIndices() const { return _indices; }
+
         static Mesh* CreateCube(float size = 1.0f);
         static Mesh* CreateBox(const vec3& size = vec3(1.0f));
 
@@ -88,5 +93,8 @@ namespace Alimer
         uint32_t _vertexStride = 0;
         uint32_t _indexCount = 0;
         uint32_t _indexStride = 2;
+
+        PODVector<vec3> _positions;
+        PODVector<uint16_t> _indices;
     };
 }
@@ -0,0 +1,470 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Renderer/OcclusionBuffer.h"
+#include "../Renderer/Mesh.h"
+#include "../Core/JobSystem.h"
+#include "../Debug/Debug.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Alimer
+{
+    const uint32_t OcclusionBuffer::TileSize;
+    const uint32_t OcclusionBuffer::BinWidth;
+    const uint32_t OcclusionBuffer::BinHeight;
+
+    static const uint32_t ParallelTestThreshold = 256;
+    static const uint32_t ParallelTestGrainSize = 128;
+
+    OcclusionBuffer::OcclusionBuffer(uint32_t width, uint32_t height)
+    {
+        SetSize(width, height);
+    }
+
+    OcclusionBuffer::~OcclusionBuffer() = default;
+
+    void OcclusionBuffer::SetSize(uint32_t width, uint32_t height)
+    {
+        ALIMER_ASSERT_MSG(width > 0 && height > 0, "Invalid occlusion buffer size %ux%u", width, height);
+
+        _width = width;
+        _height = height;
+        _binCountX = (width + BinWidth - 1) / BinWidth;
+        _binCountY = (height + BinHeight - 1) / BinHeight;
+        _bufferWidth = _binCountX * BinWidth;
+        _bufferHeight = _binCountY * BinHeight;
+        _tileCountX = _bufferWidth / TileSize;
+        _bins.resize(_binCountX * _binCountY);
+        _depth.resize(_bufferWidth * _bufferHeight);
+        _tileDepth.resize(_tileCountX * (_bufferHeight / TileSize));
+        Clear(_viewProjection);
+    }
+
+    void OcclusionBuffer::Clear(const mat4& viewProjection)
+    {
+        _viewProjection = viewProjection;
+        _triangles.clear();
+        for (std::vector<uint32_t>& bin : _bins)
+        {
+            bin.clear();
+        }
+
+        std::fill(_depth.begin(), _depth.end(), 1.0f);
+        std::fill(_tileDepth.begin(), _tileDepth.end(), 1.0f);
+    }
+
+    void OcclusionBuffer::AddOccluder(const mat4& world, const vec3* positions, const uint16_t* indices, uint32_t indexCount)
+    {
+        const mat4 worldViewProjection = _viewProjection * world;
+        for (uint32_t i = 0; i + 3 <= indexCount; i += 3)
+        {
+            const vec4 clip[3] = {
+                worldViewProjection * vec4(positions[indices[i]], 1.0f),
+                worldViewProjection * vec4(positions[indices[i + 1]], 1.0f),
+                worldViewProjection * vec4(positions[indices[i + 2]], 1.0f)
+            };
+
+            const bool inside[3] = { clip[0].z >= 0.0f, clip[1].z >= 0.0f, clip[2].z >= 0.0f };
+            const uint32_t insideCount = inside[0] + inside[1] + inside[2];
+            if (insideCount == 3)
+            {
+                AddTriangle(clip[0], clip[1], clip[2]);
+                continue;
+            }
+
+            if (insideCount == 0)
+                continue;
+
+            // Clip against the near plane z = 0, the polygon has 3 or 4 vertices.
+            vec4 polygon[4];
+            uint32_t vertexCount = 0;
+            for (uint32_t j = 0; j < 3; j++)
+            {
+                const vec4& current = clip[j];
+                const vec4& next = clip[(j + 1) % 3];
+                if (inside[j])
+                {
+                    polygon[vertexCount++] = current;
+                }
+
+                if (inside[j] != inside[(j + 1) % 3])
+                {
+                    const float t = current.z / (current.z - next.z);
+                    polygon[vertexCount++] = current + (next - current) * t;
+                }
+            }
+
+            AddTriangle(polygon[0], polygon[1], polygon[2]);
+            if (vertexCount == 4)
+            {
+                AddTriangle(polygon[0], polygon[2], polygon[3]);
+            }
+        }
+    }
+
+    void OcclusionBuffer::AddOccluder(const mat4& world, const Mesh& mesh)
+    {
+        AddOccluder(world, mesh.GetPositions().Data(), mesh.GetIndices().Data(), mesh.GetIndices().Size());
+    }
+
+    void OcclusionBuffer::AddTriangle(const vec4& v0, const vec4& v1, const vec4& v2)
+    {
+        const vec4* vertices[3] = { &v0, &v1, &v2 };
+        Triangle triangle;
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            const vec4& v = *vertices[i];
+            const float invW = 1.0f / v.w;
+            triangle.x[i] = (v.x * invW * 0.5f + 0.5f) * static_cast<float>(_width);
+            triangle.y[i] = (0.5f - v.y * invW * 0.5f) * static_cast<float>(_height);
+            triangle.z[i] = v.z * invW;
+        }
+
+        // Bin by the pixel bounds clamped to the screen.
+        const float minX = std::max(std::min(std::min(triangle.x[0], triangle.x[1]), triangle.x[2]), 0.0f);
+        const float maxX = std::min(std::max(std::max(triangle.x[0], triangle.x[1]), triangle.x[2]), static_cast<float>(_width));
+        const float minY = std::max(std::min(std::min(triangle.y[0], triangle.y[1]), triangle.y[2]), 0.0f);
+        const float maxY = std::min(std::max(std::max(triangle.y[0], triangle.y[1]), triangle.y[2]), static_cast<float>(_height));
+        if (minX >= maxX || minY >= maxY)
+            return;
+
+        const uint32_t index = static_cast<uint32_t>(_triangles.size());
+        _triangles.push_back(triangle);
+
+        const uint32_t binMinX = static_cast<uint32_t>(minX) / BinWidth;
+        const uint32_t binMaxX = std::min(static_cast<uint32_t>(maxX) / BinWidth, _binCountX - 1);
+        const uint32_t binMinY = static_cast<uint32_t>(minY) / BinHeight;
+        const uint32_t binMaxY = std::min(static_cast<uint32_t>(maxY) / BinHeight, _binCountY - 1);
+        for (uint32_t y = binMinY; y <= binMaxY; y++)
+        {
+            for (uint32_t x = binMinX; x <= binMaxX; x++)
+            {
+                _bins[y * _binCountX + x].push_back(index);
+            }
+        }
+    }
+
+    void OcclusionBuffer::Rasterize()
+    {
+        // Bins own disjoint pixels and tiles, no synchronization is needed.
+        JobSystem::GetInstance()->ParallelFor(static_cast<uint32_t>(_bins.size()), 1, [this](uint32_t begin, uint32_t end) {
+            for (uint32_t bin = begin; bin < end; bin++)
+            {
+                RasterizeBin(bin);
+            }
+        });
+    }
+
+    void OcclusionBuffer::RasterizeBin(uint32_t bin)
+    {
+        const uint32_t minX = (bin % _binCountX) * BinWidth;
+        const uint32_t minY = (bin / _binCountX) * BinHeight;
+        const uint32_t maxX = std::min(minX + BinWidth, _width);
+        const uint32_t maxY = std::min(minY + BinHeight, _height);
+
+        for (uint32_t triangle : _bins[bin])
+        {
+            RasterizeTriangle(_triangles[triangle], minX, minY, maxX, maxY);
+        }
+
+        // Farthest depth per tile.
+        for (uint32_t tileY = minY; tileY < minY + BinHeight; tileY += TileSize)
+        {
+            for (uint32_t tileX = minX; tileX < minX + BinWidth; tileX += TileSize)
+            {
+                float tileDepth = 0.0f;
+                for (uint32_t y = tileY; y < tileY + TileSize; y++)
+                {
+                    const float* row = &_depth[y * _bufferWidth + tileX];
+#if ALIMER_SSE2
+                    const __m128 rowMax = _mm_max_ps(_mm_loadu_ps(row), _mm_loadu_ps(row + 4));
+                    const __m128 pairMax = _mm_max_ps(rowMax, _mm_shuffle_ps(rowMax, rowMax, _MM_SHUFFLE(1, 0, 3, 2)));
+                    tileDepth = std::max(tileDepth, _mm_cvtss_f32(_mm_max_ss(pairMax, _mm_shuffle_ps(pairMax, pairMax, _MM_SHUFFLE(2, 3, 0, 1)))));
+#else
+                    for (uint32_t x = 0; x < TileSize; x++)
+                    {
+                        tileDepth = std::max(tileDepth, row[x]);
+                    }
+#endif
+                }
+
+                _tileDepth[(tileY / TileSize) * _tileCountX + tileX / TileSize] = tileDepth;
+            }
+        }
+    }
+
+    void OcclusionBuffer::RasterizeTriangle(const Triangle& triangle, uint32_t binMinX, uint32_t binMinY, uint32_t binMaxX, uint32_t binMaxY)
+    {
+        // Make the winding counter clockwise in pixel space so inside points have positive edge functions.
+        float x[3] = { triangle.x[0], triangle.x[1], triangle.x[2] };
+        float y[3] = { triangle.y[0], triangle.y[1], triangle.y[2] };
+        float z[3] = { triangle.z[0], triangle.z[1], triangle.z[2] };
+        float area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+        if (area < 0.0f)
+        {
+            std::swap(x[1], x[2]);
+            std::swap(y[1], y[2]);
+            std::swap(z[1], z[2]);
+            area = -area;
+        }
+
+        if (!(area > 0.0f))
+            return;
+
+        // Edge i is opposite to vertex i, edge(px, py) = a * px + b * py + c. Coverage evaluates each edge with its
+        // endpoints in a fixed order, so triangles sharing an edge compute bit identical values and a pixel center
+        // exactly on the edge belongs to exactly one of them instead of leaking through both.
+        float edgeA[3], edgeB[3], edgeC[3];
+        bool ownsEdge[3];
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            uint32_t from = (i + 1) % 3;
+            uint32_t to = (i + 2) % 3;
+            ownsEdge[i] = y[from] < y[to] || (y[from] == y[to] && x[from] < x[to]);
+            if (!ownsEdge[i])
+            {
+                std::swap(from, to);
+            }
+
+            edgeA[i] = y[from] - y[to];
+            edgeB[i] = x[to] - x[from];
+            edgeC[i] = -edgeA[i] * x[from] - edgeB[i] * y[from];
+        }
+
+        // Oriented edges are positive inside.
+        float orientedA[3], orientedB[3], orientedC[3];
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            const float sign = ownsEdge[i] ? 1.0f : -1.0f;
+            orientedA[i] = edgeA[i] * sign;
+            orientedB[i] = edgeB[i] * sign;
+            orientedC[i] = edgeC[i] * sign;
+        }
+
+        // Depth plane from barycentric weights.
+        const float invArea = 1.0f / area;
+        const float depthA = (orientedA[0] * z[0] + orientedA[1] * z[1] + orientedA[2] * z[2]) * invArea;
+        const float depthB = (orientedB[0] * z[0] + orientedB[1] * z[1] + orientedB[2] * z[2]) * invArea;
+        const float depthC = (orientedC[0] * z[0] + orientedC[1] * z[1] + orientedC[2] * z[2]) * invArea;
+
+        // Pixel bounds in the bin, x starts on a multiple of 4 for the SIMD loop.
+        const float boundsMinX = std::min(std::min(x[0], x[1]), x[2]);
+        const float boundsMaxX = std::max(std::max(x[0], x[1]), x[2]);
+        const float boundsMinY = std::min(std::min(y[0], y[1]), y[2]);
+        const float boundsMaxY = std::max(std::max(y[0], y[1]), y[2]);
+        const uint32_t minX = std::max(static_cast<uint32_t>(std::max(boundsMinX, 0.0f)), binMinX) & ~3u;
+        const uint32_t minY = std::max(static_cast<uint32_t>(std::max(boundsMinY, 0.0f)), binMinY);
+        const uint32_t maxX = std::min(static_cast<uint32_t>(std::min(std::ceil(boundsMaxX), static_cast<float>(binMaxX))), binMaxX);
+        const uint32_t maxY = std::min(static_cast<uint32_t>(std::min(std::ceil(boundsMaxY), static_cast<float>(binMaxY))), binMaxY);
+
+#if ALIMER_SSE2
+        const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        const __m128 zero = _mm_setzero_ps();
+        __m128 a[3];
+        __m128 owns[3];
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            a[i] = _mm_set1_ps(edgeA[i]);
+            owns[i] = _mm_castsi128_ps(_mm_set1_epi32(ownsEdge[i] ? -1 : 0));
+        }
+        const __m128 depthAv = _mm_set1_ps(depthA);
+#endif
+
+        for (uint32_t py = minY; py < maxY; py++)
+        {
+            const float centerY = static_cast<float>(py) + 0.5f;
+            float* row = &_depth[py * _bufferWidth];
+#if ALIMER_SSE2
+            __m128 rowEdge[3];
+            for (uint32_t i = 0; i < 3; i++)
+            {
+                rowEdge[i] = _mm_set1_ps(edgeB[i] * centerY + edgeC[i]);
+            }
+            const __m128 rowDepth = _mm_set1_ps(depthB * centerY + depthC);
+
+            for (uint32_t px = minX; px < maxX; px += 4)
+            {
+                // Bins are multiples of 4 pixels wide, the last lanes may only touch padding past the screen width.
+                const __m128 centerX = _mm_add_ps(_mm_set1_ps(static_cast<float>(px)), laneOffsets);
+                const __m128 e0 = _mm_add_ps(_mm_mul_ps(a[0], centerX), rowEdge[0]);
+                const __m128 e1 = _mm_add_ps(_mm_mul_ps(a[1], centerX), rowEdge[1]);
+                const __m128 e2 = _mm_add_ps(_mm_mul_ps(a[2], centerX), rowEdge[2]);
+                // Inside is e >= 0 for owned edges and e < 0 for the others.
+                const __m128 inside0 = _mm_xor_ps(_mm_cmplt_ps(e0, zero), owns[0]);
+                const __m128 inside1 = _mm_xor_ps(_mm_cmplt_ps(e1, zero), owns[1]);
+                const __m128 inside2 = _mm_xor_ps(_mm_cmplt_ps(e2, zero), owns[2]);
+                const __m128 inside = _mm_and_ps(_mm_and_ps(inside0, inside1), inside2);
+                if (_mm_movemask_ps(inside) == 0)
+                    continue;
+
+                const __m128 depth = _mm_add_ps(_mm_mul_ps(depthAv, centerX), rowDepth);
+                const __m128 current = _mm_loadu_ps(row + px);
+                const __m128 nearest = _mm_min_ps(current, depth);
+                _mm_storeu_ps(row + px, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+            }
+#else
+            for (uint32_t px = minX; px < maxX; px++)
+            {
+                const float centerX = static_cast<float>(px) + 0.5f;
+                const bool inside = (edgeA[0] * centerX + (edgeB[0] * centerY + edgeC[0]) < 0.0f) != ownsEdge[0]
+                    && (edgeA[1] * centerX + (edgeB[1] * centerY + edgeC[1]) < 0.0f) != ownsEdge[1]
+                    && (edgeA[2] * centerX + (edgeB[2] * centerY + edgeC[2]) < 0.0f) != ownsEdge[2];
+                if (inside)
+                {
+                    row[px] = std::min(row[px], depthA * centerX + depthB * centerY + depthC);
+                }
+            }
+#endif
+        }
+    }
+
+    bool OcclusionBuffer::IsVisible(const BoundingBox& box) const
+    {
+        return IsVisible(box.GetCenter(), box.GetExtents());
+    }
+
+    bool OcclusionBuffer::IsVisible(const vec3& center, const vec3& extents) const
+    {
+        // Project the corners, the box is tested as its screen rectangle at its nearest depth.
+        const vec4 clipCenter = _viewProjection * vec4(center, 1.0f);
+        const vec4 axisX = _viewProjection[0] * extents.x;
+        const vec4 axisY = _viewProjection[1] * extents.y;
+        const vec4 axisZ = _viewProjection[2] * extents.z;
+
+        float minX = static_cast<float>(_width);
+        float maxX = 0.0f;
+        float minY = static_cast<float>(_height);
+        float maxY = 0.0f;
+        float minDepth = 1.0f;
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            const vec4 corner = clipCenter + ((i & 1) ? axisX : -axisX) + ((i & 2) ? axisY : -axisY) + ((i & 4) ? axisZ : -axisZ);
+            if (corner.z < 0.0f || !(corner.w > 0.0f))
+                return true;
+
+            const float invW = 1.0f / corner.w;
+            const float screenX = (corner.x * invW * 0.5f + 0.5f) * static_cast<float>(_width);
+            const float screenY = (0.5f - corner.y * invW * 0.5f) * static_cast<float>(_height);
+            minX = std::min(minX, screenX);
+            maxX = std::max(maxX, screenX);
+            minY = std::min(minY, screenY);
+            maxY = std::max(maxY, screenY);
+            minDepth = std::min(minDepth, corner.z * invW);
+        }
+
+        const uint32_t rectMinX = static_cast<uint32_t>(std::max(minX, 0.0f));
+        const uint32_t rectMinY = static_cast<uint32_t>(std::max(minY, 0.0f));
+        const uint32_t rectMaxX = static_cast<uint32_t>(std::min(std::ceil(maxX), static_cast<float>(_width)));
+        const uint32_t rectMaxY = static_cast<uint32_t>(std::min(std::ceil(maxY), static_cast<float>(_height)));
+        if (rectMinX >= rectMaxX || rectMinY >= rectMaxY)
+            return false;
+
+        for (uint32_t tileY = rectMinY / TileSize; tileY <= (rectMaxY - 1) / TileSize; tileY++)
+        {
+            for (uint32_t tileX = rectMinX / TileSize; tileX <= (rectMaxX - 1) / TileSize; tileX++)
+            {
+                // Box behind everything in the tile.
+                if (minDepth >= _tileDepth[tileY * _tileCountX + tileX])
+                    continue;
+
+                if (IsTileVisible(tileX, tileY, rectMinX, rectMinY, rectMaxX, rectMaxY, minDepth))
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool OcclusionBuffer::IsTileVisible(uint32_t tileX, uint32_t tileY, uint32_t rectMinX, uint32_t rectMinY, uint32_t rectMaxX, uint32_t rectMaxY, float depth) const
+    {
+        const uint32_t minX = std::max(tileX * TileSize, rectMinX);
+        const uint32_t minY = std::max(tileY * TileSize, rectMinY);
+        const uint32_t maxX = std::min(tileX * TileSize + TileSize, rectMaxX);
+        const uint32_t maxY = std::min(tileY * TileSize + TileSize, rectMaxY);
+
+#if ALIMER_SSE2
+        // Tiles are 8 pixels wide, test the two halves with lanes outside the rectangle masked off.
+        const __m128i laneX = _mm_setr_epi32(0, 1, 2, 3);
+        const __m128i minLane = _mm_set1_epi32(static_cast<int>(minX) - 1);
+        const __m128i maxLane = _mm_set1_epi32(static_cast<int>(maxX));
+        const uint32_t baseX = tileX * TileSize;
+        const __m128i lanes0 = _mm_add_epi32(laneX, _mm_set1_epi32(static_cast<int>(baseX)));
+        const __m128i lanes1 = _mm_add_epi32(lanes0, _mm_set1_epi32(4));
+        const __m128 mask0 = _mm_castsi128_ps(_mm_and_si128(_mm_cmpgt_epi32(lanes0, minLane), _mm_cmplt_epi32(lanes0, maxLane)));
+        const __m128 mask1 = _mm_castsi128_ps(_mm_and_si128(_mm_cmpgt_epi32(lanes1, minLane), _mm_cmplt_epi32(lanes1, maxLane)));
+        const __m128 depthv = _mm_set1_ps(depth);
+        for (uint32_t y = minY; y < maxY; y++)
+        {
+            const float* row = &_depth[y * _bufferWidth + baseX];
+            const __m128 visible0 = _mm_and_ps(_mm_cmpgt_ps(_mm_loadu_ps(row), depthv), mask0);
+            const __m128 visible1 = _mm_and_ps(_mm_cmpgt_ps(_mm_loadu_ps(row + 4), depthv), mask1);
+            if (_mm_movemask_ps(_mm_or_ps(visible0, visible1)) != 0)
+                return true;
+        }
+#else
+        for (uint32_t y = minY; y < maxY; y++)
+        {
+            for (uint32_t x = minX; x < maxX; x++)
+            {
+                if (_depth[y * _bufferWidth + x] > depth)
+                    return true;
+            }
+        }
+#endif
+
+        return false;
+    }
+
+    void OcclusionBuffer::TestBoxes(const BoundingBoxArray& boxes, ArrayView<uint32_t> visibility) const
+    {
+        const uint32_t count = boxes.GetSize();
+        ALIMER_ASSERT_MSG(visibility.size() >= GetVisibilityMaskSize(count), "Visibility mask too small (%u, %u)", visibility.size(), GetVisibilityMaskSize(count));
+
+        // Ranges start at multiples of 32, each one owns whole mask words.
+        auto testRange = [this, &boxes, &visibility](uint32_t begin, uint32_t end) {
+            for (uint32_t word = begin; word < end; word += 32)
+            {
+                uint32_t bits = 0;
+                for (uint32_t i = word; i < std::min(word + 32, end); i++)
+                {
+                    const vec3 center(boxes.GetCenterX()[i], boxes.GetCenterY()[i], boxes.GetCenterZ()[i]);
+                    const vec3 extents(boxes.GetExtentX()[i], boxes.GetExtentY()[i], boxes.GetExtentZ()[i]);
+                    bits |= static_cast<uint32_t>(IsVisible(center, extents)) << (i - word);
+                }
+
+                visibility[word / 32] = bits;
+            }
+        };
+
+        if (count < ParallelTestThreshold)
+        {
+            testRange(0, count);
+            return;
+        }
+
+        // Split over mask words so batches write disjoint memory.
+        JobSystem::GetInstance()->ParallelFor(GetVisibilityMaskSize(count), ParallelTestGrainSize / 32, [&testRange, count](uint32_t beginWord, uint32_t endWord) {
+            testRange(beginWord * 32, std::min(endWord * 32, count));
+        });
+    }
+}
@@ -0,0 +1,116 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Base/Containers.h"
+#include "../Math/FrustumCulling.h"
+#include <vector>
+
+namespace Alimer
+{
+    class Mesh;
+
+    /// Low resolution CPU depth buffer for occlusion culling. Occluder triangles are binned into screen regions that
+    /// are rasterized in parallel, each 8x8 pixel tile keeps its farthest depth so most box tests never touch pixels.
+    /// Depth follows clip space z / w in [0, 1], smaller is nearer.
+    class ALIMER_API OcclusionBuffer final
+    {
+    public:
+        static const uint32_t TileSize = 8;
+        static const uint32_t BinWidth = 64;
+        static const uint32_t BinHeight = 32;
+
+        /// Constructor.
+        OcclusionBuffer(uint32_t width = 256, uint32_t height = 128);
+
+        /// Destructor.
+        ~OcclusionBuffer();
+
+        /// Set resolution, clears the buffer.
+        void SetSize(uint32_t width, uint32_t height);
+
+        uint32_t GetWidth() const { return _width; }
+        uint32_t GetHeight() const { return _height; }
+
+        /// Clear depth and occluders and set view projection for the frame.
+        void Clear(const mat4& viewProjection);
+
+        /// Queue indexed triangle list transformed by world matrix, clipped against the near plane. Both windings are
+        /// rasterized. Not thread safe.
+        void AddOccluder(const mat4& world, const vec3* positions, const uint16_t* indices, uint32_t indexCount);
+
+        /// Queue mesh CPU side positions and indices.
+        void AddOccluder(const mat4& world, const Mesh& mesh);
+
+        /// Rasterize queued occluders, screen bins are processed by the job system.
+        void Rasterize();
+
+        /// Get number of occluder triangles after near plane clipping.
+        uint32_t GetTriangleCount() const { return static_cast<uint32_t>(_triangles.size()); }
+
+        /// Get depth at pixel.
+        float GetDepth(uint32_t x, uint32_t y) const { return _depth[y * _bufferWidth + x]; }
+
+        /// Return whether the box may be visible after Rasterize. Boxes reaching past the near plane are visible,
+        /// boxes projecting outside the screen are not.
+        bool IsVisible(const BoundingBox& box) const;
+
+        /// Set bit i of visibility when box i may be visible, visibility holds GetVisibilityMaskSize words.
+        void TestBoxes(const BoundingBoxArray& boxes, ArrayView<uint32_t> visibility) const;
+
+    private:
+        /// Screen space triangle, x and y in pixels.
+        struct Triangle
+        {
+            float x[3];
+            float y[3];
+            float z[3];
+        };
+
+        void AddTriangle(const vec4& v0, const vec4& v1, const vec4& v2);
+        void RasterizeBin(uint32_t bin);
+        void RasterizeTriangle(const Triangle& triangle, uint32_t minX, uint32_t minY, uint32_t maxX, uint32_t maxY);
+        bool IsVisible(const vec3& center, const vec3& extents) const;
+        bool IsTileVisible(uint32_t tileX, uint32_t tileY, uint32_t minX, uint32_t minY, uint32_t maxX, uint32_t maxY, float depth) const;
+
+        uint32_t _width = 0;
+        uint32_t _height = 0;
+        /// Width and height padded to whole bins.
+        uint32_t _bufferWidth = 0;
+        uint32_t _bufferHeight = 0;
+        uint32_t _binCountX = 0;
+        uint32_t _binCountY = 0;
+        uint32_t _tileCountX = 0;
+
+        mat4 _viewProjection;
+        std::vector<Triangle> _triangles;
+        /// Triangle indices per bin.
+        std::vector<std::vector<uint32_t>> _bins;
+        std::vector<float> _depth;
+        /// Farthest depth per tile.
+        std::vector<float> _tileDepth;
+
+    private:
+        DISALLOW_COPY_MOVE_AND_ASSIGN(OcclusionBuffer);
+    };
+}
@@ -0,0 +1,62 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Renderer/RenderWorld.h"
+#include "../Scene/Components/TransformComponent.h"
+#include "../Scene/Components/CameraComponent.h"
+#include "../Scene/Components/BoundsComponent.h"
+
+namespace Alimer
+{
+    void RenderWorld::Clear()
+    {
+        _views.clear();
+        _objects.clear();
+        _valid = false;
+    }
+
+    void RenderWorld::Extract(EntityManager& entities)
+    {
+        Clear();
+
+        // View and projection were computed from the world matrix by CameraSystem.
+        entities.Each<const CameraComponent>([this](Entity entity, const CameraComponent& camera) {
+            _views.push_back({ entity.GetId(), camera.GetView(), camera.GetProjection(), camera.GetFrustum() });
+        });
+
+        // Whole chunks are appended at once, the copy is the only work done per object.
+        entities.EachChunk<const TransformComponent, const BoundsComponent>(
+            [this](uint32_t count, const Entity::Id* ids, const TransformComponent* transforms, const BoundsComponent* bounds) {
+            const size_t offset = _objects.size();
+            _objects.resize(offset + count);
+            RenderObject* objects = _objects.data() + offset;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                objects[i].entity = ids[i];
+                objects[i].world = transforms[i].GetWorldMatrix();
+                objects[i].worldBox = bounds[i].GetWorldBox();
+            }
+        });
+
+        _valid = true;
+    }
+}
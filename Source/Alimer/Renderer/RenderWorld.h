@@ -0,0 +1,89 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Math/Math.h"
+#include "../Math/Frustum.h"
+#include "../Math/BoundingBox.h"
+#include "../Scene/Entity.h"
+#include <vector>
+
+namespace Alimer
+{
+    /// Camera state copied from the scene by the extract phase.
+    struct RenderView
+    {
+        Entity::Id entity;
+        mat4 view;
+        mat4 projection;
+        Frustum frustum;
+    };
+
+    /// Renderable state copied from the scene by the extract phase.
+    struct RenderObject
+    {
+        Entity::Id entity;
+        mat4 world;
+        BoundingBox worldBox;
+    };
+
+    /// Snapshot of the render relevant scene state, owned by rendering while simulation moves on.
+    /// Application keeps two of them: one is filled by the extract phase while the other is rendered.
+    class ALIMER_API RenderWorld final
+    {
+    public:
+        /// Constructor.
+        RenderWorld() = default;
+
+        /// Remove all views and objects, capacity is kept for the next extraction.
+        void Clear();
+
+        /// Copy cameras and renderables from the entities, simulation must not run meanwhile.
+        void Extract(EntityManager& entities);
+
+        /// Get the extracted cameras.
+        const std::vector<RenderView>& GetViews() const { return _views; }
+
+        /// Get the extracted renderables.
+        const std::vector<RenderObject>& GetObjects() const { return _objects; }
+
+        /// Return whether the world holds an extracted frame not yet rendered.
+        bool IsValid() const { return _valid; }
+
+        /// Mark the extracted frame as rendered.
+        void Invalidate() { _valid = false; }
+
+        /// Frame time and elapsed time of the simulation step the world was extracted from.
+        double frameTime = 0.0;
+        double elapsedTime = 0.0;
+        /// Steady clock time in seconds when that simulation step started, used to measure latency.
+        double simulationStart = 0.0;
+
+    private:
+        std::vector<RenderView> _views;
+        std::vector<RenderObject> _objects;
+        bool _valid = false;
+
+        DISALLOW_COPY_MOVE_AND_ASSIGN(RenderWorld);
+    };
+}
@@ -84,7 +84,7 @@ namespace Alimer
     ResourceLoader* ResourceManager::GetLoader(StringHash type) const
     {
         auto it = _loaders.find(type);
-        return it != end(_loaders) ? it->second.Get() : nullptr;
+        return it != _loaders.end() ? it->second.Get() : nullptr;
     }
 
     UniquePtr<Stream> ResourceManager::OpenResource(const String &assetName)
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../Base/HashMap.h"
 #include "../Base/String.h"
 #include "../Base/StringHash.h"
 #include "../IO/FileSystem.h"
@@ -92,7 +93,7 @@ namespace Alimer
         /// Resource load directories.
         Vector<String> _resourceDirs;
 
-        std::unordered_map<StringHash, UniquePtr<ResourceLoader>> _loaders;
+        HashMap<UniquePtr<ResourceLoader>> _loaders;
         using ResourceKey = std::pair<StringHash, StringHash>;
 		std::map<ResourceKey, SharedPtr<Object>> _resources;
 
@@ -0,0 +1,348 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Scene/BoundingVolumeHierarchy.h"
+#include "../Debug/Debug.h"
+#include <algorithm>
+
+namespace Alimer
+{
+    constexpr uint32_t BoundingVolumeHierarchy::InvalidProxy;
+
+    /// Predicted motion is extended this many times the displacement.
+    static const float DisplacementMultiplier = 2.0f;
+
+    static inline BoundingBox Union(const BoundingBox& a, const BoundingBox& b)
+    {
+        return BoundingBox(min(a.min, b.min), max(a.max, b.max));
+    }
+
+    /// Half surface area, the insertion cost metric.
+    static inline float GetArea(const BoundingBox& box)
+    {
+        const vec3 size = box.max - box.min;
+        return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+    static inline bool Contains(const BoundingBox& outer, const BoundingBox& inner)
+    {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z
+            && inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+    }
+
+    BoundingVolumeHierarchy::BoundingVolumeHierarchy(float margin)
+        : _margin(margin)
+    {
+    }
+
+    BoundingVolumeHierarchy::~BoundingVolumeHierarchy() = default;
+
+    uint32_t BoundingVolumeHierarchy::AllocateNode()
+    {
+        uint32_t node = _freeList;
+        if (node != InvalidProxy)
+        {
+            _freeList = _nodes[node].parent;
+        }
+        else
+        {
+            node = static_cast<uint32_t>(_nodes.size());
+            _nodes.emplace_back();
+        }
+
+        Node& result = _nodes[node];
+        result.userData = 0;
+        result.parent = InvalidProxy;
+        result.child1 = InvalidProxy;
+        result.child2 = InvalidProxy;
+        result.height = 0;
+        return node;
+    }
+
+    void BoundingVolumeHierarchy::FreeNode(uint32_t node)
+    {
+        _nodes[node].parent = _freeList;
+        _nodes[node].height = -1;
+        _freeList = node;
+    }
+
+    uint32_t BoundingVolumeHierarchy::CreateProxy(const BoundingBox& box, uint64_t userData)
+    {
+        const uint32_t proxy = AllocateNode();
+        const vec3 margin(_margin);
+        _nodes[proxy].box = BoundingBox(box.min - margin, box.max + margin);
+        _nodes[proxy].userData = userData;
+        InsertLeaf(proxy);
+        _proxyCount++;
+        return proxy;
+    }
+
+    void BoundingVolumeHierarchy::DestroyProxy(uint32_t proxy)
+    {
+        ALIMER_ASSERT_MSG(proxy < _nodes.size() && _nodes[proxy].IsLeaf() && _nodes[proxy].height == 0, "Invalid proxy %u", proxy);
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        _proxyCount--;
+    }
+
+    bool BoundingVolumeHierarchy::MoveProxy(uint32_t proxy, const BoundingBox& box, const vec3& displacement)
+    {
+        ALIMER_ASSERT_MSG(proxy < _nodes.size() && _nodes[proxy].IsLeaf() && _nodes[proxy].height == 0, "Invalid proxy %u", proxy);
+        if (Contains(_nodes[proxy].box, box))
+            return false;
+
+        RemoveLeaf(proxy);
+
+        const vec3 margin(_margin);
+        BoundingBox fatBox(box.min - margin, box.max + margin);
+        const vec3 predicted = displacement * DisplacementMultiplier;
+        fatBox.min = fatBox.min + min(predicted, vec3(0.0f));
+        fatBox.max = fatBox.max + max(predicted, vec3(0.0f));
+        _nodes[proxy].box = fatBox;
+
+        InsertLeaf(proxy);
+        return true;
+    }
+
+    bool BoundingVolumeHierarchy::IsContained(uint32_t proxy, const BoundingBox& box) const
+    {
+        return Contains(_nodes[proxy].box, box);
+    }
+
+    uint64_t BoundingVolumeHierarchy::GetUserData(uint32_t proxy) const
+    {
+        return _nodes[proxy].userData;
+    }
+
+    const BoundingBox& BoundingVolumeHierarchy::GetFatBox(uint32_t proxy) const
+    {
+        return _nodes[proxy].box;
+    }
+
+    uint32_t BoundingVolumeHierarchy::GetHeight() const
+    {
+        return _root != InvalidProxy ? static_cast<uint32_t>(_nodes[_root].height) : 0;
+    }
+
+    float BoundingVolumeHierarchy::GetAreaRatio() const
+    {
+        if (_root == InvalidProxy)
+            return 0.0f;
+
+        float totalArea = 0.0f;
+        for (const Node& node : _nodes)
+        {
+            if (node.height > 0)
+                totalArea += GetArea(node.box);
+        }
+
+        const float rootArea = GetArea(_nodes[_root].box);
+        return rootArea > 0.0f ? totalArea / rootArea : 0.0f;
+    }
+
+    void BoundingVolumeHierarchy::Clear()
+    {
+        _nodes.clear();
+        _root = InvalidProxy;
+        _freeList = InvalidProxy;
+        _proxyCount = 0;
+    }
+
+    void BoundingVolumeHierarchy::InsertLeaf(uint32_t leaf)
+    {
+        if (_root == InvalidProxy)
+        {
+            _root = leaf;
+            _nodes[leaf].parent = InvalidProxy;
+            return;
+        }
+
+        // Descend towards the sibling with the lowest cost, inheritance cost is the growth of every ancestor.
+        const BoundingBox leafBox = _nodes[leaf].box;
+        uint32_t index = _root;
+        while (!_nodes[index].IsLeaf())
+        {
+            const Node& node = _nodes[index];
+            const float area = GetArea(node.box);
+            const float combinedArea = GetArea(Union(node.box, leafBox));
+
+            // Cost of making a new parent for this node and the leaf.
+            const float cost = 2.0f * combinedArea;
+            // Minimum cost of pushing the leaf further down.
+            const float inheritanceCost = 2.0f * (combinedArea - area);
+
+            float childCosts[2];
+            const uint32_t children[2] = { node.child1, node.child2 };
+            for (int i = 0; i < 2; i++)
+            {
+                const Node& child = _nodes[children[i]];
+                const float newArea = GetArea(Union(child.box, leafBox));
+                childCosts[i] = (child.IsLeaf() ? newArea : newArea - GetArea(child.box)) + inheritanceCost;
+            }
+
+            if (cost < childCosts[0] && cost < childCosts[1])
+                break;
+
+            index = childCosts[0] < childCosts[1] ? children[0] : children[1];
+        }
+
+        const uint32_t sibling = index;
+        const uint32_t oldParent = _nodes[sibling].parent;
+        const uint32_t newParent = AllocateNode();
+        Node& parentNode = _nodes[newParent];
+        parentNode.parent = oldParent;
+        parentNode.box = Union(leafBox, _nodes[sibling].box);
+        parentNode.height = _nodes[sibling].height + 1;
+        parentNode.child1 = sibling;
+        parentNode.child2 = leaf;
+        _nodes[sibling].parent = newParent;
+        _nodes[leaf].parent = newParent;
+
+        if (oldParent != InvalidProxy)
+        {
+            if (_nodes[oldParent].child1 == sibling)
+                _nodes[oldParent].child1 = newParent;
+            else
+                _nodes[oldParent].child2 = newParent;
+        }
+        else
+        {
+            _root = newParent;
+        }
+
+        UpdateAncestors(_nodes[leaf].parent);
+    }
+
+    void BoundingVolumeHierarchy::RemoveLeaf(uint32_t leaf)
+    {
+        if (leaf == _root)
+        {
+            _root = InvalidProxy;
+            return;
+        }
+
+        const uint32_t parent = _nodes[leaf].parent;
+        const uint32_t grandParent = _nodes[parent].parent;
+        const uint32_t sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+        if (grandParent != InvalidProxy)
+        {
+            // Replace the parent by the sibling.
+            if (_nodes[grandParent].child1 == parent)
+                _nodes[grandParent].child1 = sibling;
+            else
+                _nodes[grandParent].child2 = sibling;
+            _nodes[sibling].parent = grandParent;
+            FreeNode(parent);
+            UpdateAncestors(grandParent);
+        }
+        else
+        {
+            _root = sibling;
+            _nodes[sibling].parent = InvalidProxy;
+            FreeNode(parent);
+        }
+    }
+
+    void BoundingVolumeHierarchy::UpdateAncestors(uint32_t node)
+    {
+        while (node != InvalidProxy)
+        {
+            node = Balance(node);
+
+            Node& current = _nodes[node];
+            const Node& child1 = _nodes[current.child1];
+            const Node& child2 = _nodes[current.child2];
+            current.height = 1 + std::max(child1.height, child2.height);
+            current.box = Union(child1.box, child2.box);
+
+            node = current.parent;
+        }
+    }
+
+    uint32_t BoundingVolumeHierarchy::Balance(uint32_t indexA)
+    {
+        // Rotate the taller grandchild up when the children heights differ by more than one.
+        Node& A = _nodes[indexA];
+        if (A.IsLeaf() || A.height < 2)
+            return indexA;
+
+        const uint32_t indexB = A.child1;
+        const uint32_t indexC = A.child2;
+        Node& B = _nodes[indexB];
+        Node& C = _nodes[indexC];
+        const int32_t balance = C.height - B.height;
+
+        // Rotate C up, or B up when mirrored.
+        if (balance > 1 || balance < -1)
+        {
+            const bool rotateC = balance > 1;
+            const uint32_t indexUp = rotateC ? indexC : indexB;
+            const uint32_t indexOther = rotateC ? indexB : indexC;
+            Node& up = _nodes[indexUp];
+            const Node& other = _nodes[indexOther];
+            const uint32_t indexF = up.child1;
+            const uint32_t indexG = up.child2;
+            Node& F = _nodes[indexF];
+            Node& G = _nodes[indexG];
+
+            // Swap A and up.
+            up.child1 = indexA;
+            up.parent = A.parent;
+            A.parent = indexUp;
+
+            if (up.parent != InvalidProxy)
+            {
+                if (_nodes[up.parent].child1 == indexA)
+                    _nodes[up.parent].child1 = indexUp;
+                else
+                    _nodes[up.parent].child2 = indexUp;
+            }
+            else
+            {
+                _root = indexUp;
+            }
+
+            // Keep the taller grandchild under up, the other one replaces up under A.
+            const bool keepF = F.height > G.height;
+            const uint32_t indexKeep = keepF ? indexF : indexG;
+            const uint32_t indexMove = keepF ? indexG : indexF;
+            Node& keep = _nodes[indexKeep];
+            Node& move = _nodes[indexMove];
+
+            up.child2 = indexKeep;
+            if (rotateC)
+                A.child2 = indexMove;
+            else
+                A.child1 = indexMove;
+            move.parent = indexA;
+
+            A.box = Union(other.box, move.box);
+            A.height = 1 + std::max(other.height, move.height);
+            up.box = Union(A.box, keep.box);
+            up.height = 1 + std::max(A.height, keep.height);
+            return indexUp;
+        }
+
+        return indexA;
+    }
+}
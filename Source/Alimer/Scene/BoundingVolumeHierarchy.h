@@ -0,0 +1,280 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Math/Frustum.h"
+#include "../Math/Ray.h"
+#include <vector>
+
+namespace Alimer
+{
+    /// Dynamic bounding volume hierarchy of axis aligned boxes. Leaves store fattened boxes so small motions
+    /// need no tree update, inserts pick the sibling with the lowest surface area cost and rotations keep the tree balanced.
+    class ALIMER_API BoundingVolumeHierarchy final
+    {
+    public:
+        static constexpr uint32_t InvalidProxy = ~0u;
+
+        /// Constructor, margin is added around inserted boxes.
+        explicit BoundingVolumeHierarchy(float margin = 0.1f);
+
+        /// Destructor.
+        ~BoundingVolumeHierarchy();
+
+        /// Insert box and return its proxy.
+        uint32_t CreateProxy(const BoundingBox& box, uint64_t userData);
+
+        /// Remove proxy from the tree.
+        void DestroyProxy(uint32_t proxy);
+
+        /// Update proxy box, the leaf is only reinserted when box leaves the fat box. The new fat box is extended
+        /// along displacement to predict motion. Returns true when the tree changed.
+        bool MoveProxy(uint32_t proxy, const BoundingBox& box, const vec3& displacement = vec3(0.0f));
+
+        /// Return whether box fits in the fat box of proxy, MoveProxy does nothing in that case.
+        bool IsContained(uint32_t proxy, const BoundingBox& box) const;
+
+        /// Get user data given on creation.
+        uint64_t GetUserData(uint32_t proxy) const;
+
+        /// Get fattened box stored in the tree.
+        const BoundingBox& GetFatBox(uint32_t proxy) const;
+
+        /// Get number of proxies.
+        uint32_t GetProxyCount() const { return _proxyCount; }
+
+        /// Get height of the tree, 0 for a single leaf.
+        uint32_t GetHeight() const;
+
+        /// Get summed surface area of internal nodes over root area, lower means cheaper queries.
+        float GetAreaRatio() const;
+
+        /// Remove all proxies.
+        void Clear();
+
+        /// Invoke callback(proxy, userData) for proxies whose fat box overlaps box, traversal stops when it returns false.
+        template <typename Func>
+        void QueryBox(const BoundingBox& box, Func&& callback) const;
+
+        /// Invoke callback(proxy, userData) for proxies whose fat box is not outside the frustum, traversal stops when it returns false.
+        /// Subtrees fully inside the frustum are reported without further plane tests.
+        template <typename Func>
+        void QueryFrustum(const Frustum& frustum, Func&& callback) const;
+
+        /// Invoke callback(proxy, userData, distance) for proxies whose fat box the ray enters within maxDistance, nearer
+        /// subtrees first. The callback returns the new maximum distance, return distance to find the closest hit
+        /// and 0 to stop.
+        template <typename Func>
+        void QueryRay(const Ray& ray, float maxDistance, Func&& callback) const;
+
+    private:
+        struct Node
+        {
+            BoundingBox box;
+            uint64_t userData;
+            /// Parent node, next free node while in the free list.
+            uint32_t parent;
+            uint32_t child1;
+            uint32_t child2;
+            /// Leaf height is 0, free nodes are -1.
+            int32_t height;
+
+            bool IsLeaf() const { return child1 == InvalidProxy; }
+        };
+
+        /// Traversal stack with inline storage, deep trees spill to the heap.
+        template <typename T>
+        class Stack
+        {
+        public:
+            void Push(const T& value)
+            {
+                if (_size < InlineSize)
+                    _inline[_size] = value;
+                else
+                    _overflow.push_back(value);
+                _size++;
+            }
+
+            T Pop()
+            {
+                _size--;
+                if (_size < InlineSize)
+                    return _inline[_size];
+
+                const T value = _overflow.back();
+                _overflow.pop_back();
+                return value;
+            }
+
+            bool IsEmpty() const { return _size == 0; }
+
+        private:
+            static const uint32_t InlineSize = 64;
+            T _inline[InlineSize];
+            std::vector<T> _overflow;
+            uint32_t _size = 0;
+        };
+
+        uint32_t AllocateNode();
+        void FreeNode(uint32_t node);
+        void InsertLeaf(uint32_t leaf);
+        void RemoveLeaf(uint32_t leaf);
+        /// Refit and rebalance ancestors starting at node.
+        void UpdateAncestors(uint32_t node);
+        uint32_t Balance(uint32_t node);
+
+        std::vector<Node> _nodes;
+        uint32_t _root = InvalidProxy;
+        uint32_t _freeList = InvalidProxy;
+        uint32_t _proxyCount = 0;
+        float _margin;
+
+    private:
+        DISALLOW_COPY_MOVE_AND_ASSIGN(BoundingVolumeHierarchy);
+    };
+
+    template <typename Func>
+    void BoundingVolumeHierarchy::QueryBox(const BoundingBox& box, Func&& callback) const
+    {
+        if (_root == InvalidProxy)
+            return;
+
+        Stack<uint32_t> stack;
+        stack.Push(_root);
+        while (!stack.IsEmpty())
+        {
+            const uint32_t index = stack.Pop();
+            const Node& node = _nodes[index];
+            if (!node.box.Intersects(box))
+                continue;
+
+            if (node.IsLeaf())
+            {
+                if (!callback(index, node.userData))
+                    return;
+            }
+            else
+            {
+                stack.Push(node.child1);
+                stack.Push(node.child2);
+            }
+        }
+    }
+
+    template <typename Func>
+    void BoundingVolumeHierarchy::QueryFrustum(const Frustum& frustum, Func&& callback) const
+    {
+        if (_root == InvalidProxy)
+            return;
+
+        struct Entry
+        {
+            uint32_t node;
+            bool inside;
+        };
+
+        Stack<Entry> stack;
+        stack.Push({ _root, false });
+        while (!stack.IsEmpty())
+        {
+            const Entry entry = stack.Pop();
+            const Node& node = _nodes[entry.node];
+            bool inside = entry.inside;
+            if (!inside)
+            {
+                const Intersection intersection = frustum.Intersects(node.box);
+                if (intersection == Intersection::Outside)
+                    continue;
+
+                inside = intersection == Intersection::Inside;
+            }
+
+            if (node.IsLeaf())
+            {
+                if (!callback(entry.node, node.userData))
+                    return;
+            }
+            else
+            {
+                stack.Push({ node.child1, inside });
+                stack.Push({ node.child2, inside });
+            }
+        }
+    }
+
+    template <typename Func>
+    void BoundingVolumeHierarchy::QueryRay(const Ray& ray, float maxDistance, Func&& callback) const
+    {
+        if (_root == InvalidProxy)
+            return;
+
+        struct Entry
+        {
+            uint32_t node;
+            float distance;
+        };
+
+        const vec3 inverseDirection = vec3(1.0f) / ray.direction;
+        const float rootDistance = RayHitDistance(ray.origin, inverseDirection, _nodes[_root].box);
+        if (rootDistance > maxDistance)
+            return;
+
+        Stack<Entry> stack;
+        stack.Push({ _root, rootDistance });
+        while (!stack.IsEmpty())
+        {
+            const Entry entry = stack.Pop();
+            // The maximum distance may have shrunk since the node was pushed.
+            if (entry.distance > maxDistance)
+                continue;
+
+            const Node& node = _nodes[entry.node];
+            if (node.IsLeaf())
+            {
+                maxDistance = callback(entry.node, node.userData, entry.distance);
+                if (maxDistance <= 0.0f)
+                    return;
+                continue;
+            }
+
+            const float distance1 = RayHitDistance(ray.origin, inverseDirection, _nodes[node.child1].box);
+            const float distance2 = RayHitDistance(ray.origin, inverseDirection, _nodes[node.child2].box);
+            // Push the farther child first so the nearer one is visited next.
+            if (distance1 <= distance2)
+            {
+                if (distance2 <= maxDistance)
+                    stack.Push({ node.child2, distance2 });
+                if (distance1 <= maxDistance)
+                    stack.Push({ node.child1, distance1 });
+            }
+            else
+            {
+                if (distance1 <= maxDistance)
+                    stack.Push({ node.child1, distance1 });
+                if (distance2 <= maxDistance)
+                    stack.Push({ node.child2, distance2 });
+            }
+        }
+    }
+}
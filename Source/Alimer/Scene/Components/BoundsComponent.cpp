@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Components/BoundsComponent.h"
+#include <utility>
+
+namespace Alimer
+{
+    BoundsComponent::BoundsComponent(BoundingVolumeHierarchy& tree, const BoundingBox& localBox)
+        : _tree(&tree)
+        , _proxy(BoundingVolumeHierarchy::InvalidProxy)
+        , _localBox(localBox)
+        , _previousCenter(0.0f)
+    {
+    }
+
+    BoundsComponent::BoundsComponent(BoundsComponent&& other)
+        : Component<BoundsComponent>(std::move(other))
+        , _tree(other._tree)
+        , _proxy(other._proxy)
+        , _localBox(other._localBox)
+        , _worldBox(other._worldBox)
+        , _previousCenter(other._previousCenter)
+    {
+        other._tree = nullptr;
+        other._proxy = BoundingVolumeHierarchy::InvalidProxy;
+    }
+
+    BoundsComponent& BoundsComponent::operator=(BoundsComponent&& other)
+    {
+        if (this != &other)
+        {
+            if (_tree && _proxy != BoundingVolumeHierarchy::InvalidProxy)
+            {
+                _tree->DestroyProxy(_proxy);
+            }
+
+            Component<BoundsComponent>::operator=(std::move(other));
+            _tree = other._tree;
+            _proxy = other._proxy;
+            _localBox = other._localBox;
+            _worldBox = other._worldBox;
+            _previousCenter = other._previousCenter;
+            other._tree = nullptr;
+            other._proxy = BoundingVolumeHierarchy::InvalidProxy;
+        }
+
+        return *this;
+    }
+
+    BoundsComponent::~BoundsComponent()
+    {
+        if (_tree && _proxy != BoundingVolumeHierarchy::InvalidProxy)
+        {
+            _tree->DestroyProxy(_proxy);
+        }
+    }
+
+    bool BoundsComponent::UpdateWorldBox(const mat4& world)
+    {
+        _worldBox = _localBox.Transformed(world);
+        return _proxy == BoundingVolumeHierarchy::InvalidProxy || !_tree->IsContained(_proxy, _worldBox);
+    }
+
+    void BoundsComponent::UpdateProxy(Entity::Id id)
+    {
+        const vec3 center = _worldBox.GetCenter();
+        if (_proxy == BoundingVolumeHierarchy::InvalidProxy)
+        {
+            _proxy = _tree->CreateProxy(_worldBox, id.id());
+        }
+        else
+        {
+            _tree->MoveProxy(_proxy, _worldBox, center - _previousCenter);
+        }
+
+        _previousCenter = center;
+    }
+}
@@ -0,0 +1,74 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Entity.h"
+#include "../BoundingVolumeHierarchy.h"
+
+namespace Alimer
+{
+	/// Defines a Bounds Component, a local space box tracked by a BoundingVolumeHierarchy proxy.
+    class ALIMER_API BoundsComponent final : public Component<BoundsComponent>
+	{
+    public:
+        /// Constructor, the proxy is created by the first BoundsSystem update.
+        BoundsComponent(BoundingVolumeHierarchy& tree, const BoundingBox& localBox);
+
+        /// Move constructor.
+        BoundsComponent(BoundsComponent&& other);
+
+        /// Move assignment.
+        BoundsComponent& operator=(BoundsComponent&& other);
+
+        /// Destructor.
+        ~BoundsComponent();
+
+        /// Set box in local space.
+        void SetLocalBox(const BoundingBox& box) { _localBox = box; }
+
+        /// Get box in local space.
+        const BoundingBox& GetLocalBox() const { return _localBox; }
+
+        /// Get world space box computed by the last BoundsSystem update.
+        const BoundingBox& GetWorldBox() const { return _worldBox; }
+
+        /// Get proxy in the tree, InvalidProxy before the first update.
+        uint32_t GetProxy() const { return _proxy; }
+
+        /// Compute world box, returns true when the proxy must be created or moved. Safe to call in parallel.
+        bool UpdateWorldBox(const mat4& world);
+
+        /// Create or move the proxy to the world box, not thread safe.
+        void UpdateProxy(Entity::Id id);
+
+    private:
+        /// Owning tree.
+        BoundingVolumeHierarchy* _tree;
+        /// Proxy in the tree.
+        uint32_t _proxy;
+        BoundingBox _localBox;
+        BoundingBox _worldBox;
+        /// World box center before the last move, used to predict motion.
+        vec3 _previousCenter;
+	};
+}
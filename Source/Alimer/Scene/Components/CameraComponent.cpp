@@ -22,19 +22,15 @@
 
 #include "Scene/Components/CameraComponent.h"
 #include "Scene/Components/TransformComponent.h"
+#include "Math/MatrixKernels.h"
 
 namespace Alimer
 {
-    CameraComponent::~CameraComponent()
-    {
-
-    }
-
-    void CameraComponent::Update(const Transform& transform)
+    void CameraComponent::Update(const mat4& world)
     {
         _projection = mat4::perspective(ToRadians(fovy), aspect, znear, zfar);
-        //_view = transform.Inverse();
-        _view = transform.GetMatrix();
+        _view = inverse_affine(world);
+        _frustum.Define(_projection * _view);
     }
 
     mat4 CameraComponent::GetView() const
@@ -25,6 +25,7 @@
 #include "../Entity.h"
 #include "../../Renderer/Camera.h"
 #include "../../Math/Transform.h"
+#include "../../Math/Frustum.h"
 
 namespace Alimer
 {
@@ -35,13 +36,16 @@ namespace Alimer
 
     public:
         CameraComponent() = default;
-        virtual ~CameraComponent();
 
-        void Update(const Transform& transform);
+        /// Update view and projection from the world matrix.
+        void Update(const mat4& world);
 
         mat4 GetView() const;
         mat4 GetProjection() const;
 
+        /// World space frustum from the last update.
+        const Frustum& GetFrustum() const { return _frustum; }
+
     public:
         // Field of view (in degrees)
         float fovy = 60.0f;
@@ -55,5 +59,6 @@ namespace Alimer
         // Calculated values.
         mat4 _view;
         mat4 _projection;
+        Frustum _frustum;
 	};
 }
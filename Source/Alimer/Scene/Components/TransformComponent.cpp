@@ -21,187 +21,106 @@
 //
 
 #include "../Components/TransformComponent.h"
+#include "../../Math/MatrixKernels.h"
+#include <utility>
 
 namespace Alimer
 {
-    static bool CheckValidParent(const Entity& e, const Entity& parent)
+    TransformComponent::TransformComponent(TransformHierarchy& hierarchy)
+        : _hierarchy(&hierarchy)
+        , _node(hierarchy.Add())
     {
-        if (e == parent)
-            return false;
-
-        if (parent.IsValid() && !parent.HasComponent<TransformComponent>() )
-            return false;
-
-        if (e.IsValid())
-        {
-            auto transform = e.GetComponent<TransformComponent>();
-            if (transform)
-            {
-                for (const auto& child : transform->GetChildren())
-                {
-                    if (!CheckValidParent(child, parent))
-                    {
-                        return false;
-                    }
-                }
-            }
-        }
-
-        return true;
     }
 
-    TransformComponent::~TransformComponent()
+    TransformComponent::TransformComponent(TransformComponent&& other)
+        : Component<TransformComponent>(std::move(other))
+        , _hierarchy(other._hierarchy)
+        , _node(other._node)
+        , _parent(other._parent)
+        , _localTransform(std::move(other._localTransform))
     {
-
+        other._hierarchy = nullptr;
+        other._node = TransformHierarchy::InvalidNode;
     }
 
-    void TransformComponent::UpdateWorldTransform(bool force)
+    TransformComponent& TransformComponent::operator=(TransformComponent&& other)
     {
-        if (force || IsDirty())
+        if (this != &other)
         {
-            if (_parent.IsValid())
+            if (_hierarchy)
             {
-                auto parentTransform = _parent.GetComponent<TransformComponent>();
-                if (parentTransform)
-                {
-                    //_worldTransform = parentTransform->GetTransform() * _localTransform;
-                }
-                else
-                {
-                    _worldTransform = _localTransform;
-                }
-            }
-            else
-            {
-                _worldTransform = _localTransform;
+                _hierarchy->Remove(_node);
             }
 
-            SetDirty(false);
+            Component<TransformComponent>::operator=(std::move(other));
+            _hierarchy = other._hierarchy;
+            _node = other._node;
+            _parent = other._parent;
+            _localTransform = std::move(other._localTransform);
+            other._hierarchy = nullptr;
+            other._node = TransformHierarchy::InvalidNode;
         }
+
+        return *this;
     }
 
-    void TransformComponent::SetDirty(bool dirty)
+    TransformComponent::~TransformComponent()
     {
-        _dirty = dirty;
-
-        if (_dirty)
+        if (_hierarchy)
         {
-            for (const Entity& child : _children)
-            {
-                if (child.IsValid())
-                {
-                    auto childTransform = child.GetComponent<TransformComponent>();
-                    if (childTransform)
-                    {
-                        childTransform->SetDirty(dirty);
-                    }
-                }
-            }
+            _hierarchy->Remove(_node);
         }
     }
 
     void TransformComponent::SetParent(Entity parent)
     {
-        // Check if parent is valid.
-        if (!CheckValidParent(_entity, parent))
-        {
-            return;
-        }
-
-        Transform cachedWorldTransform;
-        const bool keepWorldTransform = true;
-        if (keepWorldTransform)
-        {
-            UpdateWorldTransform(true);
-            cachedWorldTransform = GetTransform();
-        }
-
-        if (_parent.IsValid())
+        uint32_t parentNode = TransformHierarchy::InvalidNode;
+        if (parent.IsValid())
         {
-            auto parentTransform = _parent.GetComponent<TransformComponent>();
-            if (parentTransform)
+            const TransformComponent* parentTransform = parent.GetComponent<TransformComponent>();
+            if (!parentTransform || parentTransform->_hierarchy != _hierarchy)
             {
-                parentTransform->RemoveChild(_entity);
+                return;
             }
-        }
-
-        _parent = parent;
 
-        if (_parent.IsValid())
-        {
-            auto parentTransform = _parent.GetComponent<TransformComponent>();
-            if (parentTransform)
-            {
-                parentTransform->AddChild(_entity);
-            }
+            parentNode = parentTransform->_node;
         }
 
-        if (keepWorldTransform)
-        {
-            UpdateWorldTransform(true);
-            SetTransform(cachedWorldTransform);
-        }
-        else
+        if (_hierarchy->SetParent(_node, parentNode))
         {
-           SetLocalTransform(Transform::Identity);
+            _parent = parent;
         }
-
-        SetDirty(IsDirty());
     }
 
-    void TransformComponent::AddChild(const Entity& child)
+    Entity TransformComponent::GetParent() const
     {
-        _children.push_back(child);
-
-        SetDirty(IsDirty());
-    }
+        // Removing the parent node orphans this node in the hierarchy, _parent is stale from then on.
+        if (!_hierarchy || _hierarchy->GetParent(_node) == TransformHierarchy::InvalidNode)
+            return Entity();
 
-    void TransformComponent::RemoveChild(const Entity& child)
-    {
-        _children.erase(std::remove_if(_children.begin(), _children.end(),
-            [&child](const auto& other) { return child == other; }),
-            _children.end()
-        );
+        return _parent;
     }
 
-    const Transform& TransformComponent::GetTransform()
-    {
-        UpdateWorldTransform();
-        return _worldTransform;
-    }
-
-    const Transform& TransformComponent::GetLocalTransform() const
+    void TransformComponent::SetLocalTransform(const Transform& transform)
     {
-        return _localTransform;
+        _localTransform = transform;
+        _hierarchy->SetLocalMatrix(_node, transform.GetMatrix());
     }
 
     void TransformComponent::SetTransform(const Transform& transform)
     {
-        vec3 position = transform.GetPosition();
-        vec3 scaling = transform.GetScale();
-        quat orientation = transform.GetRotation();
-
-        Transform m = GetTransform();
-        m.SetScale(scaling);
-        m.SetRotation(orientation);
-        m.SetPosition(position);
-
-        if (_parent.IsValid())
+        const uint32_t parentNode = _hierarchy->GetParent(_node);
+        if (parentNode == TransformHierarchy::InvalidNode)
         {
-            auto parentTransform = _parent.GetComponent<TransformComponent>();
-            if (parentTransform)
-            {
-                //Transform inverseParentTransform = inverse(parentTransform->GetTransform());
-                //m = inverseParentTransform * m;
-            }
+            SetLocalTransform(transform);
+            return;
         }
 
-        SetLocalTransform(m);
+        SetLocalTransform(Transform(inverse(_hierarchy->GetWorldMatrix(parentNode)) * transform.GetMatrix()));
     }
 
-    void TransformComponent::SetLocalTransform(const Transform& transform)
+    const mat4& TransformComponent::GetWorldMatrix() const
     {
-        SetDirty(true);
-        _localTransform = transform;
+        return _hierarchy->GetWorldMatrix(_node);
     }
 }
@@ -23,57 +23,62 @@
 #pragma once
 
 #include "../Entity.h"
+#include "../TransformHierarchy.h"
 #include "../../Math/Math.h"
 #include "../../Math/Transform.h"
-#include <vector>
 
 namespace Alimer
 {
-	/// Defines a Transform Component.
+	/// Defines a Transform Component, a handle to a node in the TransformHierarchy.
     class ALIMER_API TransformComponent final : public Component<TransformComponent>
 	{
         //ALIMER_OBJECT(TransformComponent, Component);
 
     public:
-        TransformComponent() = default;
-        virtual ~TransformComponent();
+        /// Constructor.
+        explicit TransformComponent(TransformHierarchy& hierarchy);
 
-        void UpdateWorldTransform(bool force = false);
+        /// Move constructor.
+        TransformComponent(TransformComponent&& other);
 
-        /// Set parent entity
+        /// Move assignment.
+        TransformComponent& operator=(TransformComponent&& other);
+
+        /// Destructor.
+        ~TransformComponent();
+
+        /// Set parent entity, the local transform is kept.
         void SetParent(Entity parent);
 
-        /// Get all chidrens.
-        const std::vector<Entity>& GetChildren() const { return _children; }
+        /// Get parent entity, null once the parent lost its transform and this node became a root.
+        Entity GetParent() const;
 
-        void SetDirty(bool dirty);
-        bool IsDirty() const { return _dirty; }
+        /// Return whether the local transform or the parent changed since the last TransformHierarchy::Update.
+        bool IsDirty() const { return _hierarchy->IsDirty(_node); }
 
-        /// Set transform in world space.
+        /// Set transform in world space, relative to the parent world matrix of the last TransformHierarchy::Update.
         void SetTransform(const Transform& transform);
 
         /// Set transform in local space.
         void SetLocalTransform(const Transform& transform);
 
-        /// Get transform in world space.
-        const Transform& GetTransform();
-
         /// Get transform in local space.
-        const Transform& GetLocalTransform() const;
+        const Transform& GetLocalTransform() const { return _localTransform; }
 
-    private:
-        void AddChild(const Entity& child);
-        void RemoveChild(const Entity& child);
+        /// Get world matrix computed by the last TransformHierarchy::Update.
+        const mat4& GetWorldMatrix() const;
+
+        /// Get hierarchy node.
+        uint32_t GetNode() const { return _node; }
 
+    private:
+        /// Owning hierarchy.
+        TransformHierarchy* _hierarchy;
+        /// Node in the hierarchy.
+        uint32_t _node;
         /// Parent entity.
         Entity _parent;
-        /// Children entitites.
-        std::vector<Entity> _children;
         /// Local transformation relative to the parent
         Transform _localTransform;
-        /// Cached world transformation at pivot point.
-        Transform _worldTransform;
-        /// Transform dirty state.
-        bool _dirty = true;
 	};
 }
@@ -22,43 +22,209 @@
 
 #include "../Scene/Entity.h"
 #include "../Core/Log.h"
+#include "../Math/MathUtil.h"
+#include <atomic>
+#include <mutex>
 
 namespace Alimer
 {
-    uint32_t ComponentIDMapping::ids;
+    static ComponentTypeInfo s_componentTypes[MAX_COMPONENTS];
+    static std::atomic<uint32_t> s_componentTypeCount(0);
+    static std::mutex s_componentTypeMutex;
 
-    // ComponentStorage
-    ComponentStorage::ComponentStorage(std::size_t size)
+    // ComponentIDMapping
+    uint32_t ComponentIDMapping::Register(const ComponentTypeInfo& info)
     {
-        Expand(size);
+        std::lock_guard<std::mutex> lock(s_componentTypeMutex);
+        const uint32_t id = s_componentTypeCount.load(std::memory_order_relaxed);
+        ALIMER_ASSERT_MSG(id < MAX_COMPONENTS, "Too many component families (max %u)", static_cast<uint32_t>(MAX_COMPONENTS));
+        s_componentTypes[id] = info;
+        s_componentTypeCount.store(id + 1, std::memory_order_release);
+        return id;
     }
 
-    void ComponentStorage::Expand(std::size_t size)
+    const ComponentTypeInfo& ComponentIDMapping::GetTypeInfo(uint32_t family)
     {
-        _data.resize(size);
+        assert(family < s_componentTypeCount.load(std::memory_order_acquire));
+        return s_componentTypes[family];
     }
 
-    void ComponentStorage::Reserve(std::size_t size)
+    // Archetype
+    Archetype::Archetype(const ComponentMask& mask)
+        : _mask(mask)
     {
-        _data.reserve(size);
+        _addEdges.fill(nullptr);
+        _removeEdges.fill(nullptr);
+
+        uint32_t rowSize = sizeof(Entity::Id);
+        for (uint32_t family = 0; family < MAX_COMPONENTS; ++family)
+        {
+            _columns[family] = 0;
+            _offsets[family] = 0;
+            _versionOffsets[family] = 0;
+            _sizes[family] = 0;
+            if (_mask.test(family))
+            {
+                _columns[family] = static_cast<uint32_t>(_families.size());
+                _families.push_back(family);
+                _sizes[family] = ComponentIDMapping::GetTypeInfo(family).size;
+                // Component plus changed and added row versions.
+                rowSize += _sizes[family] + 2 * sizeof(uint32_t);
+            }
+        }
+
+        // Lay out chunk versions, entity ids, then each component array followed by its row versions.
+        // Shrink capacity until it fits the chunk.
+        const uint32_t chunkVersionsSize = static_cast<uint32_t>(2 * sizeof(uint32_t) * _families.size());
+        _entitiesOffset = AlignTo(chunkVersionsSize, static_cast<uint32_t>(alignof(Entity::Id)));
+        auto computeLayout = [this](uint32_t capacity) -> uint32_t
+        {
+            uint32_t offset = _entitiesOffset + sizeof(Entity::Id) * capacity;
+            for (uint32_t family : _families)
+            {
+                offset = AlignTo(offset, ComponentIDMapping::GetTypeInfo(family).alignment);
+                _offsets[family] = offset;
+                offset += _sizes[family] * capacity;
+                offset = AlignTo(offset, static_cast<uint32_t>(alignof(uint32_t)));
+                _versionOffsets[family] = offset;
+                offset += 2 * sizeof(uint32_t) * capacity;
+            }
+            return offset;
+        };
+
+        _chunkCapacity = std::max((ARCHETYPE_CHUNK_SIZE - _entitiesOffset) / rowSize, 1u);
+        _chunkSize = computeLayout(_chunkCapacity);
+        while (_chunkSize > ARCHETYPE_CHUNK_SIZE && _chunkCapacity > 1)
+        {
+            _chunkSize = computeLayout(--_chunkCapacity);
+        }
+    }
+
+    Archetype::~Archetype()
+    {
+        Clear();
     }
 
-    BaseComponent* ComponentStorage::Get(std::size_t index)
+    void Archetype::Reserve(uint32_t count)
     {
-        assert(index < size());
-        return _data[index].Get();
+        const uint32_t available = static_cast<uint32_t>(_chunks.size() + _freeChunks.size()) * _chunkCapacity - _size;
+        if (count <= available)
+            return;
+
+        const uint32_t chunkCount = (count - available + _chunkCapacity - 1) / _chunkCapacity;
+        _chunks.reserve(_chunks.size() + _freeChunks.size() + chunkCount);
+        for (uint32_t i = 0; i < chunkCount; ++i)
+        {
+            _freeChunks.push_back(new uint8_t[_chunkSize]);
+        }
+    }
+
+    void Archetype::Allocate(Entity::Id id, uint32_t& chunk, uint32_t& row)
+    {
+        if (_chunks.empty() || _chunks.back().count == _chunkCapacity)
+        {
+            ArchetypeChunk newChunk;
+            if (_freeChunks.empty())
+            {
+                newChunk.data = new uint8_t[_chunkSize];
+            }
+            else
+            {
+                newChunk.data = _freeChunks.back();
+                _freeChunks.pop_back();
+            }
+
+            std::fill_n(reinterpret_cast<uint32_t*>(newChunk.data), 2 * _families.size(), 0u);
+            _chunks.push_back(newChunk);
+        }
+
+        chunk = static_cast<uint32_t>(_chunks.size() - 1);
+        row = _chunks[chunk].count++;
+        GetEntities(chunk)[row] = id;
+        _size++;
     }
 
-    void ComponentStorage::Destroy(std::size_t index)
+    Entity::Id Archetype::Deallocate(uint32_t chunk, uint32_t row)
     {
-        assert(index < size());
-        auto& element = _data[index];
-        element.Reset();
+        const uint32_t lastChunk = static_cast<uint32_t>(_chunks.size() - 1);
+        const uint32_t lastRow = _chunks[lastChunk].count - 1;
+
+        Entity::Id moved = Entity::INVALID;
+        if (chunk != lastChunk || row != lastRow)
+        {
+            // Keep chunks dense by moving the last entity into the hole.
+            for (uint32_t family : _families)
+            {
+                const ComponentTypeInfo& typeInfo = ComponentIDMapping::GetTypeInfo(family);
+                void* source = GetComponent(family, lastChunk, lastRow);
+                typeInfo.move(GetComponent(family, chunk, row), source);
+                typeInfo.destroy(source);
+                SetVersions(family, chunk, row,
+                    GetChangedVersions(family, lastChunk)[lastRow],
+                    GetAddedVersions(family, lastChunk)[lastRow]);
+            }
+
+            moved = GetEntities(lastChunk)[lastRow];
+            GetEntities(chunk)[row] = moved;
+        }
+
+        if (--_chunks[lastChunk].count == 0)
+        {
+            // Keep one spare chunk to avoid allocation churn when an entity moves back and forth.
+            if (_freeChunks.empty())
+            {
+                _freeChunks.push_back(_chunks[lastChunk].data);
+            }
+            else
+            {
+                delete[] _chunks[lastChunk].data;
+            }
+            _chunks.pop_back();
+        }
+
+        _size--;
+        return moved;
     }
 
-    void ComponentStorage::Set(uint32_t index, const IntrusivePtr<BaseComponent>& component)
+    void Archetype::SetVersions(uint32_t family, uint32_t chunk, uint32_t row, uint32_t changed, uint32_t added)
     {
-        _data[index] = component;
+        GetChangedVersions(family, chunk)[row] = changed;
+        GetAddedVersions(family, chunk)[row] = added;
+
+        uint32_t* chunkVersions = GetChunkVersions(chunk);
+        const size_t column = _columns[family];
+        chunkVersions[column] = std::max(chunkVersions[column], changed);
+        chunkVersions[_families.size() + column] = std::max(chunkVersions[_families.size() + column], added);
+    }
+
+    void Archetype::DestroyComponents(uint32_t chunk, uint32_t row)
+    {
+        for (uint32_t family : _families)
+        {
+            ComponentIDMapping::GetTypeInfo(family).destroy(GetComponent(family, chunk, row));
+        }
+    }
+
+    void Archetype::Clear()
+    {
+        for (uint32_t chunk = 0; chunk < GetChunkCount(); ++chunk)
+        {
+            for (uint32_t row = 0; row < _chunks[chunk].count; ++row)
+            {
+                DestroyComponents(chunk, row);
+            }
+
+            delete[] _chunks[chunk].data;
+        }
+
+        for (uint8_t* data : _freeChunks)
+        {
+            delete[] data;
+        }
+
+        _chunks.clear();
+        _freeChunks.clear();
+        _size = 0;
     }
 
     // Entity
@@ -80,7 +246,8 @@ namespace Alimer
     EntityManager::EntityManager()
         : _indexCounter(0)
     {
-
+        // Create the empty archetype.
+        GetArchetype(ComponentMask());
     }
 
     EntityManager::~EntityManager()
@@ -95,12 +262,19 @@ namespace Alimer
         //    entity.destroy();
         //}
 
-        _componentPools.clear();
-        _entityComponentMask.clear();
+        _queries.clear();
+        _archetypes.clear();
+        _archetypeMap.clear();
+        _entityLocation.clear();
 
         _entityVersion.clear();
         _freeList.clear();
+        _aliveMask.clear();
+        _entityNames.clear();
+        _removedComponents.clear();
         _indexCounter = 0;
+
+        GetArchetype(ComponentMask());
     }
 
     Entity EntityManager::Create()
@@ -119,37 +293,105 @@ namespace Alimer
             version = _entityVersion[index];
         }
 
-        Entity entity(this, Entity::Id(index, version));
+        Entity::Id id(index, version);
+        _aliveMask[index / 32] |= 1u << (index % 32);
+        EntityLocation& location = _entityLocation[index];
+        location.archetype = _archetypes.front().get();
+        location.archetype->Allocate(id, location.chunk, location.row);
+
+        Entity entity(this, id);
         // TODO: Fire event
         //onEntityCreated(entity);
         return entity;
     }
 
+    void EntityManager::Reserve(size_t capacity)
+    {
+        _entityLocation.reserve(capacity);
+        _entityVersion.reserve(capacity);
+        _aliveMask.reserve(capacity / 32 + 1);
+    }
+
+    uint32_t EntityManager::NextAlive(uint32_t index) const
+    {
+        const uint32_t capacity = static_cast<uint32_t>(_entityVersion.size());
+        if (index >= capacity)
+            return capacity;
+
+        uint32_t word = index / 32;
+        uint32_t bits = _aliveMask[word] & (~0u << (index % 32));
+        while (bits == 0)
+        {
+            if (++word == _aliveMask.size())
+                return capacity;
+
+            bits = _aliveMask[word];
+        }
+
+        return std::min(word * 32 + ScanForward(bits), capacity);
+    }
+
+    void EntityManager::CreateMany(ArrayView<Entity::Id> ids)
+    {
+        const uint32_t count = ids.size();
+        const uint32_t reused = std::min(count, static_cast<uint32_t>(_freeList.size()));
+        if (count > reused)
+        {
+            // Grow entity storage once for all new indices.
+            AccomodateEntity(_indexCounter + (count - reused) - 1);
+        }
+
+        Archetype* archetype = _archetypes.front().get();
+        archetype->Reserve(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            std::uint32_t index, version;
+            if (i < reused)
+            {
+                index = _freeList.back();
+                _freeList.pop_back();
+                version = _entityVersion[index];
+            }
+            else
+            {
+                index = _indexCounter++;
+                version = _entityVersion[index] = 1;
+            }
+
+            Entity::Id id(index, version);
+            _aliveMask[index / 32] |= 1u << (index % 32);
+            EntityLocation& location = _entityLocation[index];
+            location.archetype = archetype;
+            archetype->Allocate(id, location.chunk, location.row);
+            ids[i] = id;
+        }
+    }
+
     void EntityManager::Destroy(Entity::Id id)
     {
         AssertValid(id);
-        
+
         std::uint32_t index = id.index();
-        auto mask = _entityComponentMask[index];
-        for (size_t i = 0; i < _componentPools.size(); ++i)
+        EntityLocation& location = _entityLocation[index];
+
+        //OnEntityDestroyed(Get(id));
+        if (_trackRemoved)
         {
-            if (mask.test(i))
+            for (uint32_t family : location.archetype->GetFamilies())
             {
-                auto& pool = _componentPools[i];
-                if (pool)
-                {
-                    BaseComponent* component = pool->Get(index);
-                    Remove(id, *component);
-                }
+                _removedComponents.push_back({ id, family, _changeVersion });
             }
         }
 
-        //OnEntityDestroyed(Get(id));
-        _entityComponentMask[index].reset();
+        location.archetype->DestroyComponents(location.chunk, location.row);
+        DeallocateRow(location.archetype, location.chunk, location.row);
+        location = EntityLocation();
+
         _entityVersion[index]++;
         _freeList.push_back(index);
+        _aliveMask[index / 32] &= ~(1u << (index % 32));
         // Remove name
-        _entityNames[id.id()].clear();
+        _entityNames.erase(id.id());
     }
 
     Entity EntityManager::Get(Entity::Id id)
@@ -158,23 +400,149 @@ namespace Alimer
         return Entity(this, id);
     }
 
-    IntrusivePtr<BaseComponent> EntityManager::Assign(Entity::Id id, const ComponentHandle& component)
+    Archetype* EntityManager::GetArchetype(const ComponentMask& mask)
+    {
+        auto it = _archetypeMap.find(mask);
+        if (it != _archetypeMap.end())
+        {
+            return it->second;
+        }
+
+        _archetypes.emplace_back(new Archetype(mask));
+        Archetype* archetype = _archetypes.back().get();
+        _archetypeMap[mask] = archetype;
+
+        // Register in cached queries matching the new archetype.
+        std::lock_guard<std::mutex> lock(_queryMutex);
+        for (auto& pair : _queries)
+        {
+            if ((mask & pair.first) == pair.first)
+            {
+                pair.second->archetypes.push_back(archetype);
+            }
+        }
+
+        return archetype;
+    }
+
+    const EntityQuery& EntityManager::GetQuery(const ComponentMask& mask)
+    {
+        std::lock_guard<std::mutex> lock(_queryMutex);
+        std::unique_ptr<EntityQuery>& query = _queries[mask];
+        if (!query)
+        {
+            query.reset(new EntityQuery());
+            query->mask = mask;
+            for (const auto& archetype : _archetypes)
+            {
+                if ((archetype->GetMask() & mask) == mask)
+                {
+                    query->archetypes.push_back(archetype.get());
+                }
+            }
+        }
+
+        return *query;
+    }
+
+    void EntityManager::DeallocateRow(Archetype* archetype, uint32_t chunk, uint32_t row)
+    {
+        const Entity::Id moved = archetype->Deallocate(chunk, row);
+        if (moved != Entity::INVALID)
+        {
+            EntityLocation& movedLocation = _entityLocation[moved.index()];
+            movedLocation.chunk = chunk;
+            movedLocation.row = row;
+        }
+    }
+
+    void EntityManager::MoveEntity(Entity::Id id, Archetype* target)
+    {
+        EntityLocation& location = _entityLocation[id.index()];
+        Archetype* source = location.archetype;
+
+        uint32_t chunk, row;
+        target->Allocate(id, chunk, row);
+
+        for (uint32_t family : source->GetFamilies())
+        {
+            const ComponentTypeInfo& typeInfo = ComponentIDMapping::GetTypeInfo(family);
+            void* component = source->GetComponent(family, location.chunk, location.row);
+            if (target->HasComponent(family))
+            {
+                typeInfo.move(target->GetComponent(family, chunk, row), component);
+                target->SetVersions(family, chunk, row,
+                    source->GetChangedVersions(family, location.chunk)[location.row],
+                    source->GetAddedVersions(family, location.chunk)[location.row]);
+            }
+            else if (_trackRemoved)
+            {
+                _removedComponents.push_back({ id, family, _changeVersion });
+            }
+
+            typeInfo.destroy(component);
+        }
+
+        DeallocateRow(source, location.chunk, location.row);
+        location.archetype = target;
+        location.chunk = chunk;
+        location.row = row;
+    }
+
+    Archetype* EntityManager::GetAddTarget(Archetype* source, uint32_t family)
+    {
+        Archetype* target = source->_addEdges[family];
+        if (!target)
+        {
+            target = GetArchetype(ComponentMask(source->GetMask()).set(family));
+            source->_addEdges[family] = target;
+            target->_removeEdges[family] = source;
+        }
+
+        return target;
+    }
+
+    void EntityManager::ReserveComponent(ArrayView<const Entity::Id> ids, uint32_t family)
+    {
+        if (ids.size() == 0)
+            return;
+
+        // Entities of a batch usually share their archetype, reserve the target of the first one.
+        AssertValid(ids[0]);
+        Archetype* source = _entityLocation[ids[0].index()].archetype;
+        if (!source->HasComponent(family))
+        {
+            GetAddTarget(source, family)->Reserve(ids.size());
+        }
+    }
+
+    void* EntityManager::AccomodateComponent(Entity::Id id, uint32_t family)
     {
         AssertValid(id);
-        const auto family = component->GetFamily();
+        EntityLocation& location = _entityLocation[id.index()];
+        Archetype* source = location.archetype;
 
-        // Placement new into the component pool.
-        auto& pool = AccomodateComponent(family);
+        if (source->HasComponent(family))
+        {
+            // Replace existing component in place.
+            void* component = source->GetComponent(family, location.chunk, location.row);
+            ComponentIDMapping::GetTypeInfo(family).destroy(component);
+            source->MarkChanged(family, location.chunk, location.row, _changeVersion);
+            return component;
+        }
 
-        pool.Set(id.index(), component);
-        // Set the bit for this component.
-        _entityComponentMask[id.index()].set(family);
+        Archetype* target = GetAddTarget(source, family);
+        MoveEntity(id, target);
+        target->SetVersions(family, location.chunk, location.row, _changeVersion, _changeVersion);
+        return target->GetComponent(family, location.chunk, location.row);
+    }
 
-        // Create and return handle.
-        //component->_entity = Get(id);
-        //component->OnEntitySet();
-        //OnComponentAdded(Get(id), handle);
-        return component;
+    void EntityManager::AssignFrom(Entity::Id id, uint32_t family, void* source)
+    {
+        const ComponentTypeInfo& typeInfo = ComponentIDMapping::GetTypeInfo(family);
+        void* memory = AccomodateComponent(id, family);
+        typeInfo.move(memory, source);
+        typeInfo.cast(memory)->_entity = Entity(this, id);
     }
 
     void EntityManager::Remove(Entity::Id id, const BaseComponent& component)
@@ -185,17 +553,40 @@ namespace Alimer
     void EntityManager::Remove(Entity::Id id, uint32_t family)
     {
         AssertValid(id);
-        const std::uint32_t index = id.index();
+        Archetype* source = _entityLocation[id.index()].archetype;
+        if (!source->HasComponent(family))
+        {
+            return;
+        }
+
+        Archetype* target = source->_removeEdges[family];
+        if (!target)
+        {
+            target = GetArchetype(ComponentMask(source->GetMask()).reset(family));
+            source->_removeEdges[family] = target;
+            target->_addEdges[family] = source;
+        }
 
-        // Find the pool for this component family.
-        auto& pool = _componentPools[family];
-        //BaseComponent* handle = pool->Get(id.index());
         //OnComponentRemoved(Get(id), handle);
-        // Remove component bit.
-        _entityComponentMask[id.index()].reset(family);
+        MoveEntity(id, target);
+    }
 
-        // Call destructor.
-        pool->Destroy(index);
+    void EntityManager::MarkChanged(Entity::Id id, uint32_t family)
+    {
+        AssertValid(id);
+        const EntityLocation& location = _entityLocation[id.index()];
+        if (location.archetype->HasComponent(family))
+        {
+            location.archetype->MarkChanged(family, location.chunk, location.row, _changeVersion);
+        }
+    }
+
+    void EntityManager::TrimRemoved(uint32_t version)
+    {
+        _removedComponents.erase(
+            std::remove_if(_removedComponents.begin(), _removedComponents.end(),
+                [version](const RemovedComponent& removed) { return removed.version <= version; }),
+            _removedComponents.end());
     }
 
     bool EntityManager::HasComponent(Entity::Id id, const BaseComponent& component) const
@@ -206,30 +597,19 @@ namespace Alimer
     bool EntityManager::HasComponent(Entity::Id id, uint32_t family) const
     {
         AssertValid(id);
-
-        // We don't bother checking the component mask, as we return a nullptr anyway.
-        if (family >= _componentPools.size())
-        {
-            return false;
-        }
-        auto& pool = _componentPools[family];
-        return !(!pool || !_entityComponentMask[id.index()][family]);
+        return _entityLocation[id.index()].archetype->HasComponent(family);
     }
 
     std::vector<BaseComponent*> EntityManager::GetAllComponents(Entity::Id id) const
     {
+        AssertValid(id);
+
         std::vector<BaseComponent*> components;
-        auto mask = component_mask(id);
-        for (size_t i = 0; i < _componentPools.size(); ++i)
+        const EntityLocation& location = _entityLocation[id.index()];
+        for (uint32_t family : location.archetype->GetFamilies())
         {
-            if (mask.test(i))
-            {
-                auto& pool = _componentPools[i];
-                if (pool)
-                {
-                    components.push_back(pool->Get(id.index()));
-                }
-            }
+            void* component = location.archetype->GetComponent(family, location.chunk, location.row);
+            components.push_back(ComponentIDMapping::GetTypeInfo(family).cast(component));
         }
         return components;
     }
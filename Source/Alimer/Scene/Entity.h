@@ -26,18 +26,22 @@
 // EnTT: https://github.com/skypjack/entt/blob/master/LICENSE
 // EntityX: https://github.com/alecthomas/entityx
 // Granite: https://github.com/Themaister/Granite
+// Unity DOTS / flecs: archetype chunk storage.
 
 #include <cstdint>
+#include <cstddef>
 #include <tuple>
 #include <new>
 #include <cstdlib>
 #include <algorithm>
+#include <array>
 #include <bitset>
 #include <cassert>
 #include <iostream>
 #include <iterator>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <utility>
@@ -48,64 +52,66 @@
 
 #include  "../Serialization/Serializable.h"
 #include  "../Base/IntrusivePtr.h"
+#include  "../Base/Containers.h"
+#include  "../Core/JobSystem.h"
 
 namespace Alimer
 {
-    struct ComponentIDMapping
-    {
-    public:
-        template <typename T>
-        static uint32_t GetId()
-        {
-            static uint32_t id = ids++;
-            return id;
-        }
+    class BaseComponent;
+    class EntityManager;
 
-    private:
-        static uint32_t ids;
+    /// Maximum number of component families.
+    static const std::size_t MAX_COMPONENTS = 64;
+
+    /// Bitmask of component families.
+    using ComponentMask = std::bitset<MAX_COMPONENTS>;
+
+    /// Size in bytes of a single archetype chunk.
+    static const uint32_t ARCHETYPE_CHUNK_SIZE = 16 * 1024;
+
+    /// Type-erased operations of a component family, used to relocate components between archetype chunks.
+    struct ComponentTypeInfo
+    {
+        uint32_t size;
+        uint32_t alignment;
+        /// Move construct component from source into uninitialized dest memory.
+        void(*move)(void* dest, void* source);
+        /// Call component destructor.
+        void(*destroy)(void* component);
+        /// Cast component memory to BaseComponent.
+        BaseComponent*(*cast)(void* component);
     };
 
-    class BaseComponent;
-    class ComponentStorage
+    struct ALIMER_API ComponentIDMapping
     {
     public:
-        ComponentStorage(std::size_t size = 100);
-
-        inline std::size_t size() const
-        {
-            return _data.size();
-        }
-        inline std::size_t capacity() const
-        {
-            return _data.capacity();
-        }
-        /// Ensure at least n elements will fit in the pool.
-        void Expand(std::size_t size);
-        void Reserve(std::size_t size);
-        BaseComponent* Get(std::size_t index);
-
         template <typename T>
-        T* Get(std::size_t index)
+        static uint32_t GetId()
         {
-            static_assert(std::is_base_of<BaseComponent, T>::value, "Invalid component type.");
-
-            return static_cast<T*>(Get(index));
+            static uint32_t id = Register(CreateTypeInfo<T>());
+            return id;
         }
 
-        void Destroy(std::size_t index);
+        /// Get the type information of given component family.
+        static const ComponentTypeInfo& GetTypeInfo(uint32_t family);
 
-        template <typename T, typename... Args>
-        IntrusivePtr<T> Set(uint32_t index, Args&&... args)
+    private:
+        template <typename T>
+        static ComponentTypeInfo CreateTypeInfo()
         {
-            auto element = MakeHandle<T>(std::forward<Args>(args)...);
-            _data[index] = element;
-            return element;
+            static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned components are not supported.");
+            static_assert(std::is_move_constructible<T>::value, "Components must be move constructible.");
+
+            ComponentTypeInfo info;
+            info.size = static_cast<uint32_t>(sizeof(T));
+            info.alignment = static_cast<uint32_t>(alignof(T));
+            info.move = [](void* dest, void* source) { new (dest) T(std::move(*static_cast<T*>(source))); };
+            info.destroy = [](void* component) { static_cast<T*>(component)->~T(); };
+            info.cast = [](void* component) -> BaseComponent* { return static_cast<T*>(component); };
+            return info;
         }
 
-        void Set(uint32_t index, const IntrusivePtr<BaseComponent>& component);
-
-    private:
-        std::vector<IntrusivePtr<BaseComponent>> _data;
+        static uint32_t Register(const ComponentTypeInfo& info);
     };
 
     /// 
@@ -171,12 +177,9 @@ namespace Alimer
         void SetName(const std::string& name);
         const std::string& GetName() const;
 
-        /// Assign component to entity.
+        /// Assign component to entity, the returned pointer is valid until the next structural change of the entity archetype.
         template <typename T, typename... Args>
-        IntrusivePtr<T> Assign(Args&&... args);
-
-        /// Assign component to entity.
-        IntrusivePtr<BaseComponent> Assign(const IntrusivePtr<BaseComponent>& component);
+        T* Assign(Args&&... args);
 
         /// Remove component from entity.
         template <typename T>
@@ -201,12 +204,14 @@ namespace Alimer
     };
 
     /// Base component class.
-    class ALIMER_API BaseComponent : public IntrusivePtrEnabled<BaseComponent>
+    class ALIMER_API BaseComponent
     {
         friend class EntityManager;
 
     public:
         BaseComponent() = default;
+        BaseComponent(BaseComponent&&) = default;
+        BaseComponent& operator=(BaseComponent&&) = default;
         virtual ~BaseComponent() = default;
 
         Entity GetEntity()
@@ -232,8 +237,10 @@ namespace Alimer
 
     public:
         Component() = default;
-        Component(Component& rhs) = delete;
-        Component& operator=(Component& rhs) = delete;
+        Component(const Component& rhs) = delete;
+        Component& operator=(const Component& rhs) = delete;
+        Component(Component&& rhs) = default;
+        Component& operator=(Component&& rhs) = default;
 
         static uint32_t GetStaticFamilyId()
         {
@@ -241,14 +248,253 @@ namespace Alimer
         }
     };
 
-    using ComponentHandle = IntrusivePtr<BaseComponent>;
+    /// Fixed-size block of entities sharing the same archetype.
+    struct ArchetypeChunk
+    {
+        uint8_t* data = nullptr;
+        uint32_t count = 0;
+    };
+
+    /// Stores all entities with the same component mask in fixed-size chunks,
+    /// each component family is stored as a tightly packed array (SoA).
+    class ALIMER_API Archetype final
+    {
+    public:
+        explicit Archetype(const ComponentMask& mask);
+        ~Archetype();
+
+        /// Get the component mask shared by all entities of this archetype.
+        const ComponentMask& GetMask() const { return _mask; }
+
+        /// Get the sorted component families of this archetype.
+        const std::vector<uint32_t>& GetFamilies() const { return _families; }
+
+        /// Check if archetype contains given component family.
+        bool HasComponent(uint32_t family) const { return _mask.test(family); }
+
+        /// Number of entities in this archetype.
+        uint32_t GetSize() const { return _size; }
+
+        /// Maximum number of entities per chunk.
+        uint32_t GetChunkCapacity() const { return _chunkCapacity; }
+
+        /// Number of allocated chunks, all but the last one are full.
+        uint32_t GetChunkCount() const { return static_cast<uint32_t>(_chunks.size()); }
+
+        /// Number of entities in given chunk.
+        uint32_t GetChunkSize(uint32_t chunk) const { return _chunks[chunk].count; }
+
+        /// Get the packed entity ids of given chunk.
+        Entity::Id* GetEntities(uint32_t chunk) const
+        {
+            return reinterpret_cast<Entity::Id*>(_chunks[chunk].data + _entitiesOffset);
+        }
+
+        /// Get the packed component array of given family in given chunk.
+        void* GetComponents(uint32_t family, uint32_t chunk) const
+        {
+            assert(HasComponent(family));
+            return _chunks[chunk].data + _offsets[family];
+        }
+
+        template <typename T>
+        T* GetComponents(uint32_t chunk) const
+        {
+            return static_cast<T*>(GetComponents(ComponentIDMapping::GetId<T>(), chunk));
+        }
+
+        /// Get the component of given family at chunk row.
+        void* GetComponent(uint32_t family, uint32_t chunk, uint32_t row) const
+        {
+            assert(HasComponent(family) && row < _chunks[chunk].count);
+            return _chunks[chunk].data + _offsets[family] + row * _sizes[family];
+        }
+
+        /// Get the per row change versions of given family in given chunk.
+        uint32_t* GetChangedVersions(uint32_t family, uint32_t chunk) const
+        {
+            assert(HasComponent(family));
+            return reinterpret_cast<uint32_t*>(_chunks[chunk].data + _versionOffsets[family]);
+        }
+
+        /// Get the per row versions at which given family was added in given chunk.
+        uint32_t* GetAddedVersions(uint32_t family, uint32_t chunk) const
+        {
+            return GetChangedVersions(family, chunk) + _chunkCapacity;
+        }
+
+        /// Get the highest change version of given family in given chunk.
+        uint32_t GetChunkChangedVersion(uint32_t family, uint32_t chunk) const
+        {
+            return GetChunkVersions(chunk)[_columns[family]];
+        }
+
+        /// Get the highest added version of given family in given chunk.
+        uint32_t GetChunkAddedVersion(uint32_t family, uint32_t chunk) const
+        {
+            return GetChunkVersions(chunk)[_families.size() + _columns[family]];
+        }
+
+        /// Set the change and added versions of given row, raising the chunk versions accordingly.
+        void SetVersions(uint32_t family, uint32_t chunk, uint32_t row, uint32_t changed, uint32_t added);
+
+        /// Mark the component of given family at chunk row as changed.
+        void MarkChanged(uint32_t family, uint32_t chunk, uint32_t row, uint32_t version)
+        {
+            GetChangedVersions(family, chunk)[row] = version;
+            MarkChunkChanged(family, chunk, version);
+        }
+
+        /// Mark a range of rows as changed without touching the chunk version, see MarkChunkChanged.
+        void MarkRowsChanged(uint32_t family, uint32_t chunk, uint32_t begin, uint32_t count, uint32_t version)
+        {
+            uint32_t* versions = GetChangedVersions(family, chunk) + begin;
+            std::fill(versions, versions + count, version);
+        }
+
+        /// Raise the chunk change version of given family.
+        void MarkChunkChanged(uint32_t family, uint32_t chunk, uint32_t version)
+        {
+            uint32_t& chunkVersion = GetChunkVersions(chunk)[_columns[family]];
+            chunkVersion = std::max(chunkVersion, version);
+        }
+
+        /// Ensure storage for count more entities is allocated.
+        void Reserve(uint32_t count);
+
+        /// Allocate a new row for given entity, component memory is left uninitialized.
+        void Allocate(Entity::Id id, uint32_t& chunk, uint32_t& row);
+
+        /// Release row moving the last entity into the hole, components must be already destroyed or moved out.
+        /// Returns the id of the moved entity or Entity::INVALID.
+        Entity::Id Deallocate(uint32_t chunk, uint32_t row);
+
+        /// Destroy all components of given row.
+        void DestroyComponents(uint32_t chunk, uint32_t row);
+
+        /// Destroy all components and release all chunks.
+        void Clear();
+
+    private:
+        friend class EntityManager;
+
+        // Chunk versions are stored at the start of the chunk, changed versions first then added versions, indexed by column.
+        uint32_t* GetChunkVersions(uint32_t chunk) const
+        {
+            return reinterpret_cast<uint32_t*>(_chunks[chunk].data);
+        }
+
+        ComponentMask _mask;
+        std::vector<uint32_t> _families;
+        /// Index of each family in _families.
+        uint32_t _columns[MAX_COMPONENTS];
+        /// Byte offset of the entity ids inside a chunk.
+        uint32_t _entitiesOffset = 0;
+        /// Byte offset of each component array inside a chunk, indexed by family.
+        uint32_t _offsets[MAX_COMPONENTS];
+        /// Byte offset of each row version array inside a chunk, indexed by family.
+        uint32_t _versionOffsets[MAX_COMPONENTS];
+        /// Byte size of each component, indexed by family.
+        uint32_t _sizes[MAX_COMPONENTS];
+        uint32_t _chunkCapacity = 0;
+        uint32_t _chunkSize = 0;
+        uint32_t _size = 0;
+        std::vector<ArchetypeChunk> _chunks;
+        /// Chunk memory reserved or released for reuse.
+        std::vector<uint8_t*> _freeChunks;
+        /// Cached transitions when adding or removing a single component family.
+        std::array<Archetype*, MAX_COMPONENTS> _addEdges;
+        std::array<Archetype*, MAX_COMPONENTS> _removeEdges;
+
+        DISALLOW_COPY_MOVE_AND_ASSIGN(Archetype);
+    };
+
+    /// Query filter matching entities whose component T changed after the query version.
+    template <typename T>
+    struct Changed {};
+
+    /// Query filter matching entities whose component T was added after the query version.
+    template <typename T>
+    struct Added {};
+
+    namespace details
+    {
+        /// Unwraps query filters, T may be const qualified for read only access.
+        template <typename T>
+        struct ComponentFilter
+        {
+            using Type = T;
+            static constexpr bool IsFilter = false;
+
+            static uint32_t GetChunkVersion(const Archetype&, uint32_t, uint32_t) { return ~0u; }
+            static uint32_t GetRowVersion(const Archetype&, uint32_t, uint32_t, uint32_t) { return ~0u; }
+        };
+
+        template <typename T>
+        struct ComponentFilter<Changed<T>>
+        {
+            using Type = T;
+            static constexpr bool IsFilter = true;
+
+            static uint32_t GetChunkVersion(const Archetype& archetype, uint32_t family, uint32_t chunk)
+            {
+                return archetype.GetChunkChangedVersion(family, chunk);
+            }
+
+            static uint32_t GetRowVersion(const Archetype& archetype, uint32_t family, uint32_t chunk, uint32_t row)
+            {
+                return archetype.GetChangedVersions(family, chunk)[row];
+            }
+        };
+
+        template <typename T>
+        struct ComponentFilter<Added<T>>
+        {
+            using Type = T;
+            static constexpr bool IsFilter = true;
+
+            static uint32_t GetChunkVersion(const Archetype& archetype, uint32_t family, uint32_t chunk)
+            {
+                return archetype.GetChunkAddedVersion(family, chunk);
+            }
+
+            static uint32_t GetRowVersion(const Archetype& archetype, uint32_t family, uint32_t chunk, uint32_t row)
+            {
+                return archetype.GetAddedVersions(family, chunk)[row];
+            }
+        };
+
+        /// Component type passed to query callbacks.
+        template <typename T>
+        using ComponentType = typename ComponentFilter<T>::Type;
+
+        /// Component type used to resolve the component family.
+        template <typename T>
+        using ComponentFamilyType = typename std::remove_const<ComponentType<T>>::type;
+
+        template <typename T>
+        struct IsMutableComponent : std::integral_constant<bool, !std::is_const<ComponentType<T>>::value> {};
+
+        template <typename... Components>
+        struct HasComponentFilter : std::false_type {};
+
+        template <typename T, typename... Components>
+        struct HasComponentFilter<T, Components...>
+            : std::integral_constant<bool, ComponentFilter<T>::IsFilter || HasComponentFilter<Components...>::value> {};
+    }
+
+    /// Archetypes matching a component mask, kept up to date as new archetypes are created.
+    struct EntityQuery
+    {
+        ComponentMask mask;
+        std::vector<Archetype*> archetypes;
+    };
 
     /// Manages the relationship between an Entity and its components
-    static const std::size_t MAX_COMPONENTS = 64;
     class ALIMER_API EntityManager final
     {
     public:
-        using ComponentMask = std::bitset<MAX_COMPONENTS>;
+        using ComponentMask = Alimer::ComponentMask;
 
         explicit EntityManager();
         ~EntityManager();
@@ -257,6 +503,9 @@ namespace Alimer
         /// Create a new entity.
         Entity Create();
 
+        /// Create ids.size() entities at once, storage is grown a single time.
+        void CreateMany(ArrayView<Entity::Id> ids);
+
         /// Destroy an existing Entity and all its Components.
         void Destroy(Entity::Id id);
 
@@ -269,10 +518,13 @@ namespace Alimer
         }
 
         /// Number of managed entities.
-        size_t GetSize() const { return _entityComponentMask.size() - _freeList.size(); }
+        size_t GetSize() const { return _entityVersion.size() - _freeList.size(); }
 
         /// Gets the current entity capacity.
-        size_t GetCapacity() const { return _entityComponentMask.size(); }
+        size_t GetCapacity() const { return _entityVersion.size(); }
+
+        /// Reserve storage for given number of entities, avoids reallocation when creating many entities.
+        void Reserve(size_t capacity);
 
         /// Return true if the given entity ID is still valid.
         bool IsValid(Entity::Id id) const
@@ -280,17 +532,42 @@ namespace Alimer
             return id.index() < _entityVersion.size() && _entityVersion[id.index()] == id.version();
         }
 
+        /// Assign component to entity, moving the entity into the matching archetype.
+        /// The returned pointer is valid until the next structural change of the entity archetype.
         template <typename T, typename... Args>
-        IntrusivePtr<T> Assign(Entity::Id id, Args&&... args)
+        T* Assign(Entity::Id id, Args&&... args)
         {
             static_assert(std::is_base_of<BaseComponent, T>(), "T is not a component, cannot add T to entity");
 
-            IntrusivePtr<T> handle = MakeHandle<T>(std::forward<Args>(args)...);
-            Assign(id, handle);
-            return handle;
+            void* memory = AccomodateComponent(id, ComponentIDMapping::GetId<T>());
+            T* component = new (memory) T(std::forward<Args>(args)...);
+            static_cast<BaseComponent*>(component)->_entity = Entity(this, id);
+            return component;
+        }
+
+        /// Assign component T to each entity, constructed from init(i) where i is the position in ids.
+        /// Storage in the target archetype is reserved once for the whole batch.
+        template <typename T, typename Init>
+        void AssignMany(ArrayView<const Entity::Id> ids, Init&& init)
+        {
+            static_assert(std::is_base_of<BaseComponent, T>(), "T is not a component, cannot add T to entity");
+
+            const uint32_t family = ComponentIDMapping::GetId<T>();
+            ReserveComponent(ids, family);
+            for (uint32_t i = 0; i < ids.size(); ++i)
+            {
+                void* memory = AccomodateComponent(ids[i], family);
+                T* component = new (memory) T(init(i));
+                static_cast<BaseComponent*>(component)->_entity = Entity(this, ids[i]);
+            }
         }
 
-        IntrusivePtr<BaseComponent> Assign(Entity::Id id, const ComponentHandle& component);
+        /// Assign default constructed component T to each entity.
+        template <typename T>
+        void AssignMany(ArrayView<const Entity::Id> ids)
+        {
+            AssignMany<T>(ids, [](uint32_t) { return T(); });
+        }
 
         /// Remove a component from an Entity.
         template <typename T>
@@ -316,17 +593,16 @@ namespace Alimer
         T* GetComponent(Entity::Id id)
         {
             AssertValid(id);
-            auto family = ComponentIDMapping::GetId<T>();
-            if (family >= _componentPools.size())
+            const uint32_t family = ComponentIDMapping::GetId<T>();
+            const EntityLocation& location = _entityLocation[id.index()];
+            if (!location.archetype->HasComponent(family))
             {
                 return nullptr;
             }
-            auto& pool = _componentPools[family];
-            if (!pool || !_entityComponentMask[id.index()][family])
-            {
-                return nullptr;
-            }
-            return pool->template Get<T>(id.index());
+
+            // Mutable access, consider the component changed.
+            location.archetype->MarkChanged(family, location.chunk, location.row, _changeVersion);
+            return static_cast<T*>(location.archetype->GetComponent(family, location.chunk, location.row));
         }
 
         std::vector<BaseComponent*> GetAllComponents(Entity::Id id) const;
@@ -337,6 +613,13 @@ namespace Alimer
         /// Get entity name
         const std::string& GetEntityName(Entity::Id id);
 
+        /// Get all archetypes created so far.
+        const std::vector<std::unique_ptr<Archetype>>& GetArchetypes() const { return _archetypes; }
+
+        /// Get the cached query of archetypes containing all components of mask, iteration cost is proportional to the matches.
+        /// Queries live as long as the EntityManager or until Reset.
+        const EntityQuery& GetQuery(const ComponentMask& mask);
+
         /// An iterator over a view of the entities in an EntityManager.
         /// If All is true it will iterate over all valid entities and will ignore the entity mask.
         template <class Delegate, bool All = false>
@@ -354,22 +637,15 @@ namespace Alimer
 
         protected:
             ViewIterator(EntityManager *manager, uint32_t index)
-                : manager_(manager), i_(index), capacity_(manager_->GetCapacity()), free_cursor_(~0UL) {
-                if (All) {
-                    std::sort(manager_->_freeList.begin(), manager_->_freeList.end());
-                    free_cursor_ = 0;
-                }
+                : manager_(manager), i_(index), capacity_(manager_->GetCapacity()) {
             }
             ViewIterator(EntityManager *manager, const ComponentMask mask, uint32_t index)
-                : manager_(manager), mask_(mask), i_(index), capacity_(manager_->GetCapacity()), free_cursor_(~0UL) {
-                if (All) {
-                    std::sort(manager_->_freeList.begin(), manager_->_freeList.end());
-                    free_cursor_ = 0;
-                }
+                : manager_(manager), mask_(mask), i_(index), capacity_(manager_->GetCapacity()) {
             }
 
             void next() {
-                while (i_ < capacity_ && !predicate()) {
+                // Destroyed entities are skipped a word at a time using the alive bitmap.
+                while ((i_ = manager_->NextAlive(i_)) < capacity_ && !predicate()) {
                     ++i_;
                 }
 
@@ -380,23 +656,13 @@ namespace Alimer
             }
 
             inline bool predicate() {
-                return (All && valid_entity()) || (manager_->_entityComponentMask[i_] & mask_) == mask_;
-            }
-
-            inline bool valid_entity() {
-                const std::vector<uint32_t> &free_list = manager_->_freeList;
-                if (free_cursor_ < free_list.size() && free_list[free_cursor_] == i_) {
-                    ++free_cursor_;
-                    return false;
-                }
-                return true;
+                return All || (manager_->GetComponentMask(i_) & mask_) == mask_;
             }
 
             EntityManager *manager_;
             ComponentMask mask_;
             uint32_t i_;
             size_t capacity_;
-            size_t free_cursor_;
         };
 
         template <bool All>
@@ -429,136 +695,384 @@ namespace Alimer
             ComponentMask mask_;
         };
 
-        template <bool All, typename ... Components>
-        class TypedView : public BaseView<All> {
+        /// View over all entities whose archetype contains the given components, walking archetype chunks in memory order.
+        template <typename ... Components>
+        class TypedView {
         public:
-            template <typename T> struct identity { typedef T type; };
+            class Iterator : public std::iterator<std::input_iterator_tag, Entity> {
+            public:
+                Iterator(EntityManager *manager, const EntityQuery* query, size_t archetype)
+                    : manager_(manager), query_(query), archetype_(archetype), chunk_(0), row_(0) {
+                    skip();
+                }
+
+                Iterator &operator ++() {
+                    if (++row_ >= query_->archetypes[archetype_]->GetChunkSize(chunk_)) {
+                        row_ = 0;
+                        ++chunk_;
+                        skip();
+                    }
+                    return *this;
+                }
+
+                bool operator == (const Iterator& rhs) const {
+                    return archetype_ == rhs.archetype_ && chunk_ == rhs.chunk_ && row_ == rhs.row_;
+                }
+                bool operator != (const Iterator& rhs) const { return !(*this == rhs); }
+
+                Entity operator * () const {
+                    return Entity(manager_, query_->archetypes[archetype_]->GetEntities(chunk_)[row_]);
+                }
+
+            private:
+                // Advance to the next non empty chunk of a matching archetype.
+                void skip() {
+                    while (archetype_ < query_->archetypes.size()) {
+                        if (chunk_ < query_->archetypes[archetype_]->GetChunkCount()) {
+                            return;
+                        }
+
+                        ++archetype_;
+                        chunk_ = 0;
+                    }
+
+                    chunk_ = 0;
+                }
+
+                EntityManager *manager_;
+                const EntityQuery* query_;
+                size_t archetype_;
+                uint32_t chunk_;
+                uint32_t row_;
+            };
 
-            void each(typename identity<std::function<void(Entity entity, Components&...)>>::type f)
+            Iterator begin() { return Iterator(manager_, query_, 0); }
+            Iterator end() { return Iterator(manager_, query_, query_->archetypes.size()); }
+
+            /// Invoke f(Entity, Components&...) for each matching entity.
+            template <typename Func>
+            void each(Func&& f)
             {
-                for (auto it : *this)
+                // Resolve component families once per query.
+                const uint32_t families[] = { ComponentIDMapping::GetId<details::ComponentFamilyType<Components>>()... };
+                for_each_chunk_(families, [&](Archetype* archetype, uint32_t chunk)
                 {
-                    f(it, *(it.template GetComponent<Components>())...);
-                }
+                    mark_chunk_(archetype, families, chunk, std::index_sequence_for<Components...>());
+                    each_rows_(f, families, archetype, chunk, 0, archetype->GetChunkSize(chunk), std::index_sequence_for<Components...>());
+                });
             }
 
-        private:
-            friend class EntityManager;
+            /// Invoke f(count, ids, Components*...) for each matching chunk, passing the packed component arrays.
+            /// Change filters are applied per chunk, f receives every row of a chunk holding at least one change.
+            template <typename Func>
+            void each_chunk(Func&& f)
+            {
+                const uint32_t families[] = { ComponentIDMapping::GetId<details::ComponentFamilyType<Components>>()... };
+                for_each_chunk_(families, [&](Archetype* archetype, uint32_t chunk)
+                {
+                    const uint32_t count = archetype->GetChunkSize(chunk);
+                    mark_chunk_(archetype, families, chunk, std::index_sequence_for<Components...>());
+                    invoke_slice_(f, families, archetype, chunk, 0, count, std::index_sequence_for<Components...>());
+                    mark_rows_(archetype, families, chunk, 0, count, std::index_sequence_for<Components...>());
+                });
+            }
 
-            explicit TypedView(EntityManager *manager) : BaseView<All>(manager) {}
-            TypedView(EntityManager *manager, ComponentMask mask) : BaseView<All>(manager, mask) {}
-        };
+            /// Invoke f(Archetype&, chunk) for each matching chunk, nothing is marked as changed.
+            template <typename Func>
+            void each_archetype_chunk(Func&& f)
+            {
+                const uint32_t families[] = { ComponentIDMapping::GetId<details::ComponentFamilyType<Components>>()... };
+                for_each_chunk_(families, [&](Archetype* archetype, uint32_t chunk)
+                {
+                    f(*archetype, chunk);
+                });
+            }
 
-        template <typename ... Components> using View = TypedView<false, Components...>;
-        using DebugView = BaseView<true>;
+            /// Invoke f(Entity, Components&...) for each matching entity on JobSystem workers.
+            template <typename Func>
+            void parallel_each(Func&& f, uint32_t grainSize)
+            {
+                const uint32_t families[] = { ComponentIDMapping::GetId<details::ComponentFamilyType<Components>>()... };
+                parallel_(families, grainSize, [&](Archetype* archetype, uint32_t chunk, uint32_t begin, uint32_t count)
+                {
+                    each_rows_(f, families, archetype, chunk, begin, count, std::index_sequence_for<Components...>());
+                });
+            }
 
-        template <typename ... Components>
-        class UnpackingView {
-        public:
-            struct Unpacker {
-                explicit Unpacker(IntrusivePtr<Components> & ... handles)
-                    : handles(std::tuple<IntrusivePtr<Components> & ...>(handles...))
+            /// Invoke f(count, ids, Components*...) for slices of matching chunks on JobSystem workers.
+            /// Slices hold at most grainSize entities and are batched so each job processes about grainSize entities.
+            /// Returns once every slice has been processed.
+            template <typename Func>
+            void parallel_each_chunk(Func&& f, uint32_t grainSize)
+            {
+                const uint32_t families[] = { ComponentIDMapping::GetId<details::ComponentFamilyType<Components>>()... };
+                parallel_(families, grainSize, [&](Archetype* archetype, uint32_t chunk, uint32_t begin, uint32_t count)
                 {
-                }
+                    invoke_slice_(f, families, archetype, chunk, begin, count, std::index_sequence_for<Components...>());
+                    mark_rows_(archetype, families, chunk, begin, count, std::index_sequence_for<Components...>());
+                });
+            }
+
+        private:
+            friend class EntityManager;
+
+            TypedView(EntityManager *manager, const EntityQuery* query, uint32_t since)
+                : manager_(manager), query_(query), since_(since) {}
 
-                void unpack(Alimer::Entity &entity) const
+            // Visit chunks of matching archetypes that pass the chunk level change filters.
+            template <typename Visitor>
+            void for_each_chunk_(const uint32_t* families, Visitor&& visitor)
+            {
+                for (Archetype* archetype : query_->archetypes)
                 {
-                    unpack_<0, Components...>(entity);
+                    for (uint32_t chunk = 0; chunk < archetype->GetChunkCount(); ++chunk)
+                    {
+                        if (chunk_passes_(archetype, families, chunk, std::index_sequence_for<Components...>()))
+                        {
+                            visitor(archetype, chunk);
+                        }
+                    }
                 }
+            }
 
+            // Split matching chunks in slices and run them on JobSystem workers, chunk versions are marked before dispatch.
+            template <typename SliceFunc>
+            void parallel_(const uint32_t* families, uint32_t grainSize, SliceFunc&& sliceFunc)
+            {
+                struct Slice
+                {
+                    Archetype* archetype;
+                    uint32_t chunk;
+                    uint32_t begin;
+                    uint32_t count;
+                };
+
+                grainSize = std::max(grainSize, 1u);
+                std::vector<Slice> slices;
+                uint32_t entityCount = 0;
+                for_each_chunk_(families, [&](Archetype* archetype, uint32_t chunk)
+                {
+                    const uint32_t chunkSize = archetype->GetChunkSize(chunk);
+                    mark_chunk_(archetype, families, chunk, std::index_sequence_for<Components...>());
+                    for (uint32_t begin = 0; begin < chunkSize; begin += grainSize)
+                    {
+                        slices.push_back({ archetype, chunk, begin, std::min(grainSize, chunkSize - begin) });
+                    }
+                    entityCount += chunkSize;
+                });
 
-            private:
-                template <int N, typename C>
-                void unpack_(Alimer::Entity &entity) const {
-                    std::get<N>(handles) = entity.component<C>();
-                }
+                if (slices.empty())
+                    return;
 
-                template <int N, typename C0, typename C1, typename ... Cn>
-                void unpack_(Alimer::Entity &entity) const {
-                    std::get<N>(handles) = entity.component<C0>();
-                    unpack_<N + 1, C1, Cn...>(entity);
-                }
+                const uint32_t sliceCount = static_cast<uint32_t>(slices.size());
+                const uint32_t slicesPerBatch = std::max(1u, static_cast<uint32_t>(uint64_t(grainSize) * sliceCount / entityCount));
+                JobSystem::GetInstance()->ParallelFor(sliceCount, slicesPerBatch, [&](uint32_t begin, uint32_t end)
+                {
+                    for (uint32_t i = begin; i < end; ++i)
+                    {
+                        const Slice& slice = slices[i];
+                        sliceFunc(slice.archetype, slice.chunk, slice.begin, slice.count);
+                    }
+                });
+            }
 
-                std::tuple<IntrusivePtr<Components> & ...> handles;
-            };
+            template <typename Func, size_t... Indices>
+            void each_rows_(Func& f, const uint32_t* families, Archetype* archetype, uint32_t chunk, uint32_t begin, uint32_t count, std::index_sequence<Indices...>)
+            {
+                const Entity::Id* ids = archetype->GetEntities(chunk);
+                std::tuple<details::ComponentType<Components>*...> components(
+                    static_cast<details::ComponentType<Components>*>(archetype->GetComponents(families[Indices], chunk))...);
 
+                const uint32_t end = begin + count;
+                if (!details::HasComponentFilter<Components...>::value)
+                {
+                    for (uint32_t row = begin; row < end; ++row)
+                    {
+                        f(Entity(manager_, ids[row]), std::get<Indices>(components)[row]...);
+                    }
 
-            class Iterator : public ViewIterator<Iterator> {
-            public:
-                Iterator(EntityManager *manager,
-                    const ComponentMask mask,
-                    uint32_t index,
-                    const Unpacker &unpacker) : ViewIterator<Iterator>(manager, mask, index), unpacker_(unpacker) {
-                    ViewIterator<Iterator>::next();
+                    mark_rows_(archetype, families, chunk, begin, count, std::index_sequence<Indices...>());
+                    return;
                 }
 
-                void next_entity(Entity &entity) {
-                    unpacker_.unpack(entity);
-                }
+                for (uint32_t row = begin; row < end; ++row)
+                {
+                    if (!row_passes_(archetype, families, chunk, row, std::index_sequence<Indices...>()))
+                        continue;
 
-            private:
-                const Unpacker &unpacker_;
-            };
+                    f(Entity(manager_, ids[row]), std::get<Indices>(components)[row]...);
+                    mark_rows_(archetype, families, chunk, row, 1, std::index_sequence<Indices...>());
+                }
+            }
 
+            template <typename Func, size_t... Indices>
+            static void invoke_slice_(Func& f, const uint32_t* families, const Archetype* archetype, uint32_t chunk, uint32_t begin, uint32_t count, std::index_sequence<Indices...>)
+            {
+                f(count,
+                    archetype->GetEntities(chunk) + begin,
+                    static_cast<details::ComponentType<Components>*>(archetype->GetComponents(families[Indices], chunk)) + begin...);
+            }
 
-            Iterator begin() { return Iterator(manager_, mask_, 0, unpacker_); }
-            Iterator end() { return Iterator(manager_, mask_, static_cast<uint32_t>(manager_->GetCapacity()), unpacker_); }
-            const Iterator begin() const { return Iterator(manager_, mask_, 0, unpacker_); }
-            const Iterator end() const { return Iterator(manager_, mask_, static_cast<uint32_t>(manager_->GetCapacity()), unpacker_); }
+            template <size_t... Indices>
+            bool chunk_passes_(const Archetype* archetype, const uint32_t* families, uint32_t chunk, std::index_sequence<Indices...>) const
+            {
+                const uint32_t versions[] = { details::ComponentFilter<Components>::GetChunkVersion(*archetype, families[Indices], chunk)... };
+                for (uint32_t version : versions)
+                {
+                    if (version <= since_)
+                        return false;
+                }
+                return true;
+            }
 
+            template <size_t... Indices>
+            bool row_passes_(const Archetype* archetype, const uint32_t* families, uint32_t chunk, uint32_t row, std::index_sequence<Indices...>) const
+            {
+                const uint32_t versions[] = { details::ComponentFilter<Components>::GetRowVersion(*archetype, families[Indices], chunk, row)... };
+                for (uint32_t version : versions)
+                {
+                    if (version <= since_)
+                        return false;
+                }
+                return true;
+            }
 
-        private:
-            friend class EntityManager;
+            // Mutable access marks components as changed, const qualified components are left untouched.
+            template <size_t... Indices>
+            void mark_chunk_(Archetype* archetype, const uint32_t* families, uint32_t chunk, std::index_sequence<Indices...>) const
+            {
+                const bool mutableComponents[] = { details::IsMutableComponent<Components>::value... };
+                for (size_t i = 0; i < sizeof...(Components); ++i)
+                {
+                    if (mutableComponents[i])
+                        archetype->MarkChunkChanged(families[i], chunk, manager_->_changeVersion);
+                }
+            }
 
-            UnpackingView(EntityManager *manager, ComponentMask mask, IntrusivePtr<Components> & ... handles)
-                : manager_(manager), mask_(mask), unpacker_(handles...)
+            template <size_t... Indices>
+            void mark_rows_(Archetype* archetype, const uint32_t* families, uint32_t chunk, uint32_t begin, uint32_t count, std::index_sequence<Indices...>) const
             {
+                const bool mutableComponents[] = { details::IsMutableComponent<Components>::value... };
+                for (size_t i = 0; i < sizeof...(Components); ++i)
+                {
+                    if (mutableComponents[i])
+                        archetype->MarkRowsChanged(families[i], chunk, begin, count, manager_->_changeVersion);
+                }
             }
 
             EntityManager *manager_;
-            ComponentMask mask_;
-            Unpacker unpacker_;
+            const EntityQuery* query_;
+            uint32_t since_;
         };
 
+        template <typename ... Components> using View = TypedView<Components...>;
+        using DebugView = BaseView<true>;
+
+        /// Get a view over all alive entities.
+        DebugView AllEntities() { return DebugView(this); }
+
+        /// Get a view of entities with the given components, Changed<T> and Added<T> filters only match changes after since.
         template <typename ... Components>
-        View<Components...> EntitiesWithComponents() {
-            auto mask = component_mask<Components ...>();
-            return View<Components...>(this, mask);
+        View<Components...> EntitiesWithComponents(uint32_t since = 0) {
+            auto mask = component_mask<details::ComponentFamilyType<Components>...>();
+            return View<Components...>(this, &GetQuery(mask), since);
         }
 
-        template <typename T> struct identity { typedef T type; };
+        /// Invoke f(Entity, Components&...) for each entity with the given components, f is inlined into the chunk loop.
+        /// Non const components are marked as changed, Changed<T> and Added<T> filters skip entities not modified after since.
+        template <typename ... Components, typename Func>
+        void Each(Func&& f, uint32_t since = 0) {
+            EntitiesWithComponents<Components...>(since).each(std::forward<Func>(f));
+        }
 
-        template <typename ... Components>
-        void Each(typename identity<std::function<void(Entity entity, Components&...)>>::type f) {
-            return EntitiesWithComponents<Components...>().each(f);
+        /// Invoke f(count, ids, Components*...) for each chunk with the given components, suitable for SIMD loops.
+        template <typename ... Components, typename Func>
+        void EachChunk(Func&& f, uint32_t since = 0) {
+            EntitiesWithComponents<Components...>(since).each_chunk(std::forward<Func>(f));
         }
 
-        template <typename ... Components>
-        UnpackingView<Components...> EntitiesWithComponents(IntrusivePtr<Components> & ... components) {
-            auto mask = component_mask<Components...>();
-            return UnpackingView<Components...>(this, mask, components...);
+        /// Invoke f(Archetype&, chunk) for each chunk with the given components. Nothing is marked as changed,
+        /// f stamps the rows it modifies itself, see Archetype::MarkChanged.
+        template <typename ... Components, typename Func>
+        void EachArchetypeChunk(Func&& f, uint32_t since = 0) {
+            EntitiesWithComponents<Components...>(since).each_archetype_chunk(std::forward<Func>(f));
+        }
+
+        /// Invoke f(Entity, Components&...) for each entity with the given components, spreading the work over JobSystem workers.
+        /// Returns once every entity has been processed. Structural changes are not allowed from f, use PerThread for scratch data.
+        template <typename ... Components, typename Func>
+        void ParallelEach(Func&& f, uint32_t grainSize = 1024, uint32_t since = 0) {
+            EntitiesWithComponents<Components...>(since).parallel_each(std::forward<Func>(f), grainSize);
+        }
+
+        /// Invoke f(count, ids, Components*...) for slices of at most grainSize entities on JobSystem workers.
+        template <typename ... Components, typename Func>
+        void ParallelEachChunk(Func&& f, uint32_t grainSize = 1024, uint32_t since = 0) {
+            EntitiesWithComponents<Components...>(since).parallel_each_chunk(std::forward<Func>(f), grainSize);
         }
 
+        /// Invoke f(Entity::Id) for each entity that lost component T after since, destroyed entities included.
+        /// Removals are recorded once the first removed query has been made.
+        template <typename T, typename Func>
+        void EachRemoved(Func&& f, uint32_t since) {
+            _trackRemoved = true;
+            const uint32_t family = ComponentIDMapping::GetId<T>();
+            for (const RemovedComponent& removed : _removedComponents)
+            {
+                if (removed.family == family && removed.version > since)
+                {
+                    f(removed.id);
+                }
+            }
+        }
+
+        /// Forget removed components recorded at or before given version.
+        void TrimRemoved(uint32_t version);
+
+        /// Get the version stamped on component changes.
+        uint32_t GetChangeVersion() const { return _changeVersion; }
+
+        /// Advance the change version, changes made after this call are newer than any query version obtained before.
+        void IncrementChangeVersion() { ++_changeVersion; }
+
+        /// Mark component T of given entity as changed.
+        template <typename T>
+        void MarkChanged(Entity::Id id)
+        {
+            MarkChanged(id, ComponentIDMapping::GetId<T>());
+        }
+
+        void MarkChanged(Entity::Id id, uint32_t family);
+
     private:
         friend class Entity;
+        friend class EntityCommandBuffer;
+
+        /// Location of an entity inside its archetype.
+        struct EntityLocation
+        {
+            Archetype* archetype = nullptr;
+            uint32_t chunk = 0;
+            uint32_t row = 0;
+        };
 
         inline void AssertValid(Entity::Id id) const
         {
-            assert(id.index() < _entityComponentMask.size() && "entity::Id ID outside entity vector range");
+            assert(id.index() < _entityLocation.size() && "entity::Id ID outside entity vector range");
             assert(_entityVersion[id.index()] == id.version() &&
                 "Attempt to access entity via a stale entity::Id");
         }
 
-        ComponentMask component_mask(Entity::Id id)
+        ComponentMask GetComponentMask(uint32_t index) const
         {
-            AssertValid(id);
-            return _entityComponentMask.at(id.index());
+            const Archetype* archetype = _entityLocation[index].archetype;
+            return archetype ? archetype->GetMask() : ComponentMask();
         }
 
         ComponentMask component_mask(Entity::Id id) const
         {
             AssertValid(id);
-            return _entityComponentMask.at(id.index());
+            return GetComponentMask(id.index());
         }
 
         template <typename T>
@@ -577,51 +1091,61 @@ namespace Alimer
 
         inline void AccomodateEntity(std::uint32_t index)
         {
-            if (_entityComponentMask.size() <= index)
+            if (_entityLocation.size() <= index)
             {
-                _entityComponentMask.resize(index + 1);
+                _entityLocation.resize(index + 1);
                 _entityVersion.resize(index + 1);
-                for (auto& pool : _componentPools)
-                {
-                    if (pool)
-                    {
-                        pool->Expand(index + 1);
-                    }
-                }
+                _aliveMask.resize(index / 32 + 1);
             }
         }
 
-        template <typename C>
-        ComponentStorage& AccomodateComponent()
-        {
-            auto family = rtti::type_index_sequential_t::id<Component, C>();
-            return AccomodateComponent(family);
-        }
+        /// Return the index of the first alive entity at or after index, or the capacity if there is none.
+        uint32_t NextAlive(uint32_t index) const;
 
-        ComponentStorage& AccomodateComponent(uint32_t family)
-        {
-            if (_componentPools.size() <= family)
-            {
-                _componentPools.resize(family + 1);
-            }
+        /// Get or create the archetype for given mask.
+        Archetype* GetArchetype(const ComponentMask& mask);
 
-            auto& pool = _componentPools[family];
-            if (!pool)
-            {
-                pool = std::make_unique<ComponentStorage>();
-                pool->Expand(_indexCounter);
-            }
+        /// Move entity to given archetype, components not present in target are destroyed.
+        void MoveEntity(Entity::Id id, Archetype* target);
 
-            return *pool;
-        }
+        /// Release an archetype row and patch the location of the entity moved into it.
+        void DeallocateRow(Archetype* archetype, uint32_t chunk, uint32_t row);
+
+        /// Get the archetype reached by adding family to source.
+        Archetype* GetAddTarget(Archetype* source, uint32_t family);
+
+        /// Reserve storage for adding family to a batch of entities.
+        void ReserveComponent(ArrayView<const Entity::Id> ids, uint32_t family);
+
+        /// Ensure entity has storage for given family and return the uninitialized component memory.
+        void* AccomodateComponent(Entity::Id id, uint32_t family);
+
+        /// Assign component of given family by moving it from source, source is left in moved-from state.
+        void AssignFrom(Entity::Id id, uint32_t family, void* source);
+
+        /// Component removed from an entity, kept for Removed queries until trimmed.
+        struct RemovedComponent
+        {
+            Entity::Id id;
+            uint32_t family;
+            uint32_t version;
+        };
 
         std::uint32_t _indexCounter = 0;
-        // Each element in component_pools_ corresponds to a Pool for a component.
-        // The index into the vector is the component::family().
-        std::vector<std::unique_ptr<ComponentStorage>> _componentPools;
-        // Bitmask of components associated with each entity. Index into the vector is
-        // the entity::Id.
-        std::vector<ComponentMask> _entityComponentMask;
+        std::uint32_t _changeVersion = 1;
+        std::vector<RemovedComponent> _removedComponents;
+        bool _trackRemoved = false;
+        // One bit per entity index, set while the entity is alive.
+        std::vector<uint32_t> _aliveMask;
+        // Cached queries by mask, guarded as parallel systems may create queries concurrently.
+        std::unordered_map<ComponentMask, std::unique_ptr<EntityQuery>> _queries;
+        std::mutex _queryMutex;
+        // All archetypes, the first one is the empty archetype holding entities without components.
+        std::vector<std::unique_ptr<Archetype>> _archetypes;
+        // Archetype lookup by component mask.
+        std::unordered_map<ComponentMask, Archetype*> _archetypeMap;
+        // Location of each entity in its archetype. Index into the vector is the entity::Id.
+        std::vector<EntityLocation> _entityLocation;
         // Vector of entity version numbers. Incremented each time an entity is destroyed
         std::vector<uint32_t> _entityVersion;
         // List of available entity slots.
@@ -651,18 +1175,12 @@ namespace Alimer
     }
 
     template <typename T, typename... Args>
-    IntrusivePtr<T> Entity::Assign(Args&&... args)
+    T* Entity::Assign(Args&&... args)
     {
         ALIMER_ASSERT(IsValid());
         return _manager->Assign<T>(_id, std::forward<Args>(args)...);
     }
 
-    inline IntrusivePtr<BaseComponent> Entity::Assign(const IntrusivePtr<BaseComponent>& component)
-    {
-        assert(IsValid());
-        return _manager->Assign(_id, component);
-    }
-
     template <typename T>
     void Entity::Remove()
     {
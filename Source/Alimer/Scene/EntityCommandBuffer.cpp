@@ -0,0 +1,192 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Scene/EntityCommandBuffer.h"
+#include "../Math/MathUtil.h"
+#include <algorithm>
+
+namespace Alimer
+{
+    EntityCommandBuffer::EntityCommandBuffer(EntityManager& entities)
+        : _entities(entities)
+    {
+    }
+
+    EntityCommandBuffer::~EntityCommandBuffer()
+    {
+        Clear();
+    }
+
+    EntityCommandBuffer::PendingEntity EntityCommandBuffer::Create()
+    {
+        const uint32_t thread = JobSystem::GetCurrentThreadIndex();
+        ALIMER_ASSERT_MSG(thread < _buffers.Size(), "Thread %u can not record into the command buffer", thread);
+        return { thread, _buffers[thread].createCount++ };
+    }
+
+    void EntityCommandBuffer::Destroy(Entity::Id id)
+    {
+        Record(CommandType::Destroy, 0, id, { INVALID_THREAD, 0 }, nullptr);
+    }
+
+    void EntityCommandBuffer::Record(CommandType type, uint32_t family, Entity::Id id, PendingEntity pending, void* component)
+    {
+        Command command;
+        command.type = type;
+        command.family = family;
+        command.id = id;
+        command.pending = pending;
+        command.component = component;
+        _buffers.Local().commands.push_back(command);
+    }
+
+    void* EntityCommandBuffer::Allocate(ThreadBuffer& buffer, uint32_t size, uint32_t alignment)
+    {
+        ALIMER_ASSERT_MSG(size <= BLOCK_SIZE, "Component of %u bytes is too large for EntityCommandBuffer", size);
+
+        uint32_t offset = AlignTo(buffer.blockOffset, alignment);
+        if (buffer.blocks.empty() || offset + size > BLOCK_SIZE)
+        {
+            if (!buffer.blocks.empty())
+            {
+                buffer.currentBlock++;
+            }
+
+            if (buffer.currentBlock == buffer.blocks.size())
+            {
+                buffer.blocks.emplace_back(new uint8_t[BLOCK_SIZE]);
+            }
+
+            offset = 0;
+        }
+
+        buffer.blockOffset = offset + size;
+        return buffer.blocks[buffer.currentBlock].get() + offset;
+    }
+
+    Entity::Id EntityCommandBuffer::Resolve(const Command& command) const
+    {
+        if (command.pending.thread == INVALID_THREAD)
+            return command.id;
+
+        return _buffers[command.pending.thread].created[command.pending.index];
+    }
+
+    void EntityCommandBuffer::Playback()
+    {
+        // Create all pending entities first so commands from any thread can reference them.
+        size_t createCount = 0;
+        for (uint32_t thread = 0; thread < _buffers.Size(); ++thread)
+        {
+            createCount += _buffers[thread].createCount;
+        }
+
+        if (createCount > 0)
+        {
+            // Free slots are reused first, grow geometrically so frequent small playbacks stay amortized.
+            const size_t required = _entities.GetSize() + createCount;
+            if (required > _entities.GetCapacity())
+            {
+                _entities.Reserve(std::max(required, _entities.GetCapacity() * 2));
+            }
+
+            for (uint32_t thread = 0; thread < _buffers.Size(); ++thread)
+            {
+                ThreadBuffer& buffer = _buffers[thread];
+                buffer.created.resize(buffer.createCount);
+                for (uint32_t i = 0; i < buffer.createCount; ++i)
+                {
+                    buffer.created[i] = _entities.Create().GetId();
+                }
+            }
+        }
+
+        for (uint32_t thread = 0; thread < _buffers.Size(); ++thread)
+        {
+            for (const Command& command : _buffers[thread].commands)
+            {
+                const Entity::Id id = Resolve(command);
+                const bool valid = _entities.IsValid(id);
+                switch (command.type)
+                {
+                case CommandType::Destroy:
+                    if (valid)
+                        _entities.Destroy(id);
+                    break;
+
+                case CommandType::Assign:
+                    if (valid)
+                        _entities.AssignFrom(id, command.family, command.component);
+                    ComponentIDMapping::GetTypeInfo(command.family).destroy(command.component);
+                    break;
+
+                case CommandType::Remove:
+                    if (valid)
+                        _entities.Remove(id, command.family);
+                    break;
+                }
+            }
+        }
+
+        for (uint32_t thread = 0; thread < _buffers.Size(); ++thread)
+        {
+            Reset(_buffers[thread]);
+        }
+    }
+
+    void EntityCommandBuffer::Clear()
+    {
+        for (uint32_t thread = 0; thread < _buffers.Size(); ++thread)
+        {
+            ThreadBuffer& buffer = _buffers[thread];
+            for (const Command& command : buffer.commands)
+            {
+                if (command.type == CommandType::Assign)
+                {
+                    ComponentIDMapping::GetTypeInfo(command.family).destroy(command.component);
+                }
+            }
+
+            Reset(buffer);
+        }
+    }
+
+    bool EntityCommandBuffer::IsEmpty() const
+    {
+        for (uint32_t thread = 0; thread < _buffers.Size(); ++thread)
+        {
+            if (!_buffers[thread].commands.empty() || _buffers[thread].createCount > 0)
+                return false;
+        }
+
+        return true;
+    }
+
+    void EntityCommandBuffer::Reset(ThreadBuffer& buffer)
+    {
+        buffer.commands.clear();
+        buffer.created.clear();
+        buffer.createCount = 0;
+        buffer.currentBlock = 0;
+        buffer.blockOffset = 0;
+    }
+}
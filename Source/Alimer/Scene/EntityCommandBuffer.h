@@ -0,0 +1,139 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Scene/Entity.h"
+#include "../Core/JobSystem.h"
+#include <memory>
+#include <vector>
+
+namespace Alimer
+{
+    /// Records structural changes of an EntityManager and applies them in one batch at a sync point.
+    /// Commands can be recorded from the main thread and JobSystem workers without locking, each thread owns its buffer.
+    class ALIMER_API EntityCommandBuffer final
+    {
+    public:
+        /// Entity whose creation has been recorded, resolved to a real entity during Playback.
+        struct PendingEntity
+        {
+            uint32_t thread;
+            uint32_t index;
+        };
+
+        /// Constructor.
+        explicit EntityCommandBuffer(EntityManager& entities);
+
+        /// Destructor, discards commands that were not played back.
+        ~EntityCommandBuffer();
+
+        /// Record creation of a new entity.
+        PendingEntity Create();
+
+        /// Record destruction of an entity.
+        void Destroy(Entity::Id id);
+
+        /// Record component assignment, the component is constructed now and moved into the entity on playback.
+        template <typename T, typename... Args>
+        void Assign(Entity::Id id, Args&&... args)
+        {
+            AssignImpl<T>(id, { INVALID_THREAD, 0 }, std::forward<Args>(args)...);
+        }
+
+        /// Record component assignment to an entity created by this buffer.
+        template <typename T, typename... Args>
+        void Assign(PendingEntity entity, Args&&... args)
+        {
+            AssignImpl<T>(Entity::INVALID, entity, std::forward<Args>(args)...);
+        }
+
+        /// Record removal of a component.
+        template <typename T>
+        void Remove(Entity::Id id)
+        {
+            Record(CommandType::Remove, ComponentIDMapping::GetId<T>(), id, { INVALID_THREAD, 0 }, nullptr);
+        }
+
+        /// Apply all recorded commands and reset the buffer, must be called while no thread is recording or iterating entities.
+        /// Pending entities are created first, then commands are applied in recording order per thread.
+        void Playback();
+
+        /// Discard all recorded commands.
+        void Clear();
+
+        /// Return true if no command has been recorded.
+        bool IsEmpty() const;
+
+    private:
+        static constexpr uint32_t INVALID_THREAD = ~0u;
+        static constexpr uint32_t BLOCK_SIZE = 16 * 1024;
+
+        enum class CommandType : uint8_t
+        {
+            Destroy,
+            Assign,
+            Remove
+        };
+
+        struct Command
+        {
+            CommandType type;
+            uint32_t family;
+            Entity::Id id;
+            PendingEntity pending;
+            void* component;
+        };
+
+        struct ThreadBuffer
+        {
+            std::vector<Command> commands;
+            std::vector<Entity::Id> created;
+            uint32_t createCount = 0;
+            // Component storage, blocks are kept between playbacks so recording does not allocate in steady state.
+            std::vector<std::unique_ptr<uint8_t[]>> blocks;
+            uint32_t currentBlock = 0;
+            uint32_t blockOffset = 0;
+        };
+
+        template <typename T, typename... Args>
+        void AssignImpl(Entity::Id id, PendingEntity pending, Args&&... args)
+        {
+            static_assert(std::is_base_of<BaseComponent, T>(), "T is not a component, cannot add T to entity");
+
+            const uint32_t family = ComponentIDMapping::GetId<T>();
+            void* memory = Allocate(_buffers.Local(), sizeof(T), alignof(T));
+            new (memory) T(std::forward<Args>(args)...);
+            Record(CommandType::Assign, family, id, pending, memory);
+        }
+
+        void Record(CommandType type, uint32_t family, Entity::Id id, PendingEntity pending, void* component);
+        void* Allocate(ThreadBuffer& buffer, uint32_t size, uint32_t alignment);
+        void Reset(ThreadBuffer& buffer);
+        Entity::Id Resolve(const Command& command) const;
+
+        EntityManager& _entities;
+        PerThread<ThreadBuffer> _buffers;
+
+        DISALLOW_COPY_MOVE_AND_ASSIGN(EntityCommandBuffer);
+    };
+}
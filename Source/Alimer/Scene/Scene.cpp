@@ -27,11 +27,13 @@
 
 namespace Alimer
 {
-    Scene::Scene(EntityManager& entities)
+    Scene::Scene(EntityManager& entities, TransformHierarchy& hierarchy, BoundingVolumeHierarchy& spatialIndex)
         : _entities(entities)
+        , _hierarchy(hierarchy)
+        , _spatialIndex(spatialIndex)
     {
         _defaultCamera = CreateEntity("Default Camera");
-        _defaultCamera.Assign<TransformComponent>();
+        _defaultCamera.Assign<TransformComponent>(_hierarchy);
         _defaultCamera.Assign<CameraComponent>();
         ALIMER_ASSERT(_defaultCamera.HasComponent<TransformComponent>());
         ALIMER_ASSERT(_defaultCamera.HasComponent<CameraComponent>());
@@ -24,6 +24,8 @@
 
 #include "../Serialization/Serializable.h"
 #include "../Scene/Entity.h"
+#include "../Scene/TransformHierarchy.h"
+#include "../Scene/BoundingVolumeHierarchy.h"
 
 namespace Alimer
 {
@@ -67,7 +69,7 @@ namespace Alimer
 
     public:
         /// Constructor.
-        explicit Scene(EntityManager& entities);
+        Scene(EntityManager& entities, TransformHierarchy& hierarchy, BoundingVolumeHierarchy& spatialIndex);
 
         /// Destructor.
         ~Scene();
@@ -81,8 +83,16 @@ namespace Alimer
         /// Return the Entity containing the active camera.
         Entity GetActiveCamera() const { return _activeCamera; }
 
+        /// Return the transform hierarchy used by the scene entities.
+        TransformHierarchy& GetHierarchy() const { return _hierarchy; }
+
+        /// Return the bounding volume hierarchy used for frustum, ray and box queries.
+        BoundingVolumeHierarchy& GetSpatialIndex() const { return _spatialIndex; }
+
     private:
         EntityManager& _entities;
+        TransformHierarchy& _hierarchy;
+        BoundingVolumeHierarchy& _spatialIndex;
         //ComponentManager<NameComponent> _names;
         Entity _defaultCamera;
         Entity _activeCamera;
@@ -0,0 +1,67 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Systems/BoundsSystem.h"
+#include "../Components/TransformComponent.h"
+#include "../Components/BoundsComponent.h"
+#include <algorithm>
+
+namespace Alimer
+{
+    BoundsSystem::BoundsSystem()
+    {
+        // World matrices are updated by TransformSystem.
+        Reads<TransformComponent>();
+        Writes<BoundsComponent>();
+    }
+
+    void BoundsSystem::Update(EntityManager &entities, double deltaTime)
+    {
+        ALIMER_UNUSED(deltaTime);
+
+        // World boxes are computed in parallel, only proxies leaving their fat box touch the tree.
+        entities.ParallelEach<const TransformComponent, BoundsComponent>(
+            [this](Entity e, const TransformComponent& transform, BoundsComponent& bounds) {
+            if (bounds.UpdateWorldBox(transform.GetWorldMatrix()))
+            {
+                _threadMoves.Local().push_back({ e.GetId(), &bounds });
+            }
+        });
+
+        _moves.clear();
+        for (uint32_t i = 0; i < _threadMoves.Size(); ++i)
+        {
+            _moves.insert(_moves.end(), _threadMoves[i].begin(), _threadMoves[i].end());
+            _threadMoves[i].clear();
+        }
+
+        // Apply in entity order so the tree does not depend on thread scheduling.
+        std::sort(_moves.begin(), _moves.end(), [](const Move& lhs, const Move& rhs) {
+            return lhs.id < rhs.id;
+        });
+
+        for (const Move& move : _moves)
+        {
+            move.bounds->UpdateProxy(move.id);
+        }
+    }
+}
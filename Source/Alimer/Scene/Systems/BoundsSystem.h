@@ -0,0 +1,52 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../../Application/GameSystem.h"
+#include "../../Core/JobSystem.h"
+
+namespace Alimer
+{
+    class BoundsComponent;
+
+	/// System that computes world boxes of bounds components attached to entities that also have a transform,
+    /// and moves their proxies in the bounding volume hierarchy.
+    class ALIMER_API BoundsSystem final : public GameSystem
+	{
+    public:
+        BoundsSystem();
+
+        void Update(EntityManager &entities, double deltaTime) override;
+
+    private:
+        struct Move
+        {
+            Entity::Id id;
+            BoundsComponent* bounds;
+        };
+
+        /// Proxies that left their fat box, gathered per thread by the parallel pass.
+        PerThread<std::vector<Move>> _threadMoves;
+        std::vector<Move> _moves;
+	};
+}
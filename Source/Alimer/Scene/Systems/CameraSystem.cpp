@@ -26,14 +26,21 @@
 
 namespace Alimer
 {
+    CameraSystem::CameraSystem()
+    {
+        // World matrices are updated by TransformSystem.
+        Reads<TransformComponent>();
+        Writes<CameraComponent>();
+    }
+
     void CameraSystem::Update(EntityManager &entities, double deltaTime)
     {
         ALIMER_UNUSED(deltaTime);
 
-        entities.Each<TransformComponent, CameraComponent>(
-            [](Entity e, TransformComponent& transform, CameraComponent& camera) {
+        entities.ParallelEach<const TransformComponent, CameraComponent>(
+            [](Entity e, const TransformComponent& transform, CameraComponent& camera) {
             ALIMER_UNUSED(e);
-            camera.Update(transform.GetTransform());
+            camera.Update(transform.GetWorldMatrix());
         });
     }
 }
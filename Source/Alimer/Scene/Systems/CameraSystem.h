@@ -31,7 +31,7 @@ namespace Alimer
     class ALIMER_API CameraSystem final : public GameSystem
 	{
     public:
-        CameraSystem() = default;
+        CameraSystem();
 
         void Update(EntityManager &entities, double deltaTime) override;
 	};
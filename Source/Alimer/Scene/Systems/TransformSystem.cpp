@@ -0,0 +1,63 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Systems/TransformSystem.h"
+#include "../Components/TransformComponent.h"
+
+namespace Alimer
+{
+    TransformSystem::TransformSystem(TransformHierarchy& hierarchy)
+        : _hierarchy(hierarchy)
+    {
+        Writes<TransformComponent>();
+    }
+
+    void TransformSystem::Update(EntityManager &entities, double deltaTime)
+    {
+        ALIMER_UNUSED(deltaTime);
+
+        _hierarchy.Update();
+
+        // Matrices live in the hierarchy, stamp the rows of recomputed nodes so Changed<TransformComponent> matches them.
+        const uint32_t family = ComponentIDMapping::GetId<TransformComponent>();
+        const uint32_t version = entities.GetChangeVersion();
+        entities.EachArchetypeChunk<const TransformComponent>([this, family, version](Archetype& archetype, uint32_t chunk) {
+            const uint32_t count = archetype.GetChunkSize(chunk);
+            const TransformComponent* transforms = archetype.GetComponents<TransformComponent>(chunk);
+            uint32_t* versions = archetype.GetChangedVersions(family, chunk);
+            bool changed = false;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (_hierarchy.IsWorldMatrixChanged(transforms[i].GetNode()))
+                {
+                    versions[i] = version;
+                    changed = true;
+                }
+            }
+
+            if (changed)
+            {
+                archetype.MarkChunkChanged(family, chunk, version);
+            }
+        });
+    }
+}
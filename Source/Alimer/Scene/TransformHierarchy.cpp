@@ -0,0 +1,365 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Scene/TransformHierarchy.h"
+#include "../Core/JobSystem.h"
+#include "../Core/Log.h"
+
+namespace Alimer
+{
+    /// Levels smaller than this are updated on the calling thread.
+    static constexpr uint32_t ParallelLevelSize = 4096;
+    static constexpr uint32_t ParallelGrainSize = 1024;
+
+    constexpr uint32_t TransformHierarchy::InvalidNode;
+
+    TransformHierarchy::TransformHierarchy() = default;
+    TransformHierarchy::~TransformHierarchy() = default;
+
+    uint32_t TransformHierarchy::Add()
+    {
+        uint32_t node;
+        if (!_freeNodes.empty())
+        {
+            node = _freeNodes.back();
+            _freeNodes.pop_back();
+        }
+        else
+        {
+            node = static_cast<uint32_t>(_nodeToIndex.size());
+            _nodeToIndex.push_back(InvalidNode);
+            _firstChild.push_back(InvalidNode);
+            _nextSibling.push_back(InvalidNode);
+            _previousSibling.push_back(InvalidNode);
+            _worldChanged.push_back(0);
+        }
+
+        _worldChanged[node] = 0;
+
+        _nodeToIndex[node] = static_cast<uint32_t>(_indexToNode.size());
+        _indexToNode.push_back(node);
+        _parentNodes.push_back(InvalidNode);
+        _localMatrices.push_back(mat4::identity());
+        _worldMatrices.push_back(mat4::identity());
+        _dirty.push_back(1);
+        _structureDirty = true;
+        return node;
+    }
+
+    void TransformHierarchy::Remove(uint32_t node)
+    {
+        ALIMER_ASSERT(node < _nodeToIndex.size() && _nodeToIndex[node] != InvalidNode);
+
+        UnlinkChild(node);
+        for (uint32_t child = _firstChild[node]; child != InvalidNode;)
+        {
+            const uint32_t next = _nextSibling[child];
+            const uint32_t childIndex = _nodeToIndex[child];
+            _parentNodes[childIndex] = InvalidNode;
+            _dirty[childIndex] = 1;
+            _nextSibling[child] = InvalidNode;
+            _previousSibling[child] = InvalidNode;
+            child = next;
+        }
+
+        _firstChild[node] = InvalidNode;
+        const uint32_t index = _nodeToIndex[node];
+
+        // Swap last node into the hole, order is restored by the next Sort.
+        const uint32_t last = GetSize() - 1;
+        if (index != last)
+        {
+            const uint32_t lastNode = _indexToNode[last];
+            _indexToNode[index] = lastNode;
+            _parentNodes[index] = _parentNodes[last];
+            _localMatrices[index] = _localMatrices[last];
+            _worldMatrices[index] = _worldMatrices[last];
+            _dirty[index] = _dirty[last];
+            _nodeToIndex[lastNode] = index;
+        }
+
+        _indexToNode.pop_back();
+        _parentNodes.pop_back();
+        _localMatrices.pop_back();
+        _worldMatrices.pop_back();
+        _dirty.pop_back();
+
+        _nodeToIndex[node] = InvalidNode;
+        _freeNodes.push_back(node);
+        _structureDirty = true;
+    }
+
+    bool TransformHierarchy::SetParent(uint32_t node, uint32_t parent)
+    {
+        const uint32_t index = _nodeToIndex[node];
+        for (uint32_t ancestor = parent; ancestor != InvalidNode; ancestor = _parentNodes[_nodeToIndex[ancestor]])
+        {
+            if (ancestor == node)
+            {
+                ALIMER_LOGERROR("TransformHierarchy: parent would create a cycle");
+                return false;
+            }
+        }
+
+        if (_parentNodes[index] != parent)
+        {
+            UnlinkChild(node);
+            _parentNodes[index] = parent;
+            if (parent != InvalidNode)
+            {
+                LinkChild(node, parent);
+            }
+
+            _dirty[index] = 1;
+            _structureDirty = true;
+        }
+
+        return true;
+    }
+
+    void TransformHierarchy::LinkChild(uint32_t node, uint32_t parent)
+    {
+        const uint32_t next = _firstChild[parent];
+        _nextSibling[node] = next;
+        _previousSibling[node] = InvalidNode;
+        if (next != InvalidNode)
+        {
+            _previousSibling[next] = node;
+        }
+
+        _firstChild[parent] = node;
+    }
+
+    void TransformHierarchy::UnlinkChild(uint32_t node)
+    {
+        const uint32_t parent = _parentNodes[_nodeToIndex[node]];
+        if (parent == InvalidNode)
+            return;
+
+        const uint32_t next = _nextSibling[node];
+        const uint32_t previous = _previousSibling[node];
+        if (previous != InvalidNode)
+        {
+            _nextSibling[previous] = next;
+        }
+        else
+        {
+            _firstChild[parent] = next;
+        }
+
+        if (next != InvalidNode)
+        {
+            _previousSibling[next] = previous;
+        }
+
+        _nextSibling[node] = InvalidNode;
+        _previousSibling[node] = InvalidNode;
+    }
+
+    uint32_t TransformHierarchy::GetParent(uint32_t node) const
+    {
+        return _parentNodes[_nodeToIndex[node]];
+    }
+
+    void TransformHierarchy::SetLocalMatrix(uint32_t node, const mat4& local)
+    {
+        const uint32_t index = _nodeToIndex[node];
+        _localMatrices[index] = local;
+        _dirty[index] = 1;
+    }
+
+    const mat4& TransformHierarchy::GetLocalMatrix(uint32_t node) const
+    {
+        return _localMatrices[_nodeToIndex[node]];
+    }
+
+    const mat4& TransformHierarchy::GetWorldMatrix(uint32_t node) const
+    {
+        return _worldMatrices[_nodeToIndex[node]];
+    }
+
+    void TransformHierarchy::Sort()
+    {
+        const uint32_t count = GetSize();
+
+        // Depth of every node, walking up until a node with known depth.
+        std::vector<uint32_t> depths(count, InvalidNode);
+        std::vector<uint32_t> stack;
+        uint32_t maxDepth = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint32_t index = i;
+            while (depths[index] == InvalidNode)
+            {
+                const uint32_t parent = _parentNodes[index];
+                if (parent == InvalidNode)
+                {
+                    depths[index] = 0;
+                    break;
+                }
+
+                stack.push_back(index);
+                index = _nodeToIndex[parent];
+            }
+
+            uint32_t depth = depths[index];
+            while (!stack.empty())
+            {
+                depths[stack.back()] = ++depth;
+                stack.pop_back();
+            }
+
+            maxDepth = std::max(maxDepth, depths[i]);
+        }
+
+        // Stable counting sort by depth.
+        _levels.assign(count ? maxDepth + 2 : 1, 0);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            _levels[depths[i] + 1]++;
+        }
+
+        for (size_t level = 1; level < _levels.size(); ++level)
+        {
+            _levels[level] += _levels[level - 1];
+        }
+
+        std::vector<uint32_t> order(count);
+        std::vector<uint32_t> cursor(_levels.begin(), _levels.end() - 1);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            order[cursor[depths[i]]++] = i;
+        }
+
+        std::vector<uint32_t> indexToNode(count);
+        std::vector<uint32_t> parentNodes(count);
+        std::vector<mat4> localMatrices;
+        std::vector<mat4> worldMatrices;
+        localMatrices.reserve(count);
+        worldMatrices.reserve(count);
+        std::vector<uint8_t> dirty(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t source = order[i];
+            indexToNode[i] = _indexToNode[source];
+            parentNodes[i] = _parentNodes[source];
+            localMatrices.push_back(_localMatrices[source]);
+            worldMatrices.push_back(_worldMatrices[source]);
+            dirty[i] = _dirty[source];
+            _nodeToIndex[indexToNode[i]] = i;
+        }
+
+        _indexToNode.swap(indexToNode);
+        _parentNodes.swap(parentNodes);
+        _localMatrices.swap(localMatrices);
+        _worldMatrices.swap(worldMatrices);
+        _dirty.swap(dirty);
+
+        _parents.resize(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            _parents[i] = _parentNodes[i] != InvalidNode ? _nodeToIndex[_parentNodes[i]] : InvalidNode;
+        }
+
+        _structureDirty = false;
+    }
+
+    void TransformHierarchy::UpdateRange(uint32_t begin, uint32_t end)
+    {
+        const uint32_t* parents = _parents.data();
+        const mat4* local = _localMatrices.data();
+        mat4* world = _worldMatrices.data();
+        uint8_t* dirty = _dirty.data();
+        std::vector<uint32_t>& changed = _threadChanged->Local();
+
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const uint32_t parent = parents[i];
+            if (parent == InvalidNode)
+            {
+                if (dirty[i])
+                {
+                    world[i] = local[i];
+                    changed.push_back(i);
+                }
+            }
+            else
+            {
+                // Parents live in the previous level and are already final.
+                dirty[i] |= dirty[parent];
+                if (dirty[i])
+                {
+                    world[i] = world[parent] * local[i];
+                    changed.push_back(i);
+                }
+            }
+        }
+    }
+
+    void TransformHierarchy::Update()
+    {
+        if (!_threadChanged)
+        {
+            _threadChanged.reset(new PerThread<std::vector<uint32_t>>());
+        }
+
+        for (uint32_t node : _changedNodes)
+        {
+            _worldChanged[node] = 0;
+        }
+        _changedNodes.clear();
+
+        if (_structureDirty)
+        {
+            Sort();
+        }
+
+        for (size_t level = 0; level + 1 < _levels.size(); ++level)
+        {
+            const uint32_t begin = _levels[level];
+            const uint32_t end = _levels[level + 1];
+            if (end - begin < ParallelLevelSize)
+            {
+                UpdateRange(begin, end);
+                continue;
+            }
+
+            JobSystem::GetInstance()->ParallelFor(end - begin, ParallelGrainSize, [this, begin](uint32_t rangeBegin, uint32_t rangeEnd) {
+                UpdateRange(begin + rangeBegin, begin + rangeEnd);
+            });
+        }
+
+        // Flag the recomputed nodes for change tracking and start the next frame clean, cost is proportional to the changes.
+        for (uint32_t thread = 0; thread < _threadChanged->Size(); ++thread)
+        {
+            std::vector<uint32_t>& changed = (*_threadChanged)[thread];
+            for (uint32_t index : changed)
+            {
+                const uint32_t node = _indexToNode[index];
+                _worldChanged[node] = 1;
+                _changedNodes.push_back(node);
+                _dirty[index] = 0;
+            }
+            changed.clear();
+        }
+    }
+}
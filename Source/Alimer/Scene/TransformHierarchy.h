@@ -0,0 +1,119 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Math/Math.h"
+#include "../Core/JobSystem.h"
+#include <memory>
+#include <vector>
+
+namespace Alimer
+{
+    /// Flat transform hierarchy with nodes stored by depth in structure of arrays layout.
+    class ALIMER_API TransformHierarchy final
+    {
+    public:
+        static constexpr uint32_t InvalidNode = ~0u;
+
+        /// Constructor.
+        TransformHierarchy();
+
+        /// Destructor.
+        ~TransformHierarchy();
+
+        /// Add new root node with identity local transform.
+        uint32_t Add();
+
+        /// Remove node, its children become root nodes.
+        void Remove(uint32_t node);
+
+        /// Set parent node, InvalidNode makes it a root. Returns false if it would create a cycle.
+        bool SetParent(uint32_t node, uint32_t parent);
+
+        /// Get parent node or InvalidNode.
+        uint32_t GetParent(uint32_t node) const;
+
+        /// Get first child node or InvalidNode, the other children follow through GetNextSibling.
+        uint32_t GetFirstChild(uint32_t node) const { return _firstChild[node]; }
+
+        /// Get next child node of the same parent or InvalidNode.
+        uint32_t GetNextSibling(uint32_t node) const { return _nextSibling[node]; }
+
+        /// Set local matrix relative to the parent.
+        void SetLocalMatrix(uint32_t node, const mat4& local);
+
+        /// Get local matrix relative to the parent.
+        const mat4& GetLocalMatrix(uint32_t node) const;
+
+        /// Get world matrix computed by the last Update.
+        const mat4& GetWorldMatrix(uint32_t node) const;
+
+        /// Return whether the local matrix or the parent of node changed since the last Update.
+        bool IsDirty(uint32_t node) const { return _dirty[_nodeToIndex[node]] != 0; }
+
+        /// Return whether the last Update recomputed the world matrix of node.
+        bool IsWorldMatrixChanged(uint32_t node) const { return _worldChanged[node] != 0; }
+
+        /// Get number of nodes.
+        uint32_t GetSize() const { return static_cast<uint32_t>(_indexToNode.size()); }
+
+        /// Update world matrices of dirty nodes, one linear pass per depth level.
+        void Update();
+
+    private:
+        void Sort();
+        void UpdateRange(uint32_t begin, uint32_t end);
+        void LinkChild(uint32_t node, uint32_t parent);
+        void UnlinkChild(uint32_t node);
+
+        /// Node handle to dense index.
+        std::vector<uint32_t> _nodeToIndex;
+        std::vector<uint32_t> _freeNodes;
+
+        /// Children of each node as a doubly linked list, by node handle.
+        std::vector<uint32_t> _firstChild;
+        std::vector<uint32_t> _nextSibling;
+        std::vector<uint32_t> _previousSibling;
+        /// Nodes whose world matrix was recomputed by the last Update, by node handle.
+        std::vector<uint8_t> _worldChanged;
+        /// Nodes flagged in _worldChanged, cleared at the start of the next Update.
+        std::vector<uint32_t> _changedNodes;
+        /// Dense indices recomputed by each thread during Update, created on first Update.
+        std::unique_ptr<PerThread<std::vector<uint32_t>>> _threadChanged;
+
+        /// Dense arrays, sorted by depth after Sort.
+        std::vector<uint32_t> _indexToNode;
+        std::vector<uint32_t> _parentNodes;
+        std::vector<uint32_t> _parents;
+        std::vector<mat4> _localMatrices;
+        std::vector<mat4> _worldMatrices;
+        std::vector<uint8_t> _dirty;
+
+        /// First dense index of each depth level, plus end.
+        std::vector<uint32_t> _levels;
+        bool _structureDirty = false;
+
+    private:
+        DISALLOW_COPY_MOVE_AND_ASSIGN(TransformHierarchy);
+    };
+}
@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Benchmark.h"
+#include "Base/Vector.h"
+#include "Core/FrameAllocator.h"
+#include "Core/JobSystem.h"
+#include <cstdlib>
+
+using namespace Alimer;
+
+namespace
+{
+    const uint32_t AllocationCount = 1024;
+    const size_t AllocationSize = 64;
+}
+
+ALIMER_BENCHMARK(Allocate_Malloc)
+{
+    void* pointers[AllocationCount];
+    while (state.KeepRunning())
+    {
+        for (uint32_t i = 0; i < AllocationCount; ++i)
+        {
+            pointers[i] = malloc(AllocationSize);
+        }
+        for (uint32_t i = 0; i < AllocationCount; ++i)
+        {
+            free(pointers[i]);
+        }
+        Benchmark::DoNotOptimize(pointers[0]);
+    }
+    state.SetItemsPerIteration(AllocationCount);
+}
+
+ALIMER_BENCHMARK(Allocate_Frame)
+{
+    FrameAllocator frameAllocator;
+    while (state.KeepRunning())
+    {
+        void* last = nullptr;
+        for (uint32_t i = 0; i < AllocationCount; ++i)
+        {
+            last = frameAllocator.Allocate(AllocationSize, 16);
+        }
+        frameAllocator.BeginFrame();
+        Benchmark::DoNotOptimize(last);
+    }
+    state.SetItemsPerIteration(AllocationCount);
+}
+
+ALIMER_BENCHMARK(Allocate_Scratch)
+{
+    while (state.KeepRunning())
+    {
+        ScratchScope scratch;
+        void* last = nullptr;
+        for (uint32_t i = 0; i < AllocationCount; ++i)
+        {
+            last = scratch.Allocate(AllocationSize, 16);
+        }
+        Benchmark::DoNotOptimize(last);
+    }
+    state.SetItemsPerIteration(AllocationCount);
+}
+
+/// Temporary list filled from every thread, one vector per batch.
+ALIMER_BENCHMARK(Allocate_Parallel_Heap)
+{
+    while (state.KeepRunning())
+    {
+        JobSystem::GetInstance()->ParallelFor(AllocationCount, 16, [](uint32_t begin, uint32_t end)
+        {
+            PODVector<uint32_t> list;
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                list.Push(i);
+            }
+            Benchmark::DoNotOptimize(list.Size());
+        });
+    }
+    state.SetItemsPerIteration(AllocationCount);
+}
+
+ALIMER_BENCHMARK(Allocate_Parallel_Frame)
+{
+    FrameAllocator frameAllocator;
+    while (state.KeepRunning())
+    {
+        JobSystem::GetInstance()->ParallelFor(AllocationCount, 16, [&frameAllocator](uint32_t begin, uint32_t end)
+        {
+            PODVector<uint32_t> list(&frameAllocator);
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                list.Push(i);
+            }
+            Benchmark::DoNotOptimize(list.Size());
+        });
+        frameAllocator.BeginFrame();
+    }
+    state.SetItemsPerIteration(AllocationCount);
+}
@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "AlimerConfig.h"
+#include <cstdint>
+
+namespace Alimer
+{
+    namespace Benchmark
+    {
+        /// Benchmark iteration state.
+        class State
+        {
+        public:
+            explicit State(uint64_t iterations) : _iterations(iterations) {}
+
+            /// Returns true while there are iterations left to run.
+            bool KeepRunning() { return _index++ < _iterations; }
+
+            /// Get the number of iterations of this run.
+            uint64_t GetIterations() const { return _iterations; }
+
+            /// Set number of operations processed by single iteration, used to report ns/op.
+            void SetItemsPerIteration(uint64_t items) { _itemsPerIteration = items; }
+            uint64_t GetItemsPerIteration() const { return _itemsPerIteration; }
+
+        private:
+            uint64_t _iterations;
+            uint64_t _index = 0;
+            uint64_t _itemsPerIteration = 1;
+        };
+
+        using Function = void(*)(State& state);
+
+        /// Registers benchmark function during static initialization.
+        struct Registration
+        {
+            Registration(const char* name, Function function);
+        };
+
+        /// Prevent compiler from optimizing away given value.
+        template <typename T>
+        inline void DoNotOptimize(const T& value)
+        {
+#if ALIMER_COMPILER_MSVC
+            static volatile const void* sink;
+            sink = &value;
+#else
+            asm volatile("" : : "r,m"(value) : "memory");
+#endif
+        }
+    }
+}
+
+#define ALIMER_BENCHMARK(name) \
+    static void Benchmark_##name(Alimer::Benchmark::State& state); \
+    static Alimer::Benchmark::Registration s_benchmark_##name(#name, Benchmark_##name); \
+    static void Benchmark_##name(Alimer::Benchmark::State& state)
@@ -0,0 +1,116 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Benchmark.h"
+#include "Base/Cache.h"
+#include <vector>
+
+using namespace Alimer;
+
+namespace
+{
+    const uint32_t EntryCount = 4096;
+
+    struct CachedObject
+    {
+        explicit CachedObject(uint64_t value_) : value(value_) {}
+        uint64_t value;
+    };
+
+    std::vector<uint64_t> CreateKeys()
+    {
+        std::vector<uint64_t> keys;
+        for (uint32_t i = 0; i < EntryCount; ++i)
+        {
+            Hasher hasher;
+            hasher.UInt32(i);
+            keys.push_back(hasher.GetValue());
+        }
+        return keys;
+    }
+}
+
+/// Previous cache, unsynchronized map lookup.
+ALIMER_BENCHMARK(Cache_Find_HashMap)
+{
+    const std::vector<uint64_t> keys = CreateKeys();
+    HashMap<UniquePtr<CachedObject>> map;
+    for (uint64_t key : keys)
+    {
+        map[key] = new CachedObject(key);
+    }
+
+    while (state.KeepRunning())
+    {
+        uint64_t sum = 0;
+        for (uint64_t key : keys)
+        {
+            auto it = map.find(key);
+            sum += it != map.end() ? it->second->value : 0;
+        }
+        Benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsPerIteration(EntryCount);
+}
+
+ALIMER_BENCHMARK(Cache_Find)
+{
+    const std::vector<uint64_t> keys = CreateKeys();
+    Cache<CachedObject> cache;
+    for (uint64_t key : keys)
+    {
+        cache.Insert(key, UniquePtr<CachedObject>(new CachedObject(key)));
+    }
+
+    while (state.KeepRunning())
+    {
+        uint64_t sum = 0;
+        for (uint64_t key : keys)
+        {
+            CachedObject* object = cache.Find(key);
+            sum += object ? object->value : 0;
+        }
+        Benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsPerIteration(EntryCount);
+}
+
+/// Budget of half the keys, every lookup misses, creates and evicts.
+ALIMER_BENCHMARK(Cache_GetOrCreate_Evict)
+{
+    const std::vector<uint64_t> keys = CreateKeys();
+    Cache<CachedObject> cache;
+    cache.SetBudget(EntryCount / 2);
+
+    while (state.KeepRunning())
+    {
+        uint64_t sum = 0;
+        for (uint64_t key : keys)
+        {
+            CachedObject* object = cache.GetOrCreate(key, [key]() { return UniquePtr<CachedObject>(new CachedObject(key)); });
+            sum += object->value;
+        }
+        cache.ReleaseEvicted();
+        Benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsPerIteration(EntryCount);
+}
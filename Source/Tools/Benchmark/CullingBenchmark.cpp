@@ -0,0 +1,115 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Benchmark.h"
+#include "Math/FrustumCulling.h"
+#include "Math/MatrixKernels.h"
+#include "Math/MathUtil.h"
+#include <vector>
+
+using namespace Alimer;
+
+namespace
+{
+    const uint32_t CullingCount = 4096;
+    const uint32_t LargeCullingCount = 131072;
+
+    Frustum CreateFrustum()
+    {
+        const mat4 projection = mat4::perspective(ToRadians(60.0f), 16.0f / 9.0f, 1.0f, 1000.0f);
+        return Frustum(projection * mat4::translate(vec3(0.0f, -2.0f, 0.0f)));
+    }
+
+    /// Boxes spread over a grid in front of the camera, about half of them visible.
+    void CreateBoxes(BoundingBoxArray& boxes, uint32_t count)
+    {
+        boxes.Clear();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const float x = static_cast<float>(i % 64) * 16.0f - 512.0f;
+            const float z = -static_cast<float>(i / 64 % 64) * 16.0f;
+            const float y = static_cast<float>(i / 4096) * 4.0f;
+            boxes.Add(BoundingBox::FromCenterExtents(vec3(x, y, z), vec3(1.0f, 2.0f, 1.0f)));
+        }
+    }
+
+    void RunCullBoxes(Benchmark::State& state, SimdLevel level, uint32_t count)
+    {
+        const SimdLevel previous = GetSimdLevel();
+        SetSimdLevel(level);
+
+        const Frustum frustum = CreateFrustum();
+        BoundingBoxArray boxes;
+        CreateBoxes(boxes, count);
+        std::vector<uint32_t> visibility(GetVisibilityMaskSize(count));
+        while (state.KeepRunning())
+        {
+            CullBoxes(frustum, boxes, ArrayView<uint32_t>(visibility.data(), static_cast<uint32_t>(visibility.size())));
+            Benchmark::DoNotOptimize(visibility[0]);
+        }
+        state.SetItemsPerIteration(count);
+
+        SetSimdLevel(previous);
+    }
+}
+
+ALIMER_BENCHMARK(Culling_Frustum_Intersects_Loop)
+{
+    const Frustum frustum = CreateFrustum();
+    BoundingBoxArray boxes;
+    CreateBoxes(boxes, CullingCount);
+    std::vector<BoundingBox> source;
+    for (uint32_t i = 0; i < CullingCount; ++i)
+    {
+        source.push_back(boxes.Get(i));
+    }
+
+    while (state.KeepRunning())
+    {
+        uint32_t visibleCount = 0;
+        for (const BoundingBox& box : source)
+        {
+            visibleCount += frustum.Intersects(box) != Intersection::Outside;
+        }
+        Benchmark::DoNotOptimize(visibleCount);
+    }
+    state.SetItemsPerIteration(CullingCount);
+}
+
+ALIMER_BENCHMARK(Culling_Boxes_Scalar) { RunCullBoxes(state, SimdLevel::Scalar, CullingCount); }
+ALIMER_BENCHMARK(Culling_Boxes_SSE2) { RunCullBoxes(state, SimdLevel::SSE2, CullingCount); }
+ALIMER_BENCHMARK(Culling_Boxes_AVX) { RunCullBoxes(state, SimdLevel::AVX, CullingCount); }
+ALIMER_BENCHMARK(Culling_Boxes_Parallel) { RunCullBoxes(state, GetSupportedSimdLevel(), LargeCullingCount); }
+
+ALIMER_BENCHMARK(Culling_BoxesToIndices)
+{
+    const Frustum frustum = CreateFrustum();
+    BoundingBoxArray boxes;
+    CreateBoxes(boxes, CullingCount);
+    std::vector<uint32_t> indices(CullingCount);
+    while (state.KeepRunning())
+    {
+        const uint32_t visibleCount = CullBoxesToIndices(frustum, boxes, ArrayView<uint32_t>(indices.data(), CullingCount));
+        Benchmark::DoNotOptimize(visibleCount);
+    }
+    state.SetItemsPerIteration(CullingCount);
+}
@@ -0,0 +1,256 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Benchmark.h"
+#include "Scene/Entity.h"
+#include "Scene/Systems/CameraSystem.h"
+#include "Scene/Components/TransformComponent.h"
+#include "Scene/Components/CameraComponent.h"
+
+using namespace Alimer;
+
+namespace
+{
+    const uint32_t EntityCount = 200000;
+
+    struct PositionComponent : public Component<PositionComponent>
+    {
+        float x = 0.0f, y = 0.0f, z = 0.0f;
+    };
+
+    struct VelocityComponent : public Component<VelocityComponent>
+    {
+        float x = 1.0f, y = 1.0f, z = 1.0f;
+    };
+
+    EntityManager& GetMovementWorld()
+    {
+        static EntityManager* entities = nullptr;
+        if (!entities)
+        {
+            entities = new EntityManager();
+            for (uint32_t i = 0; i < EntityCount; ++i)
+            {
+                Entity entity = entities->Create();
+                entity.Assign<PositionComponent>();
+                if (i % 4 != 0)
+                {
+                    entity.Assign<VelocityComponent>();
+                }
+            }
+        }
+
+        return *entities;
+    }
+
+    EntityManager& GetCameraWorld()
+    {
+        static TransformHierarchy* hierarchy = nullptr;
+        static EntityManager* entities = nullptr;
+        if (!entities)
+        {
+            hierarchy = new TransformHierarchy();
+            entities = new EntityManager();
+            for (uint32_t i = 0; i < EntityCount / 10; ++i)
+            {
+                Entity entity = entities->Create();
+                entity.Assign<TransformComponent>(*hierarchy);
+                entity.Assign<CameraComponent>();
+            }
+            hierarchy->Update();
+        }
+
+        return *entities;
+    }
+}
+
+// Per entity GetComponent lookups, matches the previous TypedView::each implementation.
+ALIMER_BENCHMARK(Entity_Movement_IteratorGetComponent)
+{
+    EntityManager& entities = GetMovementWorld();
+    while (state.KeepRunning())
+    {
+        for (Entity entity : entities.EntitiesWithComponents<PositionComponent, VelocityComponent>())
+        {
+            PositionComponent* position = entity.GetComponent<PositionComponent>();
+            const VelocityComponent* velocity = entity.GetComponent<VelocityComponent>();
+            position->x += velocity->x;
+            position->y += velocity->y;
+            position->z += velocity->z;
+        }
+    }
+    state.SetItemsPerIteration(EntityCount - EntityCount / 4);
+}
+
+// Type-erased callback, matches the previous EntityManager::Each signature.
+ALIMER_BENCHMARK(Entity_Movement_EachStdFunction)
+{
+    EntityManager& entities = GetMovementWorld();
+    std::function<void(Entity, PositionComponent&, VelocityComponent&)> update =
+        [](Entity, PositionComponent& position, VelocityComponent& velocity)
+    {
+        position.x += velocity.x;
+        position.y += velocity.y;
+        position.z += velocity.z;
+    };
+
+    while (state.KeepRunning())
+    {
+        entities.Each<PositionComponent, VelocityComponent>(update);
+    }
+    state.SetItemsPerIteration(EntityCount - EntityCount / 4);
+}
+
+ALIMER_BENCHMARK(Entity_Movement_Each)
+{
+    EntityManager& entities = GetMovementWorld();
+    while (state.KeepRunning())
+    {
+        entities.Each<PositionComponent, VelocityComponent>(
+            [](Entity, PositionComponent& position, VelocityComponent& velocity)
+        {
+            position.x += velocity.x;
+            position.y += velocity.y;
+            position.z += velocity.z;
+        });
+    }
+    state.SetItemsPerIteration(EntityCount - EntityCount / 4);
+}
+
+ALIMER_BENCHMARK(Entity_Movement_EachChunk)
+{
+    EntityManager& entities = GetMovementWorld();
+    while (state.KeepRunning())
+    {
+        entities.EachChunk<PositionComponent, VelocityComponent>(
+            [](uint32_t count, const Entity::Id*, PositionComponent* positions, VelocityComponent* velocities)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                positions[i].x += velocities[i].x;
+                positions[i].y += velocities[i].y;
+                positions[i].z += velocities[i].z;
+            }
+        });
+    }
+    state.SetItemsPerIteration(EntityCount - EntityCount / 4);
+}
+
+ALIMER_BENCHMARK(Entity_Movement_ParallelEach)
+{
+    EntityManager& entities = GetMovementWorld();
+    while (state.KeepRunning())
+    {
+        entities.ParallelEach<PositionComponent, VelocityComponent>(
+            [](Entity, PositionComponent& position, VelocityComponent& velocity)
+        {
+            position.x += velocity.x;
+            position.y += velocity.y;
+            position.z += velocity.z;
+        });
+    }
+    state.SetItemsPerIteration(EntityCount - EntityCount / 4);
+}
+
+ALIMER_BENCHMARK(Entity_CameraSystem_EachStdFunction)
+{
+    EntityManager& entities = GetCameraWorld();
+    std::function<void(Entity, const TransformComponent&, CameraComponent&)> update =
+        [](Entity, const TransformComponent& transform, CameraComponent& camera)
+    {
+        camera.Update(transform.GetWorldMatrix());
+    };
+
+    while (state.KeepRunning())
+    {
+        entities.Each<const TransformComponent, CameraComponent>(update);
+    }
+    state.SetItemsPerIteration(EntityCount / 10);
+}
+
+ALIMER_BENCHMARK(Entity_CameraSystem_Update)
+{
+    EntityManager& entities = GetCameraWorld();
+    CameraSystem system;
+    while (state.KeepRunning())
+    {
+        system.Update(entities, 0.016);
+    }
+    state.SetItemsPerIteration(EntityCount / 10);
+}
+
+ALIMER_BENCHMARK(Entity_Query_RareComponent)
+{
+    // No entity of the movement world has a camera, measures the per query overhead.
+    EntityManager& entities = GetMovementWorld();
+    uint32_t count = 0;
+    while (state.KeepRunning())
+    {
+        entities.Each<const CameraComponent>([&count](Entity, const CameraComponent&)
+        {
+            count++;
+        });
+    }
+    Benchmark::DoNotOptimize(count);
+}
+
+ALIMER_BENCHMARK(Entity_Spawn_CreateAssign)
+{
+    const uint32_t spawnCount = 10000;
+    EntityManager entities;
+    std::vector<Entity::Id> ids(spawnCount);
+    while (state.KeepRunning())
+    {
+        for (uint32_t i = 0; i < spawnCount; ++i)
+        {
+            Entity entity = entities.Create();
+            entity.Assign<PositionComponent>();
+            entity.Assign<VelocityComponent>();
+            ids[i] = entity.GetId();
+        }
+
+        for (Entity::Id id : ids)
+        {
+            entities.Destroy(id);
+        }
+    }
+    state.SetItemsPerIteration(spawnCount);
+}
+
+ALIMER_BENCHMARK(Entity_Spawn_CreateMany)
+{
+    const uint32_t spawnCount = 10000;
+    EntityManager entities;
+    std::vector<Entity::Id> ids(spawnCount);
+    while (state.KeepRunning())
+    {
+        entities.CreateMany(ArrayView<Entity::Id>(ids.data(), spawnCount));
+        entities.AssignMany<PositionComponent>(ArrayView<const Entity::Id>(ids.data(), spawnCount));
+        entities.AssignMany<VelocityComponent>(ArrayView<const Entity::Id>(ids.data(), spawnCount));
+
+        for (Entity::Id id : ids)
+        {
+            entities.Destroy(id);
+        }
+    }
+    state.SetItemsPerIteration(spawnCount);
+}
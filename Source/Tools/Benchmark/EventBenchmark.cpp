@@ -0,0 +1,144 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Benchmark.h"
+#include "Core/Event.h"
+#include "Core/EventBus.h"
+
+using namespace Alimer;
+
+namespace
+{
+    const uint32_t EventCount = 1024;
+
+    struct MoveEvent
+    {
+        uint32_t entity;
+        float x;
+        float y;
+    };
+
+    struct MoveListener
+    {
+        void OnMove(const MoveEvent& event)
+        {
+            sum += event.x + event.y;
+        }
+
+        void OnMoves(const MoveEvent* events, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                sum += events[i].x + events[i].y;
+            }
+        }
+
+        float sum = 0.0f;
+    };
+}
+
+/// Synchronous event, mutex and std::function call per trigger.
+ALIMER_BENCHMARK(Event_TEvent)
+{
+    MoveListener listener;
+    TEvent<void, const MoveEvent&> event;
+    HEvent handle = event.Connect([&listener](const MoveEvent& e) { listener.OnMove(e); });
+    while (state.KeepRunning())
+    {
+        for (uint32_t i = 0; i < EventCount; ++i)
+        {
+            event(MoveEvent{ i, 1.0f, 2.0f });
+        }
+    }
+    handle.Disconnect();
+    Benchmark::DoNotOptimize(listener.sum);
+    state.SetItemsPerIteration(EventCount);
+}
+
+/// Deferred events, ring buffer push and one batched handler call per dispatch.
+ALIMER_BENCHMARK(Event_EventBus)
+{
+    MoveListener listener;
+    EventBus bus;
+    const uint32_t handle = bus.Subscribe<MoveEvent, MoveListener, &MoveListener::OnMoves>(&listener);
+    while (state.KeepRunning())
+    {
+        for (uint32_t i = 0; i < EventCount; ++i)
+        {
+            bus.Publish(MoveEvent{ i, 1.0f, 2.0f });
+        }
+        bus.Dispatch();
+    }
+    bus.Unsubscribe(handle);
+    Benchmark::DoNotOptimize(listener.sum);
+    state.SetItemsPerIteration(EventCount);
+}
+
+/// Every listener costs an indirect call per event.
+ALIMER_BENCHMARK(Event_TEvent_4Listeners)
+{
+    MoveListener listeners[4];
+    TEvent<void, const MoveEvent&> event;
+    HEvent handles[4];
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        MoveListener* listener = &listeners[i];
+        handles[i] = event.Connect([listener](const MoveEvent& e) { listener->OnMove(e); });
+    }
+
+    while (state.KeepRunning())
+    {
+        for (uint32_t i = 0; i < EventCount; ++i)
+        {
+            event(MoveEvent{ i, 1.0f, 2.0f });
+        }
+    }
+
+    for (HEvent& handle : handles)
+    {
+        handle.Disconnect();
+    }
+    Benchmark::DoNotOptimize(listeners[0].sum);
+    state.SetItemsPerIteration(EventCount);
+}
+
+/// Every listener costs one call per batch.
+ALIMER_BENCHMARK(Event_EventBus_4Listeners)
+{
+    MoveListener listeners[4];
+    EventBus bus;
+    for (MoveListener& listener : listeners)
+    {
+        bus.Subscribe<MoveEvent, MoveListener, &MoveListener::OnMoves>(&listener);
+    }
+
+    while (state.KeepRunning())
+    {
+        for (uint32_t i = 0; i < EventCount; ++i)
+        {
+            bus.Publish(MoveEvent{ i, 1.0f, 2.0f });
+        }
+        bus.Dispatch();
+    }
+    Benchmark::DoNotOptimize(listeners[0].sum);
+    state.SetItemsPerIteration(EventCount);
+}
@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Benchmark.h"
+#include "Base/HashMap.h"
+#include "Base/MurmurHash.h"
+#include <vector>
+
+using namespace Alimer;
+
+namespace
+{
+    /// Previous Hasher, FNV style multiply-xor per element.
+    class FnvHasher
+    {
+    public:
+        template <typename T>
+        void Data(const T* data, size_t size)
+        {
+            size /= sizeof(*data);
+            for (size_t i = 0; i < size; i++)
+            {
+                _value = (_value * 0x100000001b3ull) ^ data[i];
+            }
+        }
+
+        void UInt32(uint32_t value) { _value = (_value * 0x100000001b3ull) ^ value; }
+        uint64_t GetValue() const { return _value; }
+
+    private:
+        uint64_t _value = 0xcbf29ce484222325ull;
+    };
+
+    /// Roughly the size of a pipeline key: a handful of state words and the vertex layout.
+    struct PipelineKey
+    {
+        uint32_t state[8];
+        uint32_t attributes[16];
+    };
+
+    PipelineKey CreateKey()
+    {
+        PipelineKey key;
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            key.state[i] = i * 0x9e3779b9u;
+        }
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            key.attributes[i] = i * 12;
+        }
+        return key;
+    }
+
+    template <typename H>
+    void RunHashWords(Benchmark::State& state)
+    {
+        PipelineKey key = CreateKey();
+        while (state.KeepRunning())
+        {
+            H hasher;
+            for (uint32_t value : key.state)
+            {
+                hasher.UInt32(value);
+            }
+            hasher.Data(key.attributes, sizeof(key.attributes));
+            Benchmark::DoNotOptimize(hasher.GetValue());
+            key.state[0]++;
+            // Keep the key opaque, otherwise the constant words are folded into the hash at compile time.
+            Benchmark::DoNotOptimize(&key);
+        }
+        state.SetItemsPerIteration(1);
+    }
+
+    /// Four words, the size of a small descriptor key.
+    template <typename H>
+    void RunHashShortKey(Benchmark::State& state)
+    {
+        uint32_t key[4] = { 1, 2, 3, 4 };
+        while (state.KeepRunning())
+        {
+            H hasher;
+            for (uint32_t value : key)
+            {
+                hasher.UInt32(value);
+            }
+            Benchmark::DoNotOptimize(hasher.GetValue());
+            key[0]++;
+            Benchmark::DoNotOptimize(&key);
+        }
+        state.SetItemsPerIteration(1);
+    }
+
+    template <typename H>
+    void RunHashBuffer(Benchmark::State& state)
+    {
+        std::vector<uint32_t> buffer(1024, 0x12345678u);
+        while (state.KeepRunning())
+        {
+            H hasher;
+            hasher.Data(buffer.data(), buffer.size() * sizeof(uint32_t));
+            Benchmark::DoNotOptimize(hasher.GetValue());
+        }
+        state.SetItemsPerIteration(buffer.size() * sizeof(uint32_t));
+    }
+
+    void RunMurmur(Benchmark::State& state, Hash(*function)(const void*, int32_t, uint32_t), int32_t size)
+    {
+        std::vector<uint8_t> buffer(size, 0x5a);
+        while (state.KeepRunning())
+        {
+            const Hash hash = function(buffer.data(), size, 0);
+            Benchmark::DoNotOptimize(hash.A);
+        }
+        state.SetItemsPerIteration(size);
+    }
+}
+
+ALIMER_BENCHMARK(Hash_ShortKey_Fnv) { RunHashShortKey<FnvHasher>(state); }
+ALIMER_BENCHMARK(Hash_ShortKey_Hasher) { RunHashShortKey<Hasher>(state); }
+ALIMER_BENCHMARK(Hash_PipelineKey_Fnv) { RunHashWords<FnvHasher>(state); }
+ALIMER_BENCHMARK(Hash_PipelineKey_Hasher) { RunHashWords<Hasher>(state); }
+ALIMER_BENCHMARK(Hash_Buffer_Fnv) { RunHashBuffer<FnvHasher>(state); }
+ALIMER_BENCHMARK(Hash_Buffer_Hasher) { RunHashBuffer<Hasher>(state); }
+ALIMER_BENCHMARK(Hash_Murmur_64) { RunMurmur(state, GenerateHash, 64); }
+ALIMER_BENCHMARK(Hash_MurmurWide_64) { RunMurmur(state, GenerateHashWide, 64); }
+ALIMER_BENCHMARK(Hash_Murmur_4096) { RunMurmur(state, GenerateHash, 4096); }
+ALIMER_BENCHMARK(Hash_MurmurWide_4096) { RunMurmur(state, GenerateHashWide, 4096); }
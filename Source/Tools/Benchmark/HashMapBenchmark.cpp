@@ -0,0 +1,124 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Benchmark.h"
+#include "Base/HashMap.h"
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace Alimer;
+
+namespace
+{
+    const uint32_t KeyCount = 16384;
+
+    /// Previous HashMap definition.
+    template <typename T>
+    using NodeHashMap = std::unordered_map<uint64_t, T, HashMapHasher>;
+
+    /// Pre-hashed keys like the ones produced by Hasher, plus a second set that is never inserted.
+    const std::vector<uint64_t>& GetKeys(bool missing)
+    {
+        static std::vector<uint64_t> keys[2];
+        if (keys[0].empty())
+        {
+            std::mt19937_64 random(42);
+            for (uint32_t i = 0; i < KeyCount * 2; ++i)
+            {
+                Hasher hasher;
+                hasher.UInt64(random());
+                keys[i & 1].push_back(hasher.GetValue());
+            }
+        }
+
+        return keys[missing ? 1 : 0];
+    }
+
+    template <typename Map>
+    void RunInsert(Benchmark::State& state)
+    {
+        const std::vector<uint64_t>& keys = GetKeys(false);
+        while (state.KeepRunning())
+        {
+            Map map;
+            for (uint64_t key : keys)
+            {
+                map[key] = static_cast<uint32_t>(key);
+            }
+            Benchmark::DoNotOptimize(map.size());
+        }
+        state.SetItemsPerIteration(KeyCount);
+    }
+
+    template <typename Map>
+    void RunFind(Benchmark::State& state, bool missing)
+    {
+        Map map;
+        for (uint64_t key : GetKeys(false))
+        {
+            map[key] = static_cast<uint32_t>(key);
+        }
+
+        const std::vector<uint64_t>& keys = GetKeys(missing);
+        while (state.KeepRunning())
+        {
+            uint32_t found = 0;
+            for (uint64_t key : keys)
+            {
+                found += map.find(key) != map.end();
+            }
+            Benchmark::DoNotOptimize(found);
+        }
+        state.SetItemsPerIteration(KeyCount);
+    }
+
+    template <typename Map>
+    void RunIterate(Benchmark::State& state)
+    {
+        Map map;
+        for (uint64_t key : GetKeys(false))
+        {
+            map[key] = static_cast<uint32_t>(key);
+        }
+
+        while (state.KeepRunning())
+        {
+            uint32_t sum = 0;
+            for (const auto& pair : map)
+            {
+                sum += pair.second;
+            }
+            Benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsPerIteration(KeyCount);
+    }
+}
+
+ALIMER_BENCHMARK(HashMap_Insert_Node) { RunInsert<NodeHashMap<uint32_t>>(state); }
+ALIMER_BENCHMARK(HashMap_Insert_Flat) { RunInsert<HashMap<uint32_t>>(state); }
+ALIMER_BENCHMARK(HashMap_FindHit_Node) { RunFind<NodeHashMap<uint32_t>>(state, false); }
+ALIMER_BENCHMARK(HashMap_FindHit_Flat) { RunFind<HashMap<uint32_t>>(state, false); }
+ALIMER_BENCHMARK(HashMap_FindMiss_Node) { RunFind<NodeHashMap<uint32_t>>(state, true); }
+ALIMER_BENCHMARK(HashMap_FindMiss_Flat) { RunFind<HashMap<uint32_t>>(state, true); }
+ALIMER_BENCHMARK(HashMap_Iterate_Node) { RunIterate<NodeHashMap<uint32_t>>(state); }
+ALIMER_BENCHMARK(HashMap_Iterate_Flat) { RunIterate<HashMap<uint32_t>>(state); }
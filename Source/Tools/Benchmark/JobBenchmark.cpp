@@ -0,0 +1,106 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Benchmark.h"
+#include "Core/JobSystem.h"
+#include <atomic>
+#include <vector>
+
+using namespace Alimer;
+
+namespace
+{
+    const uint32_t JobCount = 1024;
+    const uint32_t ElementCount = 1 << 16;
+
+    void EmptyJob(void* data, uint32_t)
+    {
+        static_cast<std::atomic<uint32_t>*>(data)->fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+ALIMER_BENCHMARK(Job_Schedule_Wait)
+{
+    JobSystem* jobSystem = JobSystem::GetInstance();
+    std::atomic<uint32_t> executed{ 0 };
+    while (state.KeepRunning())
+    {
+        JobCounter counter;
+        for (uint32_t i = 0; i < JobCount; ++i)
+        {
+            jobSystem->Schedule(EmptyJob, &executed, &counter);
+        }
+        jobSystem->Wait(counter);
+    }
+    Benchmark::DoNotOptimize(executed.load());
+    state.SetItemsPerIteration(JobCount);
+}
+
+ALIMER_BENCHMARK(Job_Graph_Chain)
+{
+    std::atomic<uint32_t> executed{ 0 };
+    JobGraph graph;
+    for (uint32_t i = 0; i < JobCount; ++i)
+    {
+        const uint32_t job = graph.AddJob(EmptyJob, &executed);
+        if (job > 0)
+            graph.AddDependency(job - 1, job);
+    }
+
+    while (state.KeepRunning())
+    {
+        graph.Run();
+    }
+    Benchmark::DoNotOptimize(executed.load());
+    state.SetItemsPerIteration(JobCount);
+}
+
+/// Fixed small grain, one range per atomic increment.
+ALIMER_BENCHMARK(Job_ParallelFor_Grain16)
+{
+    std::vector<float> values(ElementCount, 1.0f);
+    while (state.KeepRunning())
+    {
+        JobSystem::GetInstance()->ParallelFor(ElementCount, 16, [&values](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; ++i)
+                values[i] = values[i] * 0.5f + 1.0f;
+        });
+    }
+    Benchmark::DoNotOptimize(values.data());
+    state.SetItemsPerIteration(ElementCount);
+}
+
+ALIMER_BENCHMARK(Job_ParallelFor_Adaptive)
+{
+    std::vector<float> values(ElementCount, 1.0f);
+    while (state.KeepRunning())
+    {
+        JobSystem::GetInstance()->ParallelFor(ElementCount, [&values](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; ++i)
+                values[i] = values[i] * 0.5f + 1.0f;
+        });
+    }
+    Benchmark::DoNotOptimize(values.data());
+    state.SetItemsPerIteration(ElementCount);
+}
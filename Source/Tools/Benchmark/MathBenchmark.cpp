@@ -0,0 +1,124 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Benchmark.h"
+#include "Math/MathBatch.h"
+#include <vector>
+
+using namespace Alimer;
+
+namespace
+{
+    const uint32_t ElementCount = 4096;
+
+    struct MathData
+    {
+        mat4 matrix;
+        std::vector<vec3> points;
+        std::vector<vec3> output;
+        std::vector<quat> rotations;
+        std::vector<mat4> matrices;
+        std::vector<mat4> matricesOutput;
+    };
+
+    MathData& GetMathData()
+    {
+        static MathData* data = nullptr;
+        if (!data)
+        {
+            data = new MathData();
+            data->matrix = mat4::translate(vec3(1.0f, 2.0f, 3.0f)) * mat4_cast(normalize(quat(0.9f, 0.1f, 0.3f, 0.2f)));
+            for (uint32_t i = 0; i < ElementCount; ++i)
+            {
+                const float value = static_cast<float>(i);
+                data->points.push_back(vec3(value, value * 0.5f, -value));
+                data->rotations.push_back(normalize(quat(1.0f, value * 0.01f, 0.2f, -0.3f)));
+                data->matrices.push_back(mat4::translate(vec3(value, 0.0f, 0.0f)) * data->matrix);
+            }
+            data->output.resize(ElementCount);
+            data->matricesOutput.resize(ElementCount);
+        }
+
+        return *data;
+    }
+}
+
+ALIMER_BENCHMARK(Math_TransformPoints_Loop)
+{
+    MathData& data = GetMathData();
+    while (state.KeepRunning())
+    {
+        for (uint32_t i = 0; i < ElementCount; ++i)
+        {
+            data.output[i] = (data.matrix * vec4(data.points[i], 1.0f)).xyz();
+        }
+        Benchmark::DoNotOptimize(data.output[0]);
+    }
+    state.SetItemsPerIteration(ElementCount);
+}
+
+ALIMER_BENCHMARK(Math_TransformPoints_Batch)
+{
+    MathData& data = GetMathData();
+    while (state.KeepRunning())
+    {
+        TransformPoints(data.matrix, ArrayView<const vec3>(data.points.data(), ElementCount), ArrayView<vec3>(data.output.data(), ElementCount));
+        Benchmark::DoNotOptimize(data.output[0]);
+    }
+    state.SetItemsPerIteration(ElementCount);
+}
+
+ALIMER_BENCHMARK(Math_RotateVectors_Loop)
+{
+    MathData& data = GetMathData();
+    while (state.KeepRunning())
+    {
+        for (uint32_t i = 0; i < ElementCount; ++i)
+        {
+            data.output[i] = data.rotations[i] * data.points[i];
+        }
+        Benchmark::DoNotOptimize(data.output[0]);
+    }
+    state.SetItemsPerIteration(ElementCount);
+}
+
+ALIMER_BENCHMARK(Math_RotateVectors_Batch)
+{
+    MathData& data = GetMathData();
+    while (state.KeepRunning())
+    {
+        RotateVectors(ArrayView<const quat>(data.rotations.data(), ElementCount), ArrayView<const vec3>(data.points.data(), ElementCount), ArrayView<vec3>(data.output.data(), ElementCount));
+        Benchmark::DoNotOptimize(data.output[0]);
+    }
+    state.SetItemsPerIteration(ElementCount);
+}
+
+ALIMER_BENCHMARK(Math_MultiplyMatrices_Batch)
+{
+    MathData& data = GetMathData();
+    while (state.KeepRunning())
+    {
+        MultiplyMatrices(ArrayView<const mat4>(data.matrices.data(), ElementCount), ArrayView<const mat4>(data.matrices.data(), ElementCount), ArrayView<mat4>(data.matricesOutput.data(), ElementCount));
+        Benchmark::DoNotOptimize(data.matricesOutput[0]);
+    }
+    state.SetItemsPerIteration(ElementCount);
+}
@@ -0,0 +1,140 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Benchmark.h"
+#include "Math/MatrixKernels.h"
+#include <vector>
+
+using namespace Alimer;
+
+namespace
+{
+    const uint32_t MatrixCount = 1024;
+
+    struct MatrixData
+    {
+        std::vector<mat4> general;
+        std::vector<mat4> affine;
+        std::vector<mat4> output;
+    };
+
+    MatrixData& GetMatrixData()
+    {
+        static MatrixData* data = nullptr;
+        if (!data)
+        {
+            data = new MatrixData();
+            for (uint32_t i = 0; i < MatrixCount; ++i)
+            {
+                const float value = static_cast<float>(i) * 0.001f;
+                mat4 affine = mat4::translate(vec3(value, 2.0f, -value))
+                    * mat4_cast(normalize(quat(1.0f, value, 0.5f, -0.25f)));
+                affine[0] = affine[0] * (1.0f + value);
+                affine[1] = affine[1] * 2.0f;
+                mat4 general = affine;
+                general[0].w = 0.1f + value;
+                general[2].w = -0.2f;
+                data->affine.push_back(affine);
+                data->general.push_back(general);
+            }
+            data->output.resize(MatrixCount);
+        }
+
+        return *data;
+    }
+
+    /// Runs the kernels at given level, levels above the supported one are clamped.
+    class LevelScope
+    {
+    public:
+        explicit LevelScope(SimdLevel level) : _previous(GetSimdLevel()) { SetSimdLevel(level); }
+        ~LevelScope() { SetSimdLevel(_previous); }
+
+    private:
+        SimdLevel _previous;
+    };
+
+    void RunMultiply(Benchmark::State& state, SimdLevel level)
+    {
+        LevelScope scope(level);
+        MatrixData& data = GetMatrixData();
+        while (state.KeepRunning())
+        {
+            MultiplyMatrices(data.general.data(), data.affine.data(), data.output.data(), MatrixCount);
+            Benchmark::DoNotOptimize(data.output[0]);
+        }
+        state.SetItemsPerIteration(MatrixCount);
+    }
+
+    void RunInverse(Benchmark::State& state, SimdLevel level)
+    {
+        LevelScope scope(level);
+        MatrixData& data = GetMatrixData();
+        while (state.KeepRunning())
+        {
+            InverseMatrices(data.general.data(), data.output.data(), MatrixCount);
+            Benchmark::DoNotOptimize(data.output[0]);
+        }
+        state.SetItemsPerIteration(MatrixCount);
+    }
+
+    void RunInverseAffine(Benchmark::State& state, SimdLevel level)
+    {
+        LevelScope scope(level);
+        MatrixData& data = GetMatrixData();
+        while (state.KeepRunning())
+        {
+            InverseAffineMatrices(data.affine.data(), data.output.data(), MatrixCount);
+            Benchmark::DoNotOptimize(data.output[0]);
+        }
+        state.SetItemsPerIteration(MatrixCount);
+    }
+
+    void RunDecompose(Benchmark::State& state, SimdLevel level)
+    {
+        LevelScope scope(level);
+        MatrixData& data = GetMatrixData();
+        vec3 scale, translation;
+        quat rotation;
+        while (state.KeepRunning())
+        {
+            for (uint32_t i = 0; i < MatrixCount; ++i)
+            {
+                decompose(data.affine[i], scale, rotation, translation);
+                Benchmark::DoNotOptimize(rotation);
+            }
+        }
+        state.SetItemsPerIteration(MatrixCount);
+    }
+}
+
+ALIMER_BENCHMARK(Matrix_Multiply_Scalar) { RunMultiply(state, SimdLevel::Scalar); }
+ALIMER_BENCHMARK(Matrix_Multiply_SSE2) { RunMultiply(state, SimdLevel::SSE2); }
+ALIMER_BENCHMARK(Matrix_Multiply_AVX) { RunMultiply(state, SimdLevel::AVX); }
+ALIMER_BENCHMARK(Matrix_Inverse_Scalar) { RunInverse(state, SimdLevel::Scalar); }
+ALIMER_BENCHMARK(Matrix_Inverse_SSE2) { RunInverse(state, SimdLevel::SSE2); }
+ALIMER_BENCHMARK(Matrix_Inverse_AVX) { RunInverse(state, SimdLevel::AVX); }
+ALIMER_BENCHMARK(Matrix_InverseAffine_Scalar) { RunInverseAffine(state, SimdLevel::Scalar); }
+ALIMER_BENCHMARK(Matrix_InverseAffine_SSE2) { RunInverseAffine(state, SimdLevel::SSE2); }
+ALIMER_BENCHMARK(Matrix_InverseAffine_AVX) { RunInverseAffine(state, SimdLevel::AVX); }
+ALIMER_BENCHMARK(Matrix_Decompose_Scalar) { RunDecompose(state, SimdLevel::Scalar); }
+ALIMER_BENCHMARK(Matrix_Decompose_SSE2) { RunDecompose(state, SimdLevel::SSE2); }
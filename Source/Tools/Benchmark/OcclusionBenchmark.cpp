@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Benchmark.h"
+#include "Renderer/OcclusionBuffer.h"
+#include "Math/MathUtil.h"
+#include <vector>
+
+using namespace Alimer;
+
+namespace
+{
+    const uint32_t OccluderCount = 64;
+    const uint32_t OccludeeCount = 16384;
+
+    const vec3 CubePositions[8] =
+    {
+        vec3(-1.0f, -1.0f, -1.0f), vec3(1.0f, -1.0f, -1.0f), vec3(1.0f, 1.0f, -1.0f), vec3(-1.0f, 1.0f, -1.0f),
+        vec3(-1.0f, -1.0f, 1.0f), vec3(1.0f, -1.0f, 1.0f), vec3(1.0f, 1.0f, 1.0f), vec3(-1.0f, 1.0f, 1.0f)
+    };
+
+    const uint16_t CubeIndices[36] =
+    {
+        0, 1, 2, 0, 2, 3, 4, 6, 5, 4, 7, 6, 0, 4, 5, 0, 5, 1,
+        3, 2, 6, 3, 6, 7, 0, 3, 7, 0, 7, 4, 1, 5, 6, 1, 6, 2
+    };
+
+    mat4 CreateViewProjection()
+    {
+        const mat4 projection = mat4::perspective(ToRadians(60.0f), 2.0f, 0.5f, 500.0f);
+        return projection * mat4::translate(vec3(0.0f, -2.0f, 0.0f));
+    }
+
+    /// Row of wide buildings close to the camera.
+    void AddOccluders(OcclusionBuffer& buffer)
+    {
+        for (uint32_t i = 0; i < OccluderCount; ++i)
+        {
+            const float x = static_cast<float>(i % 16) * 8.0f - 64.0f;
+            const float z = -20.0f - static_cast<float>(i / 16) * 12.0f;
+            mat4 world = mat4::translate(vec3(x, 4.0f, z));
+            world[0] = world[0] * 3.5f;
+            world[1] = world[1] * 6.0f;
+            buffer.AddOccluder(world, CubePositions, CubeIndices, 36);
+        }
+    }
+
+    /// Small boxes spread behind the occluders, most of them hidden.
+    void CreateBoxes(BoundingBoxArray& boxes)
+    {
+        boxes.Clear();
+        for (uint32_t i = 0; i < OccludeeCount; ++i)
+        {
+            const float x = static_cast<float>(i % 128) * 2.0f - 128.0f;
+            const float z = -80.0f - static_cast<float>(i / 128) * 2.0f;
+            boxes.Add(BoundingBox::FromCenterExtents(vec3(x, 1.0f, z), vec3(0.5f)));
+        }
+    }
+}
+
+ALIMER_BENCHMARK(Occlusion_Rasterize)
+{
+    OcclusionBuffer buffer;
+    const mat4 viewProjection = CreateViewProjection();
+    while (state.KeepRunning())
+    {
+        buffer.Clear(viewProjection);
+        AddOccluders(buffer);
+        buffer.Rasterize();
+        Benchmark::DoNotOptimize(buffer.GetDepth(0, 0));
+    }
+    state.SetItemsPerIteration(OccluderCount * 12);
+}
+
+ALIMER_BENCHMARK(Occlusion_TestBoxes)
+{
+    OcclusionBuffer buffer;
+    buffer.Clear(CreateViewProjection());
+    AddOccluders(buffer);
+    buffer.Rasterize();
+
+    BoundingBoxArray boxes;
+    CreateBoxes(boxes);
+    std::vector<uint32_t> visibility(GetVisibilityMaskSize(OccludeeCount));
+    while (state.KeepRunning())
+    {
+        buffer.TestBoxes(boxes, ArrayView<uint32_t>(visibility.data(), static_cast<uint32_t>(visibility.size())));
+        Benchmark::DoNotOptimize(visibility[0]);
+    }
+    state.SetItemsPerIteration(OccludeeCount);
+}
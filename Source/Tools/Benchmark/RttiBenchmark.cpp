@@ -0,0 +1,133 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Benchmark.h"
+#include "Core/Object.h"
+
+using namespace Alimer;
+
+namespace
+{
+    class Level0 : public Object { ALIMER_OBJECT(Level0, Object); };
+    class Level1 : public Level0 { ALIMER_OBJECT(Level1, Level0); };
+    class Level2 : public Level1 { ALIMER_OBJECT(Level2, Level1); };
+    class Level3 : public Level2 { ALIMER_OBJECT(Level3, Level2); };
+    class Level4 : public Level3 { ALIMER_OBJECT(Level4, Level3); };
+    class Level5 : public Level4 { ALIMER_OBJECT(Level5, Level4); };
+    class Level6 : public Level5 { ALIMER_OBJECT(Level6, Level5); };
+    class Level7 : public Level6 { ALIMER_OBJECT(Level7, Level6); };
+    class Sibling : public Level0 { ALIMER_OBJECT(Sibling, Level0); };
+
+    const uint32_t ObjectCount = 1024;
+
+    /// Previous implementation, walks the base type chain.
+    bool IsTypeOfChain(const TypeInfo* current, const TypeInfo* typeInfo)
+    {
+        while (current)
+        {
+            if (current == typeInfo)
+                return true;
+
+            current = current->GetBaseTypeInfo();
+        }
+
+        return false;
+    }
+
+    template <typename Check>
+    uint32_t CountInstances(Object* const* objects, Check check)
+    {
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < ObjectCount; ++i)
+        {
+            count += check(objects[i]) ? 1 : 0;
+        }
+        return count;
+    }
+
+    /// Deepest objects mixed with siblings, half of the checks fail.
+    struct Objects
+    {
+        Objects()
+        {
+            for (uint32_t i = 0; i < ObjectCount; ++i)
+            {
+                holders[i] = (i & 1) ? static_cast<Object*>(new Level7()) : static_cast<Object*>(new Sibling());
+                objects[i] = holders[i].Get();
+            }
+        }
+
+        SharedPtr<Object> holders[ObjectCount];
+        Object* objects[ObjectCount];
+    };
+}
+
+ALIMER_BENCHMARK(Rtti_IsInstanceOf_Chain_Root)
+{
+    Objects objects;
+    uint32_t count = 0;
+    while (state.KeepRunning())
+    {
+        count += CountInstances(objects.objects, [](Object* object) { return IsTypeOfChain(object->GetTypeInfo(), Level1::GetTypeInfoStatic()); });
+    }
+    Benchmark::DoNotOptimize(count);
+    state.SetItemsPerIteration(ObjectCount);
+}
+
+ALIMER_BENCHMARK(Rtti_IsInstanceOf_Root)
+{
+    Objects objects;
+    uint32_t count = 0;
+    while (state.KeepRunning())
+    {
+        count += CountInstances(objects.objects, [](Object* object) { return object->IsInstanceOf<Level1>(); });
+    }
+    Benchmark::DoNotOptimize(count);
+    state.SetItemsPerIteration(ObjectCount);
+}
+
+ALIMER_BENCHMARK(Rtti_Cast_Chain_Leaf)
+{
+    Objects objects;
+    uint32_t count = 0;
+    while (state.KeepRunning())
+    {
+        count += CountInstances(objects.objects, [](Object* object)
+        {
+            return (IsTypeOfChain(object->GetTypeInfo(), Level7::GetTypeInfoStatic()) ? static_cast<Level7*>(object) : nullptr) != nullptr;
+        });
+    }
+    Benchmark::DoNotOptimize(count);
+    state.SetItemsPerIteration(ObjectCount);
+}
+
+ALIMER_BENCHMARK(Rtti_Cast_Leaf)
+{
+    Objects objects;
+    uint32_t count = 0;
+    while (state.KeepRunning())
+    {
+        count += CountInstances(objects.objects, [](Object* object) { return object->Cast<Level7>() != nullptr; });
+    }
+    Benchmark::DoNotOptimize(count);
+    state.SetItemsPerIteration(ObjectCount);
+}
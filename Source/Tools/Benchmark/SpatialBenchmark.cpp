@@ -0,0 +1,177 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Benchmark.h"
+#include "Scene/BoundingVolumeHierarchy.h"
+#include "Math/MathUtil.h"
+#include <vector>
+
+using namespace Alimer;
+
+namespace
+{
+    const uint32_t ProxyCount = 16384;
+
+    /// Boxes spread over a 1024 x 1024 area, generated deterministically.
+    const std::vector<BoundingBox>& GetBoxes()
+    {
+        static std::vector<BoundingBox> boxes;
+        if (boxes.empty())
+        {
+            uint32_t seed = 1;
+            auto random = [&seed]() {
+                seed = seed * 1664525u + 1013904223u;
+                return static_cast<float>(seed >> 8) / 16777216.0f;
+            };
+
+            for (uint32_t i = 0; i < ProxyCount; ++i)
+            {
+                const vec3 center(random() * 1024.0f - 512.0f, random() * 8.0f, random() * 1024.0f - 512.0f);
+                boxes.push_back(BoundingBox::FromCenterExtents(center, vec3(1.0f + random(), 2.0f, 1.0f + random())));
+            }
+        }
+
+        return boxes;
+    }
+
+    BoundingVolumeHierarchy& GetTree(std::vector<uint32_t>* proxies = nullptr)
+    {
+        static BoundingVolumeHierarchy* tree = nullptr;
+        static std::vector<uint32_t> treeProxies;
+        if (!tree)
+        {
+            tree = new BoundingVolumeHierarchy();
+            const std::vector<BoundingBox>& boxes = GetBoxes();
+            for (uint32_t i = 0; i < ProxyCount; ++i)
+            {
+                treeProxies.push_back(tree->CreateProxy(boxes[i], i));
+            }
+        }
+
+        if (proxies)
+        {
+            *proxies = treeProxies;
+        }
+
+        return *tree;
+    }
+
+    Frustum CreateFrustum()
+    {
+        const mat4 projection = mat4::perspective(ToRadians(60.0f), 16.0f / 9.0f, 1.0f, 200.0f);
+        return Frustum(projection * mat4::translate(vec3(0.0f, -2.0f, 0.0f)));
+    }
+}
+
+ALIMER_BENCHMARK(Spatial_Frustum_BruteForce)
+{
+    const std::vector<BoundingBox>& boxes = GetBoxes();
+    const Frustum frustum = CreateFrustum();
+    while (state.KeepRunning())
+    {
+        uint32_t visibleCount = 0;
+        for (const BoundingBox& box : boxes)
+        {
+            visibleCount += frustum.Intersects(box) != Intersection::Outside;
+        }
+        Benchmark::DoNotOptimize(visibleCount);
+    }
+}
+
+ALIMER_BENCHMARK(Spatial_Frustum_Tree)
+{
+    const BoundingVolumeHierarchy& tree = GetTree();
+    const Frustum frustum = CreateFrustum();
+    while (state.KeepRunning())
+    {
+        uint32_t visibleCount = 0;
+        tree.QueryFrustum(frustum, [&visibleCount](uint32_t, uint64_t) {
+            visibleCount++;
+            return true;
+        });
+        Benchmark::DoNotOptimize(visibleCount);
+    }
+}
+
+ALIMER_BENCHMARK(Spatial_Ray_BruteForce)
+{
+    const std::vector<BoundingBox>& boxes = GetBoxes();
+    const Ray ray(vec3(-600.0f, 3.0f, -600.0f), vec3(1.0f, 0.0f, 1.1f));
+    while (state.KeepRunning())
+    {
+        float closest = std::numeric_limits<float>::infinity();
+        for (const BoundingBox& box : boxes)
+        {
+            closest = min(closest, ray.HitDistance(box));
+        }
+        Benchmark::DoNotOptimize(closest);
+    }
+}
+
+ALIMER_BENCHMARK(Spatial_Ray_Tree)
+{
+    const BoundingVolumeHierarchy& tree = GetTree();
+    const Ray ray(vec3(-600.0f, 3.0f, -600.0f), vec3(1.0f, 0.0f, 1.1f));
+    while (state.KeepRunning())
+    {
+        float closest = std::numeric_limits<float>::infinity();
+        tree.QueryRay(ray, 2000.0f, [&closest](uint32_t, uint64_t, float distance) {
+            closest = min(closest, distance);
+            return distance;
+        });
+        Benchmark::DoNotOptimize(closest);
+    }
+}
+
+ALIMER_BENCHMARK(Spatial_Box_Tree)
+{
+    const BoundingVolumeHierarchy& tree = GetTree();
+    const BoundingBox area(vec3(-16.0f, 0.0f, -16.0f), vec3(16.0f, 8.0f, 16.0f));
+    while (state.KeepRunning())
+    {
+        uint32_t overlapCount = 0;
+        tree.QueryBox(area, [&overlapCount](uint32_t, uint64_t) {
+            overlapCount++;
+            return true;
+        });
+        Benchmark::DoNotOptimize(overlapCount);
+    }
+}
+
+ALIMER_BENCHMARK(Spatial_MoveProxy)
+{
+    std::vector<uint32_t> proxies;
+    BoundingVolumeHierarchy& tree = GetTree(&proxies);
+    const std::vector<BoundingBox>& boxes = GetBoxes();
+    float offset = 0.0f;
+    while (state.KeepRunning())
+    {
+        // Alternate between two positions so every move leaves the fat box.
+        offset = offset == 0.0f ? 4.0f : 0.0f;
+        const vec3 displacement(offset, 0.0f, 0.0f);
+        for (uint32_t i = 0; i < 1024; ++i)
+        {
+            tree.MoveProxy(proxies[i], BoundingBox(boxes[i].min + displacement, boxes[i].max + displacement));
+        }
+    }
+    state.SetItemsPerIteration(1024);
+}
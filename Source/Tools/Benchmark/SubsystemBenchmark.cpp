@@ -0,0 +1,126 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Benchmark.h"
+#include "Core/Object.h"
+#include <map>
+
+using namespace Alimer;
+
+namespace
+{
+    class TestSubsystem : public Object
+    {
+    public:
+        uint32_t value = 0;
+    };
+
+    class Subsystem0 : public TestSubsystem { ALIMER_OBJECT(Subsystem0, TestSubsystem); };
+    class Subsystem1 : public TestSubsystem { ALIMER_OBJECT(Subsystem1, TestSubsystem); };
+    class Subsystem2 : public TestSubsystem { ALIMER_OBJECT(Subsystem2, TestSubsystem); };
+    class Subsystem3 : public TestSubsystem { ALIMER_OBJECT(Subsystem3, TestSubsystem); };
+    class Subsystem4 : public TestSubsystem { ALIMER_OBJECT(Subsystem4, TestSubsystem); };
+    class Subsystem5 : public TestSubsystem { ALIMER_OBJECT(Subsystem5, TestSubsystem); };
+    class Subsystem6 : public TestSubsystem { ALIMER_OBJECT(Subsystem6, TestSubsystem); };
+    class Subsystem7 : public TestSubsystem { ALIMER_OBJECT(Subsystem7, TestSubsystem); };
+
+    const uint32_t LookupCount = 1024;
+
+    /// Registers subsystems, both in the registry and in a map like the previous implementation.
+    struct Subsystems
+    {
+        Subsystems()
+        {
+            Add(&s0); Add(&s1); Add(&s2); Add(&s3);
+            Add(&s4); Add(&s5); Add(&s6); Add(&s7);
+        }
+
+        ~Subsystems()
+        {
+            for (auto& entry : map)
+            {
+                Object::RemoveSubsystem(entry.second);
+            }
+        }
+
+        void Add(Object* subsystem)
+        {
+            Object::AddSubsystem(subsystem);
+            map[subsystem->GetType()] = subsystem;
+        }
+
+        Subsystem0 s0; Subsystem1 s1; Subsystem2 s2; Subsystem3 s3;
+        Subsystem4 s4; Subsystem5 s5; Subsystem6 s6; Subsystem7 s7;
+        std::map<StringHash, Object*> map;
+    };
+}
+
+/// Previous implementation, ordered map lookup by type hash.
+ALIMER_BENCHMARK(Subsystem_Get_Map)
+{
+    Subsystems subsystems;
+    const StringHash type = Subsystem5::GetTypeStatic();
+    uint32_t sum = 0;
+    while (state.KeepRunning())
+    {
+        for (uint32_t i = 0; i < LookupCount; ++i)
+        {
+            Benchmark::DoNotOptimize(type);
+            auto it = subsystems.map.find(type);
+            sum += static_cast<Subsystem5*>(it->second)->value;
+        }
+    }
+    Benchmark::DoNotOptimize(sum);
+    state.SetItemsPerIteration(LookupCount);
+}
+
+/// Lookup by type hash, slot found under the registry lock.
+ALIMER_BENCHMARK(Subsystem_Get_Hash)
+{
+    Subsystems subsystems;
+    const StringHash type = Subsystem5::GetTypeStatic();
+    uint32_t sum = 0;
+    while (state.KeepRunning())
+    {
+        for (uint32_t i = 0; i < LookupCount; ++i)
+        {
+            sum += static_cast<Subsystem5*>(Object::GetSubsystem(type))->value;
+        }
+    }
+    Benchmark::DoNotOptimize(sum);
+    state.SetItemsPerIteration(LookupCount);
+}
+
+ALIMER_BENCHMARK(Subsystem_Get_Typed)
+{
+    Subsystems subsystems;
+    uint32_t sum = 0;
+    while (state.KeepRunning())
+    {
+        for (uint32_t i = 0; i < LookupCount; ++i)
+        {
+            sum += Object::GetSubsystem<Subsystem5>()->value;
+        }
+    }
+    Benchmark::DoNotOptimize(sum);
+    state.SetItemsPerIteration(LookupCount);
+}
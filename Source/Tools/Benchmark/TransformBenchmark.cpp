@@ -0,0 +1,89 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Benchmark.h"
+#include "Scene/TransformHierarchy.h"
+
+using namespace Alimer;
+
+namespace
+{
+    const uint32_t NodeCount = 100000;
+    const uint32_t RootCount = 64;
+
+    /// Hierarchy with a fan out of four, roughly eight levels deep.
+    TransformHierarchy& GetHierarchy(std::vector<uint32_t>& nodes)
+    {
+        static TransformHierarchy* hierarchy = nullptr;
+        static std::vector<uint32_t> created;
+        if (!hierarchy)
+        {
+            hierarchy = new TransformHierarchy();
+            created.reserve(NodeCount);
+            for (uint32_t i = 0; i < NodeCount; ++i)
+            {
+                const uint32_t node = hierarchy->Add();
+                hierarchy->SetLocalMatrix(node, mat4::translate(vec3(1.0f, 0.0f, 0.0f)));
+                if (i >= RootCount)
+                {
+                    hierarchy->SetParent(node, created[(i - RootCount) / 4]);
+                }
+                created.push_back(node);
+            }
+            hierarchy->Update();
+        }
+
+        nodes = created;
+        return *hierarchy;
+    }
+}
+
+// Every root moves, so every world matrix is recomputed.
+ALIMER_BENCHMARK(Transform_Hierarchy_UpdateAll)
+{
+    std::vector<uint32_t> nodes;
+    TransformHierarchy& hierarchy = GetHierarchy(nodes);
+    float offset = 0.0f;
+    while (state.KeepRunning())
+    {
+        offset += 1.0f;
+        for (uint32_t i = 0; i < RootCount; ++i)
+        {
+            hierarchy.SetLocalMatrix(nodes[i], mat4::translate(vec3(offset, 0.0f, 0.0f)));
+        }
+        hierarchy.Update();
+    }
+    Benchmark::DoNotOptimize(hierarchy.GetWorldMatrix(nodes.back()));
+    state.SetItemsPerIteration(NodeCount);
+}
+
+// Nothing moves, measures the cost of the dirty propagation pass.
+ALIMER_BENCHMARK(Transform_Hierarchy_UpdateStatic)
+{
+    std::vector<uint32_t> nodes;
+    TransformHierarchy& hierarchy = GetHierarchy(nodes);
+    while (state.KeepRunning())
+    {
+        hierarchy.Update();
+    }
+    state.SetItemsPerIteration(NodeCount);
+}
@@ -0,0 +1,100 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Benchmark.h"
+#include "Base/String.h"
+#include "Base/Vector.h"
+
+using namespace Alimer;
+
+namespace
+{
+    const uint32_t VectorCount = 64;
+    const uint32_t ElementCount = 16;
+
+    /// Many small short lived vectors, like per frame gather lists.
+    void RunTemporaryVectors(Benchmark::State& state, Allocator* allocator)
+    {
+        while (state.KeepRunning())
+        {
+            uint32_t sum = 0;
+            for (uint32_t i = 0; i < VectorCount; ++i)
+            {
+                PODVector<uint32_t> indices(allocator);
+                Vector<String> names(allocator);
+                for (uint32_t j = 0; j < ElementCount; ++j)
+                {
+                    indices.Push(i * j);
+                    names.Push(String());
+                }
+                sum += indices.Back() + names.Size();
+            }
+
+            if (allocator)
+            {
+                static_cast<ArenaAllocator*>(allocator)->Reset();
+            }
+            Benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsPerIteration(VectorCount);
+    }
+}
+
+ALIMER_BENCHMARK(Vector_Temporary_Heap)
+{
+    RunTemporaryVectors(state, nullptr);
+}
+
+ALIMER_BENCHMARK(Vector_Temporary_Arena)
+{
+    ArenaAllocator arena;
+    RunTemporaryVectors(state, &arena);
+}
+
+/// Growth relocates the strings with memcpy instead of move and destruct.
+ALIMER_BENCHMARK(Vector_Push_String)
+{
+    while (state.KeepRunning())
+    {
+        Vector<String> strings;
+        for (uint32_t i = 0; i < 1024; ++i)
+        {
+            strings.Push(String("relocated string value"));
+        }
+        Benchmark::DoNotOptimize(strings.Size());
+    }
+    state.SetItemsPerIteration(1024);
+}
+
+ALIMER_BENCHMARK(PODVector_Push)
+{
+    while (state.KeepRunning())
+    {
+        PODVector<uint32_t> values;
+        for (uint32_t i = 0; i < 4096; ++i)
+        {
+            values.Push(i);
+        }
+        Benchmark::DoNotOptimize(values.Size());
+    }
+    state.SetItemsPerIteration(4096);
+}
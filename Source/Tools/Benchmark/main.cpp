@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2018 Amer Koleci and contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Benchmark.h"
+#include "Core/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace Alimer
+{
+    namespace Benchmark
+    {
+        struct Entry
+        {
+            const char* name;
+            Function function;
+        };
+
+        static std::vector<Entry>& GetEntries()
+        {
+            static std::vector<Entry> entries;
+            return entries;
+        }
+
+        Registration::Registration(const char* name, Function function)
+        {
+            GetEntries().push_back({ name, function });
+        }
+
+        static double Run(Function function, uint64_t iterations, uint64_t& items)
+        {
+            State state(iterations);
+            auto start = std::chrono::steady_clock::now();
+            function(state);
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            items = state.GetItemsPerIteration();
+            return std::chrono::duration<double, std::nano>(elapsed).count();
+        }
+    }
+}
+
+using namespace Alimer::Benchmark;
+
+int main(int argc, char** argv)
+{
+    // Optional substring filter on benchmark names.
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    const double minTime = 0.25e9;
+
+    std::printf("%-48s %14s %14s\n", "Benchmark", "Iterations", "ns/op");
+    for (const Entry& entry : GetEntries())
+    {
+        if (filter && !std::strstr(entry.name, filter))
+            continue;
+
+        uint64_t items = 1;
+        uint64_t iterations = 1;
+        double elapsed = Run(entry.function, iterations, items);
+        while (elapsed < minTime && iterations < (1ull << 40))
+        {
+            const uint64_t factor = elapsed > 0.0 ? static_cast<uint64_t>(minTime / elapsed) + 1 : 10;
+            iterations *= std::min<uint64_t>(std::max<uint64_t>(factor, 2), 100);
+            elapsed = Run(entry.function, iterations, items);
+        }
+
+        std::printf("%-48s %14llu %14.3f\n",
+            entry.name,
+            static_cast<unsigned long long>(iterations),
+            elapsed / double(iterations * items));
+    }
+
+    Alimer::JobSystem::Shutdown();
+    return 0;
+}